@@ -0,0 +1,57 @@
+"""Time the interval dot/matmul kernels per input class.
+
+For each class of operands, runs A @ x (and A @ B) with every kernel
+selectable through `set_dot_kernel` and prints the fastest one.  Under
+'auto', products with a point operand take the two-product point kernel
+and everything else takes INTERVAL_DOT_GENERAL in numpy_interval.c;
+rerun this after touching the kernels and update that default if the
+winner for the general classes changes.
+
+    python benchmarks/dot_kernels.py [n] [repeat]
+"""
+
+import sys
+import timeit
+
+import numpy
+
+import interval as npi
+
+_lu_dtype = numpy.dtype([('l','=f8'),('u','=f8')])
+
+def _intervals (l, u) :
+    lu = numpy.empty(numpy.shape(l), dtype=_lu_dtype)
+    lu['l'] = l
+    lu['u'] = u
+    return lu.view(npi.interval)
+
+def _classes (n, rng) :
+    c = rng.standard_normal((n, n))
+    r = rng.random((n, n))
+    v = rng.standard_normal((n, 1))
+    w = rng.random((n, 1))
+    return {
+        'point A, interval x'    : (_intervals(c, c), _intervals(v - w, v + w)),
+        'interval A, point x'    : (_intervals(c - r, c + r), _intervals(v, v)),
+        'interval A, interval x' : (_intervals(c - r, c + r), _intervals(v - w, v + w)),
+        'positive A, positive x' : (_intervals(abs(c), abs(c) + r), _intervals(abs(v), abs(v) + w)),
+        'interval A, interval B' : (_intervals(c - r, c + r), _intervals(c.T - r, c.T + r)),
+    }
+
+def main (n=256, repeat=5) :
+    rng = numpy.random.default_rng(0)
+    previous = npi.get_dot_kernel()
+    try :
+        for name, (A, x) in _classes(n, rng).items() :
+            times = {}
+            for kernel in ('four', 'sign', 'auto') :
+                npi.set_dot_kernel(kernel)
+                times[kernel] = min(timeit.repeat(lambda : A @ x, number=3, repeat=repeat))/3
+            best = min(times, key=times.get)
+            print('%-24s ' % name + '  '.join('%s %8.3f ms' % (k, 1e3*t) for k, t in times.items())
+                  + '   fastest: %s' % best)
+    finally :
+        npi.set_dot_kernel(previous)
+
+if __name__ == '__main__' :
+    main(*map(int, sys.argv[1:]))
@@ -0,0 +1,74 @@
+"""Time the threaded ufunc loops and check them against one thread.
+
+Runs elementwise ufuncs, reductions and accumulations over interval
+arrays at 1 thread and at each given thread count, prints the timings,
+and fails if any result differs from the single-threaded one: elementwise
+loops are split across threads, and reductions and accumulations must
+stay serial and deterministic.
+
+    python benchmarks/threaded_loops.py [n] [threads ...]
+"""
+
+import sys
+import timeit
+
+import numpy
+
+import interval as npi
+
+_lu_dtype = numpy.dtype([('l','=f8'),('u','=f8')])
+
+def _intervals (l, u) :
+    lu = numpy.empty(numpy.shape(l), dtype=_lu_dtype)
+    lu['l'] = l
+    lu['u'] = u
+    return lu.view(npi.interval)
+
+def _cases (n, rng) :
+    c = rng.standard_normal(n)
+    r = rng.random(n)
+    x = _intervals(c - r, c + r)
+    y = _intervals(numpy.ones(n), numpy.full(n, 2.0))
+    return {
+        'add'             : lambda : x + x,
+        'multiply'        : lambda : x * x,
+        'sin'             : lambda : numpy.sin(x),
+        'add.reduce'      : lambda : numpy.add.reduce(y),
+        'add.accumulate'  : lambda : numpy.add.accumulate(y),
+        'multiply.reduce' : lambda : numpy.multiply.reduce(x[:64]),
+        'maximum.reduce'  : lambda : numpy.maximum.reduce(x),
+        'add.reduce 2-d'  : lambda : numpy.add.reduce(y.reshape(-1, 16), axis=0),
+    }
+
+def _same (a, b) :
+    a = numpy.asarray(a).view(_lu_dtype)
+    b = numpy.asarray(b).view(_lu_dtype)
+    return numpy.array_equal(a['l'], b['l'], equal_nan=True) and \
+           numpy.array_equal(a['u'], b['u'], equal_nan=True)
+
+def main (n=1 << 20, threads=(2, 8)) :
+    rng = numpy.random.default_rng(0)
+    failed = False
+    previous = npi.set_num_threads(1)
+    try :
+        for name, f in _cases(n, rng).items() :
+            npi.set_num_threads(1)
+            ref = f()
+            times = ['1: %.4f' % min(timeit.repeat(f, number=1, repeat=3))]
+            for t in threads :
+                npi.set_num_threads(t)
+                for _ in range(5) :
+                    if not _same(f(), ref) :
+                        print("MISMATCH %s at %d threads" % (name, t))
+                        failed = True
+                        break
+                times.append('%d: %.4f' % (t, min(timeit.repeat(f, number=1, repeat=3))))
+            print('%-16s %s' % (name, '  '.join(times)))
+    finally :
+        npi.set_num_threads(previous)
+    return not failed
+
+if __name__ == '__main__' :
+    n = int(sys.argv[1]) if len(sys.argv) > 1 else 1 << 20
+    threads = tuple(int(t) for t in sys.argv[2:]) or (2, 8)
+    sys.exit(0 if main(n, threads) else 1)
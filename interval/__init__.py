@@ -3,6 +3,8 @@ __all__ = [
     'interval', 'zero', 'one'
 ]
 
+import io
+import pickle
 import numpy
 from npinterval.interval.numpy_interval import *
 
@@ -11,6 +13,11 @@ if numpy.__dict__.get('interval') is not None:
 
 numpy.interval = interval
 numpy.sctypeDict['interval'] = numpy.dtype(interval)
+numpy.midrad = midrad
+numpy.sctypeDict['midrad'] = numpy.dtype(midrad)
+
+# einsum and tensordot for interval operands; see tensor.py.
+from .tensor import einsum, tensordot
 
 # numba.typeDict = numba.from_dtype(numpy.interval)
 
@@ -36,6 +43,11 @@ def get_iarray (l, u) :
 
 is_iarray = lambda x : x.dtype == numpy.interval
 
+def get_include () :
+    """Directory containing interval.h, interval.hpp, numpy_interval_api.h, and cinterval.pxd."""
+    import os
+    return os.path.dirname(os.path.abspath(__file__))
+
 def from_cent_pert (cent, pert) :
     cent = numpy.asarray(cent)
     pert = numpy.asarray(pert)
@@ -51,6 +63,29 @@ def get_cent_pert (iarray) :
     l, u = get_lu(iarray)
     return (l + u)/2, (u - l)/2
 
+# Midpoint-radius arrays.  A midrad array is two native doubles (m, r)
+# per element; these build one from, and view one as, float arrays.
+_native_mr = numpy.dtype([('m','=f8'),('r','=f8')])
+
+def from_mid_rad (mid, rad=0) :
+    """The midrad array with the given midpoints and (nonnegative) radii."""
+    mid, rad = numpy.broadcast_arrays(numpy.asarray(mid, dtype=numpy.float64),
+                                      numpy.asarray(rad, dtype=numpy.float64))
+    if numpy.any(rad < 0) :
+        raise ValueError("radii must be nonnegative")
+    mr = numpy.empty(mid.shape, dtype=_native_mr)
+    mr['m'] = mid
+    mr['r'] = rad
+    return mr.view(midrad)
+
+def get_mid_rad (marray) :
+    """Midpoints and radii of a midrad array, as float views where possible."""
+    marray = numpy.asarray(marray)
+    if marray.dtype != midrad :
+        raise TypeError("expected a midrad array, got dtype %s" % marray.dtype)
+    mr = marray.view(_native_mr) if marray.flags.c_contiguous else numpy.ascontiguousarray(marray).view(_native_mr)
+    return mr['m'], mr['r']
+
 def width (iarray, scale=None) :
     width = numpy.norm(iarray)
     return width if scale is None else width / scale
@@ -68,6 +103,16 @@ def get_half_intervals (iarray) :
         ret.append(get_iarray(part[:n], part[n:]))
     return ret
 
+# np.sort / np.argsort order intervals lexicographically by (l, u).  These
+# sort along the last axis by midpoint or width instead (stable).
+def sort_midpoint (iarray) :
+    iarray = numpy.asarray(iarray)
+    return numpy.take_along_axis(iarray, argsort_midpoint(iarray), axis=-1)
+
+def sort_width (iarray) :
+    iarray = numpy.asarray(iarray)
+    return numpy.take_along_axis(iarray, argsort_width(iarray), axis=-1)
+
 # import shapely.geometry
 # sg_box = lambda x, xi=0, yi=1 : shapely.geometry.box(x[xi].l,x[yi].l,x[xi].u,x[yi].u)
 
@@ -76,5 +121,97 @@ def has_nan (iarray) :
     l,u = get_lu(iarray)
     return numpy.any(numpy.isnan(l)) or numpy.any(numpy.isnan(u))
 
+# Persistence.  On disk (and in pickle buffers) an interval array is the
+# structured layout INTERVAL_DESCR, i.e. two little-endian doubles named l
+# and u per element, which any numpy can read without this package.
+INTERVAL_DESCR = numpy.dtype([('l','<f8'),('u','<f8')])
+_native_lu = numpy.dtype([('l','=f8'),('u','=f8')])
+
+def as_structured (iarray) :
+    """Zero-copy view of an interval array as native (l, u) records."""
+    iarray = numpy.asarray(iarray)
+    if not is_iarray(iarray) :
+        raise TypeError("expected an interval array, got dtype %s" % iarray.dtype)
+    return iarray.view(_native_lu)
+
+def from_structured (sarray) :
+    """View an array with the INTERVAL_DESCR layout as an interval array.
+
+    The view is zero-copy when the records are in native byte order (so
+    memmaps stay memmaps); otherwise the data is converted first.
+    """
+    sarray = numpy.asarray(sarray) if not isinstance(sarray, numpy.ndarray) else sarray
+    if sarray.dtype.names != ('l','u') or sarray.dtype.itemsize != 16 \
+        or any(sarray.dtype[k].kind != 'f' or sarray.dtype[k].itemsize != 8 for k in 'lu') :
+        raise ValueError("expected the record layout %s, got %s" % (INTERVAL_DESCR, sarray.dtype))
+    if sarray.dtype != _native_lu :
+        sarray = sarray.astype(_native_lu)
+    return sarray.view(numpy.interval)
+
+def save (file, iarray) :
+    """Save an interval array to a .npy file with the INTERVAL_DESCR layout."""
+    numpy.save(file, as_structured(iarray).astype(INTERVAL_DESCR, copy=False), allow_pickle=False)
+
+def load (file, mmap_mode=None) :
+    """Load an interval array written by `save`.
+
+    With mmap_mode ('r', 'r+', 'c') the result is an interval view over
+    the memory-mapped file.
+    """
+    return from_structured(numpy.load(file, mmap_mode=mmap_mode, allow_pickle=False))
+
+def open_memmap (filename, mode='r+', shape=None, fortran_order=False) :
+    """Create or open a .npy file as a memory-mapped interval array."""
+    return from_structured(numpy.lib.format.open_memmap(filename, mode=mode,
+        dtype=INTERVAL_DESCR if mode == 'w+' else None, shape=shape, fortran_order=fortran_order))
+
+def memmap (filename, mode='r+', offset=0, shape=None, order='C') :
+    """Memory-map a raw (headerless) file of INTERVAL_DESCR records."""
+    return from_structured(numpy.memmap(filename, dtype=INTERVAL_DESCR, mode=mode,
+                                        offset=offset, shape=shape, order=order))
+
+def _frombuffer (buf, shape, order) :
+    return from_structured(numpy.frombuffer(buf, dtype=INTERVAL_DESCR)).reshape(shape, order=order)
+
+class Pickler (pickle.Pickler) :
+    """Pickler that sends contiguous interval arrays as protocol-5 buffers.
+
+    numpy cannot export a buffer for the interval dtype, so ndarray's own
+    reduction falls back to copying the data into the pickle stream.
+    With protocol >= 5 this pickler instead hands the (l, u) records to
+    `buffer_callback` out-of-band, like numpy does for float arrays.
+    """
+    def __init__ (self, file, protocol=5, **kwargs) :
+        super().__init__(file, protocol, **kwargs)
+        self._protocol = protocol if protocol is not None and protocol >= 0 else pickle.HIGHEST_PROTOCOL
+
+    def reducer_override (self, obj) :
+        if type(obj) is not numpy.ndarray or self._protocol < 5 \
+            or obj.dtype != numpy.interval or _native_lu != INTERVAL_DESCR :
+            return NotImplemented
+        if obj.flags.c_contiguous :
+            order, data = 'C', obj
+        elif obj.flags.f_contiguous :
+            order, data = 'F', obj.T
+        else :
+            return NotImplemented
+        return _frombuffer, (pickle.PickleBuffer(data.view(INTERVAL_DESCR)), obj.shape, order)
+
+def dumps (obj, protocol=5, *, buffer_callback=None) :
+    """pickle.dumps using `Pickler`; load the result with pickle.loads."""
+    f = io.BytesIO()
+    Pickler(f, protocol, buffer_callback=buffer_callback).dump(obj)
+    return f.getvalue()
+
 zero = numpy.interval(0,0)
 one = numpy.interval(1,1)
+
+from .stream import stream
+from .sparse import csr_matrix, csc_matrix
+from . import linalg
+from . import roots
+from . import optimize
+from . import contract
+from . import nn
+from .spatial import BoxTree
+from .paving import Paving
@@ -0,0 +1,141 @@
+# Cython declarations for the npinterval C kernels and C API.
+#
+#     from interval.cinterval cimport interval, interval_add, import_npinterval
+#
+# Build with include_dirs=[interval.get_include(), numpy.get_include()].
+# The interval_* kernels are inline C and need neither the GIL nor the
+# extension; call import_npinterval() before using NpInterval_API.
+
+from cpython.object cimport PyObject, PyTypeObject
+
+cdef extern from "interval.h" nogil:
+    ctypedef struct interval:
+        double l
+        double u
+
+    interval interval_add(interval i1, interval i2)
+    interval interval_add_scalar(interval i, double s)
+    interval interval_scalar_add(double s, interval i)
+    interval interval_subtract(interval i1, interval i2)
+    interval interval_subtract_scalar(interval i, double s)
+    interval interval_scalar_subtract(double s, interval i)
+    interval interval_multiply(interval i1, interval i2)
+    interval interval_multiply_scalar(interval i, double s)
+    interval interval_scalar_multiply(double s, interval i)
+    interval interval_inverse(interval i)
+    interval interval_divide(interval i1, interval i2)
+    interval interval_divide_scalar(interval i, double s)
+    interval interval_scalar_divide(double s, interval i)
+    interval interval_fma(interval a, interval b, interval c)
+    interval interval_fma_scalar(interval a, interval b, double s)
+    interval interval_scalar_fma(double s, interval b, interval c)
+    interval interval_square(interval i)
+    interval interval_power_int(interval i, long p)
+    interval interval_power_scalar(interval i, double s)
+    interval interval_negative(interval i)
+    interval interval_sin(interval i)
+    interval interval_cos(interval i)
+    interval interval_tan(interval i)
+    interval interval_arctan(interval i)
+    interval interval_tanh(interval i)
+    interval interval_relu(interval i)
+    interval interval_sigmoid(interval i)
+    interval interval_exp(interval i)
+    interval interval_sqrt(interval i)
+    double interval_norm(interval i)
+    interval interval_union(interval i1, interval i2)
+    interval interval_intersection(interval i1, interval i2)
+    interval interval_minimum(interval i1, interval i2)
+    interval interval_maximum(interval i1, interval i2)
+    int interval_nonzero(interval i)
+    int interval_equal(interval i1, interval i2)
+    int interval_not_equal(interval i1, interval i2)
+    int interval_subseteq(interval i1, interval i2)
+    int interval_supseteq(interval i1, interval i2)
+    int interval_subset(interval i1, interval i2)
+    int interval_supset(interval i1, interval i2)
+    int interval_certainly_lt(interval i1, interval i2)
+    int interval_certainly_le(interval i1, interval i2)
+    int interval_certainly_gt(interval i1, interval i2)
+    int interval_certainly_ge(interval i1, interval i2)
+    int interval_possibly_lt(interval i1, interval i2)
+    int interval_possibly_le(interval i1, interval i2)
+    int interval_possibly_gt(interval i1, interval i2)
+    int interval_possibly_ge(interval i1, interval i2)
+    int interval_compare_lt(interval i1, interval i2)
+    int interval_compare_le(interval i1, interval i2)
+    int interval_compare_gt(interval i1, interval i2)
+    int interval_compare_ge(interval i1, interval i2)
+    int interval_contains(interval i, double x)
+    int interval_overlaps(interval i1, interval i2)
+
+cdef extern from "numpy_interval_api.h":
+    int NPINTERVAL_CAPI_VERSION
+
+    ctypedef struct PyInterval:
+        interval obval
+
+    ctypedef struct NpInterval_CAPI:
+        int version
+        int interval_type_num
+        PyTypeObject *PyInterval_Type
+        object (*PyInterval_FromInterval)(interval)
+        interval (*add)(interval, interval) nogil
+        interval (*add_scalar)(interval, double) nogil
+        interval (*scalar_add)(double, interval) nogil
+        interval (*subtract)(interval, interval) nogil
+        interval (*subtract_scalar)(interval, double) nogil
+        interval (*scalar_subtract)(double, interval) nogil
+        interval (*multiply)(interval, interval) nogil
+        interval (*multiply_scalar)(interval, double) nogil
+        interval (*scalar_multiply)(double, interval) nogil
+        interval (*inverse)(interval) nogil
+        interval (*divide)(interval, interval) nogil
+        interval (*divide_scalar)(interval, double) nogil
+        interval (*scalar_divide)(double, interval) nogil
+        interval (*square)(interval) nogil
+        interval (*power_scalar)(interval, double) nogil
+        interval (*negative)(interval) nogil
+        interval (*sin)(interval) nogil
+        interval (*cos)(interval) nogil
+        interval (*tan)(interval) nogil
+        interval (*arctan)(interval) nogil
+        interval (*tanh)(interval) nogil
+        interval (*exp)(interval) nogil
+        interval (*sqrt)(interval) nogil
+        double (*norm)(interval) nogil
+        interval (*union_)(interval, interval) nogil
+        interval (*intersection)(interval, interval) nogil
+        interval (*minimum)(interval, interval) nogil
+        interval (*maximum)(interval, interval) nogil
+        int (*nonzero)(interval) nogil
+        int (*equal)(interval, interval) nogil
+        int (*not_equal)(interval, interval) nogil
+        int (*subseteq)(interval, interval) nogil
+        int (*supseteq)(interval, interval) nogil
+        int (*subset)(interval, interval) nogil
+        int (*supset)(interval, interval) nogil
+        interval (*power_int)(interval, long) nogil
+        interval (*fma)(interval, interval, interval) nogil
+        interval (*fma_scalar)(interval, interval, double) nogil
+        interval (*scalar_fma)(double, interval, interval) nogil
+        int (*certainly_lt)(interval, interval) nogil
+        int (*certainly_le)(interval, interval) nogil
+        int (*certainly_gt)(interval, interval) nogil
+        int (*certainly_ge)(interval, interval) nogil
+        int (*possibly_lt)(interval, interval) nogil
+        int (*possibly_le)(interval, interval) nogil
+        int (*possibly_gt)(interval, interval) nogil
+        int (*possibly_ge)(interval, interval) nogil
+        int (*compare_lt)(interval, interval) nogil
+        int (*compare_le)(interval, interval) nogil
+        int (*compare_gt)(interval, interval) nogil
+        int (*compare_ge)(interval, interval) nogil
+        int (*contains)(interval, double) nogil
+        int (*overlaps)(interval, interval) nogil
+        interval (*relu)(interval) nogil
+        interval (*sigmoid)(interval) nogil
+
+    NpInterval_CAPI *NpInterval_API
+    int import_npinterval() except -1
+    bint PyInterval_Check(object o)
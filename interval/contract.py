@@ -0,0 +1,211 @@
+"""Contraction of boxes under constraints g(x) in [a, b].
+
+Constraints are written with symbolic variables and the operations
+below, which build an expression DAG instead of computing anything:
+
+    x, y = variables(2)
+    C = Contractor([(sqr(x) + sqr(y), (1, 4)),
+                    (y - sin(x), 0)])
+    boxes, verdict = C.contract(X)
+
+Supported are +, -, *, / (with numbers and interval scalars as
+constants), unary -, integer powers, and sqr, sqrt, exp, sin and cos.
+Identical subexpressions are merged, so constraints that share terms
+share their nodes.  `Contractor.contract` runs the native HC4-revise
+engine (interval_contract.h) over a whole (m, n) array of boxes at once,
+splitting the batch across threads: forward-backward sweeps over the DAG
+cut away parts of each box that violate a constraint, which saves
+several levels of bisection per sweep in set inversion and
+branch-and-prune.
+"""
+
+import numpy
+
+from npinterval.interval.numpy_interval import interval, hc4_contract
+
+__all__ = ['variables', 'sqr', 'sqrt', 'exp', 'sin', 'cos', 'Contractor',
+           'EMPTY', 'INNER', 'BOUNDARY']
+
+# Values of the verdict array returned by Contractor.contract.
+EMPTY = 0       # no point of the box satisfies the constraints
+INNER = 1       # every point of the box satisfies them
+BOUNDARY = 2    # the box was contracted, but may hold points of both kinds
+
+# Node codes of interval_contract.h.
+_CONST, _VAR, _ADD, _SUB, _MUL, _DIV, _NEG, _SQR, _SQRT, _EXP, _SIN, _COS = range(12)
+
+
+def _interval (value) :
+    if isinstance(value, interval) :
+        return (value.l, value.u)
+    if isinstance(value, tuple) and len(value) == 2 :
+        return (float(value[0]), float(value[1]))
+    value = float(value)
+    return (value, value)
+
+
+class Expr :
+    """A node of an expression over variables; see `variables`."""
+    __slots__ = ('op', 'args', 'value')
+    # Make numpy scalars on the left of an operator defer to Expr.
+    __array_ufunc__ = None
+
+    def __init__ (self, op, args=(), value=(0., 0.)) :
+        self.op = op
+        self.args = args
+        self.value = value
+
+    def __add__ (self, other) :
+        return Expr(_ADD, (self, _expr(other)))
+    def __radd__ (self, other) :
+        return Expr(_ADD, (_expr(other), self))
+    def __sub__ (self, other) :
+        return Expr(_SUB, (self, _expr(other)))
+    def __rsub__ (self, other) :
+        return Expr(_SUB, (_expr(other), self))
+    def __mul__ (self, other) :
+        return Expr(_MUL, (self, _expr(other)))
+    def __rmul__ (self, other) :
+        return Expr(_MUL, (_expr(other), self))
+    def __truediv__ (self, other) :
+        return Expr(_DIV, (self, _expr(other)))
+    def __rtruediv__ (self, other) :
+        return Expr(_DIV, (_expr(other), self))
+    def __neg__ (self) :
+        return Expr(_NEG, (self,))
+    def __pos__ (self) :
+        return self
+
+    def __pow__ (self, p) :
+        if p != int(p) or p < 1 :
+            raise ValueError("only positive integer powers are supported, got %r" % (p,))
+        p = int(p)
+        # Squaring and multiplying by the bits of p.
+        result, base = None, self
+        while p :
+            if p & 1 :
+                result = base if result is None else result*base
+            p >>= 1
+            if p :
+                base = sqr(base)
+        return result
+
+    def __repr__ (self) :
+        names = {_ADD : '+', _SUB : '-', _MUL : '*', _DIV : '/'}
+        if self.op == _CONST :
+            l, u = self.value
+            return repr(l) if l == u else 'interval(%r, %r)' % (l, u)
+        if self.op == _VAR :
+            return 'x%d' % self.value[0]
+        if self.op in names :
+            return '(%r %s %r)' % (self.args[0], names[self.op], self.args[1])
+        if self.op == _NEG :
+            return '-%r' % (self.args[0],)
+        return '%s(%r)' % ({_SQR : 'sqr', _SQRT : 'sqrt', _EXP : 'exp', _SIN : 'sin',
+                            _COS : 'cos'}[self.op], self.args[0])
+
+
+def _expr (value) :
+    if isinstance(value, Expr) :
+        return value
+    return Expr(_CONST, value=_interval(value))
+
+def variables (n) :
+    """The symbolic variables x[0], ..., x[n-1] of an n-dimensional box."""
+    return tuple(Expr(_VAR, value=(k, k)) for k in range(n))
+
+def sqr (e) :
+    return Expr(_SQR, (_expr(e),))
+
+def sqrt (e) :
+    return Expr(_SQRT, (_expr(e),))
+
+def exp (e) :
+    return Expr(_EXP, (_expr(e),))
+
+def sin (e) :
+    return Expr(_SIN, (_expr(e),))
+
+def cos (e) :
+    return Expr(_COS, (_expr(e),))
+
+
+class Contractor :
+    """HC4 contractor for a list of constraints (g, bounds).
+
+    g is an expression built from `variables`; bounds is a number (for
+    g(x) = bounds), a pair (a, b), or an interval scalar.  Use -inf or inf
+    for one-sided constraints.  n is the dimension of the boxes, by
+    default one more than the largest variable used.
+    """
+
+    def __init__ (self, constraints, n=None) :
+        constraints = list(constraints)
+        if not constraints :
+            raise ValueError("expected at least one constraint")
+        exprs = [_expr(g) for g, _ in constraints]
+        nodes, memo, index = [], {}, {}
+        for g in exprs :
+            # Iterative post-order walk; memo maps visited Exprs to nodes
+            # and index merges structurally identical nodes.
+            stack = [(g, False)]
+            while stack :
+                e, ready = stack.pop()
+                if id(e) in memo :
+                    continue
+                if not ready :
+                    stack.append((e, True))
+                    stack.extend((c, False) for c in e.args if id(c) not in memo)
+                    continue
+                key = (e.op, tuple(memo[id(c)] for c in e.args), e.value)
+                if key not in index :
+                    index[key] = len(nodes)
+                    nodes.append(key)
+                memo[id(e)] = index[key]
+        nvars = 1 + max((int(v[0]) for op, _, v in nodes if op == _VAR), default=-1)
+        self.n = nvars if n is None else int(n)
+        if self.n < nvars :
+            raise ValueError("constraints use %d variables, more than n = %d" % (nvars, self.n))
+
+        self._ops = numpy.array([op for op, _, _ in nodes], dtype=numpy.int32)
+        self._args = numpy.zeros((len(nodes), 2), dtype=numpy.int32)
+        consts = numpy.zeros(len(nodes), dtype=numpy.dtype([('l','=f8'),('u','=f8')]))
+        for k, (op, args, value) in enumerate(nodes) :
+            if op == _VAR :
+                self._args[k] = int(value[0])
+            else :
+                self._args[k, :len(args)] = args
+                if op == _CONST :
+                    consts[k] = value
+        self._consts = consts.view(interval)
+        self._roots = numpy.array([memo[id(g)] for g in exprs], dtype=numpy.int32)
+        bounds = numpy.array([_interval(b) for _, b in constraints], dtype=numpy.float64)
+        if numpy.any(bounds[:,0] > bounds[:,1]) :
+            raise ValueError("constraint bounds must have a <= b")
+        self._bounds = numpy.ascontiguousarray(bounds).view(consts.dtype).reshape(-1).view(interval)
+
+    def __len__ (self) :
+        return len(self._roots)
+
+    def contract (self, boxes, maxiter=16, ratio=0.01) :
+        """Contract an (m, n) (or (n,)) interval array of boxes.
+
+        Sweeps are repeated on each box until one shrinks no side by more
+        than ratio of its width, or maxiter sweeps were done.
+
+        Returns
+        -------
+        boxes : ndarray of interval, same shape as the input
+            The contracted boxes (meaningless where verdict is EMPTY).
+        verdict : ndarray of int8, shape (m,) (or ())
+            EMPTY, INNER or BOUNDARY per box.
+        """
+        boxes = numpy.asarray(boxes)
+        if boxes.dtype != interval :
+            raise TypeError("expected an interval array, got dtype %s" % boxes.dtype)
+        shape = boxes.shape
+        if shape[-1:] != (self.n,) :
+            raise ValueError("expected boxes of dimension %d, got shape %r" % (self.n, shape))
+        out, verdict = hc4_contract(self._ops, self._args, self._consts, self._roots, self._bounds,
+                                    boxes.reshape(-1, self.n), int(maxiter), float(ratio))
+        return out.reshape(shape), verdict.reshape(shape[:-1])
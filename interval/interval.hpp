@@ -0,0 +1,731 @@
+#ifndef __INTERVAL_HPP__
+#define __INTERVAL_HPP__
+
+/**
+ * Header-only C++17 interval arithmetic, npinterval::interval<T>.
+ *
+ * The kernels follow interval.h operation for operation, so for T = double
+ * the results are bit-identical to the C kernels used by the numpy
+ * extension, and interval<double> has the same layout as the C `interval`
+ * struct.  On top of that this header provides
+ *
+ *   - operator overloads for interval/interval and interval/scalar,
+ *   - constexpr versions of the algebraic kernels (add, multiply, divide,
+ *     square, integer powers, set operations, predicates),
+ *   - batch functions over spans (std::span with C++20, otherwise the
+ *     small npinterval::span below), and
+ *   - expression templates over interval arrays, so that assigning
+ *     `out = a*b + c*d` runs a single fused loop with no temporaries.
+*/
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#define NPINTERVAL_HAS_STD_SPAN 1
+#endif
+#endif
+
+namespace npinterval {
+
+template <class T>
+struct interval {
+    T l;
+    T u;
+
+    constexpr interval() : l(0), u(0) {}
+    constexpr interval(T x) : l(x), u(x) {}
+    constexpr interval(T l_, T u_) : l(l_), u(u_) {}
+};
+
+namespace detail {
+
+// fmin/fmax with the C semantics (a NaN argument is ignored), usable in
+// constant expressions.
+template <class T>
+constexpr T fmin(T a, T b) {
+    return (a != a) ? b : (b != b) ? a : (b < a ? b : a);
+}
+template <class T>
+constexpr T fmax(T a, T b) {
+    return (a != a) ? b : (b != b) ? a : (a < b ? b : a);
+}
+template <class T>
+constexpr T inf() { return std::numeric_limits<T>::infinity(); }
+template <class T>
+constexpr T nan() { return std::numeric_limits<T>::quiet_NaN(); }
+template <class T>
+constexpr T pi() { return T(3.14159265358979323846L); }
+
+} // namespace detail
+
+/**
+ * ADD / SUBTRACT
+*/
+template <class T>
+constexpr interval<T> add(interval<T> i1, interval<T> i2) {
+    return { i1.l + i2.l, i1.u + i2.u };
+}
+template <class T>
+constexpr interval<T> add(interval<T> i, T s) {
+    return { i.l + s, i.u + s };
+}
+template <class T>
+constexpr interval<T> add(T s, interval<T> i) {
+    return { i.l + s, i.u + s };
+}
+template <class T>
+constexpr interval<T> subtract(interval<T> i1, interval<T> i2) {
+    return { i1.l - i2.u, i1.u - i2.l };
+}
+template <class T>
+constexpr interval<T> subtract(interval<T> i, T s) {
+    return { i.l - s, i.u - s };
+}
+template <class T>
+constexpr interval<T> subtract(T s, interval<T> i) {
+    return { s - i.u, s - i.l };
+}
+
+/**
+ * MULTIPLY / DIVIDE
+*/
+template <class T>
+constexpr interval<T> multiply(interval<T> i1, interval<T> i2) {
+    T _1 = i1.l*i2.l;
+    T _2 = i1.l*i2.u;
+    T _3 = i1.u*i2.l;
+    T _4 = i1.u*i2.u;
+    return {
+        detail::fmin(detail::fmin(_1, _2), detail::fmin(_3, _4)),
+        detail::fmax(detail::fmax(_1, _2), detail::fmax(_3, _4))
+    };
+}
+template <class T>
+constexpr interval<T> multiply(interval<T> i, T s) {
+    if (s >= 0) { return { i.l*s, i.u*s }; }
+    else        { return { i.u*s, i.l*s }; }
+}
+template <class T>
+constexpr interval<T> multiply(T s, interval<T> i) {
+    return multiply(i, s);
+}
+// a*b + c as interval_fma and friends in interval.h: endpoint products
+// picked by sign, each fused with its endpoint of c where the hardware
+// has an fma.
+namespace detail {
+template <class T>
+inline T fma(T a, T b, T c) {
+#ifdef FP_FAST_FMA
+    return std::fma(a, b, c);
+#else
+    return a*b + c;
+#endif
+}
+}
+template <class T>
+inline interval<T> fma(interval<T> a, interval<T> b, interval<T> c) {
+    const bool pl = a.l >= 0, pu = a.u >= 0;
+    return {
+        detail::fmin(detail::fma(a.l, pl ? b.l : b.u, c.l), detail::fma(a.u, pu ? b.l : b.u, c.l)),
+        detail::fmax(detail::fma(a.l, pl ? b.u : b.l, c.u), detail::fma(a.u, pu ? b.u : b.l, c.u))
+    };
+}
+template <class T>
+inline interval<T> fma(interval<T> a, interval<T> b, T s) {
+    return fma(a, b, interval<T>{ s, s });
+}
+template <class T>
+inline interval<T> fma(T s, interval<T> b, interval<T> c) {
+    if (s >= 0) { return { detail::fma(s, b.l, c.l), detail::fma(s, b.u, c.u) }; }
+    else        { return { detail::fma(s, b.u, c.l), detail::fma(s, b.l, c.u) }; }
+}
+template <class T>
+inline interval<T> fma(interval<T> a, T s, interval<T> c) {
+    return fma(s, a, c);
+}
+template <class T>
+constexpr interval<T> inverse(interval<T> i) {
+    if ((i.l > 0 && i.u > 0) || (i.l < 0 && i.u < 0)) {
+        return { 1/i.u, 1/i.l };
+    }
+    return { -detail::inf<T>(), detail::inf<T>() };
+}
+template <class T>
+constexpr interval<T> divide(interval<T> i1, interval<T> i2) {
+    return multiply(i1, inverse(i2));
+}
+template <class T>
+constexpr interval<T> divide(interval<T> i, T s) {
+    return multiply(i, (1/s));
+}
+template <class T>
+constexpr interval<T> divide(T s, interval<T> i) {
+    return multiply(s, inverse(i));
+}
+
+/**
+ * POWER
+*/
+template <class T>
+constexpr interval<T> square(interval<T> i) {
+    T lp = i.l*i.l;
+    T up = i.u*i.u;
+    interval<T> ret;
+    if (i.l <= 0 && i.u >= 0) {
+        ret.l = 0;
+    } else {
+        ret.l = detail::fmin(lp, up);
+    }
+    ret.u = detail::fmax(lp, up);
+    return ret;
+}
+namespace detail {
+template <class T>
+constexpr T ipow(T x, unsigned long p) {
+    T r = 1;
+    while (p) {
+        if (p & 1) { r *= x; }
+        p >>= 1;
+        if (p) { x *= x; }
+    }
+    return r;
+}
+template <class T>
+constexpr interval<T> power_even(interval<T> i, unsigned long p) {
+    T lp = ipow(i.l, p);
+    T up = ipow(i.u, p);
+    interval<T> ret;
+    if (i.l <= 0 && i.u >= 0) {
+        ret.l = 0;
+    } else {
+        ret.l = fmin(lp, up);
+    }
+    ret.u = fmax(lp, up);
+    return ret;
+}
+constexpr long power_int_max = 1048576;  // INTERVAL_POWER_INT_MAX
+}
+template <class T, class I, std::enable_if_t<std::is_integral_v<I>, int> = 0>
+constexpr interval<T> power(interval<T> i, I p) {
+    long q = static_cast<long>(p);
+    if (q == std::numeric_limits<long>::min()) {
+        // -q overflows; q is even, so square half of it.
+        return square(power(i, q/2));
+    }
+    if (q < 0) {
+        return inverse(power(i, -q));
+    }
+    if (q == 0) {
+        return { 1, 1 };
+    }
+    if (q & 1) {
+        return { detail::ipow(i.l, q), detail::ipow(i.u, q) };
+    }
+    return detail::power_even(i, q);
+}
+template <class T>
+inline interval<T> power(interval<T> i, T s) {
+    using std::pow;
+    if (std::fabs(s) < detail::power_int_max && s == T(static_cast<long>(s))) {
+        return power(i, static_cast<long>(s));
+    }
+    if (s < 0) {
+        return inverse(power(i, -s));
+    }
+    if (i.l > 0 && i.u > 0) {
+        return { pow(i.l, s), pow(i.u, s) };
+    }
+    int p = static_cast<int>(std::round(s));
+    if (p % 2) {
+        return { pow(i.l, T(p)), pow(i.u, T(p)) };
+    }
+    T lp = pow(i.l, T(p));
+    T up = pow(i.u, T(p));
+    interval<T> ret;
+    if (i.l <= 0 && i.u >= 0) {
+        ret.l = 0;
+    } else {
+        ret.l = detail::fmin(lp, up);
+    }
+    ret.u = detail::fmax(lp, up);
+    return ret;
+}
+
+/**
+ * UNARY
+*/
+template <class T>
+constexpr bool nonzero(interval<T> i) {
+    return !(i.l == 0 && i.u == 0);
+}
+template <class T>
+constexpr interval<T> negative(interval<T> i) {
+    return { -i.u, -i.l };
+}
+template <class T>
+constexpr T norm(interval<T> i) {
+    return i.u - i.l;
+}
+template <class T>
+inline interval<T> sin(interval<T> i) {
+    using std::cos; using std::sin;
+    const T pi = detail::pi<T>();
+    T diff = i.u - i.l;
+    if (diff <= pi) {
+        T cl = cos(i.l);
+        T cu = cos(i.u);
+        if (cl >= 0 && cu >= 0) {
+            return { sin(i.l), sin(i.u) };
+        } else if (cl <= 0 && cu <= 0) {
+            return { sin(i.u), sin(i.l) };
+        } else if (cl >= 0 && cu <= 0) {
+            return { std::fmin(sin(i.l), sin(i.u)), T(1) };
+        } else if (cl <= 0 && cu >= 0) {
+            return { T(-1), std::fmax(sin(i.l), sin(i.u)) };
+        }
+    }
+    if (diff <= 2*pi) {
+        T cl = cos(i.l);
+        T cu = cos(i.u);
+        if (cl >= 0 && cu >= 0) {
+            return { T(-1), T(1) };
+        } else if (cl <= 0 && cu <= 0) {
+            return { T(-1), T(1) };
+        } else if (cl >= 0 && cu <= 0) {
+            return { std::fmin(sin(i.l), sin(i.u)), T(1) };
+        } else if (cl <= 0 && cu >= 0) {
+            return { T(-1), std::fmax(sin(i.l), sin(i.u)) };
+        }
+    }
+    return { T(-1), T(1) };
+}
+template <class T>
+inline interval<T> cos(interval<T> i) {
+    const T pi = detail::pi<T>();
+    return sin(interval<T>{ i.l+pi/2, i.u+pi/2 });
+}
+template <class T>
+inline interval<T> tan(interval<T> i) {
+    const T pi = detail::pi<T>();
+    const T pi_2 = T(1.57079632679489661923L);
+    int div = static_cast<int>((i.u + pi_2) / (pi));
+    i.l -= div*pi; i.u -= div*pi;
+    if (i.l < -pi_2) {
+        return { -detail::inf<T>(), detail::inf<T>() };
+    }
+    return { std::tan(i.l), std::tan(i.u) };
+}
+template <class T>
+inline interval<T> arctan(interval<T> i) {
+    return { std::atan(i.l), std::atan(i.u) };
+}
+template <class T>
+inline interval<T> tanh(interval<T> i) {
+    return { std::tanh(i.l), std::tanh(i.u) };
+}
+template <class T>
+inline interval<T> relu(interval<T> i) {
+    return { std::fmax(i.l, T(0)), std::fmax(i.u, T(0)) };
+}
+template <class T>
+inline interval<T> sigmoid(interval<T> i) {
+    return { 1/(1 + std::exp(-i.l)), 1/(1 + std::exp(-i.u)) };
+}
+template <class T>
+inline interval<T> exp(interval<T> i) {
+    return { std::exp(i.l), std::exp(i.u) };
+}
+template <class T>
+inline interval<T> sqrt(interval<T> i) {
+    if (i.l < 0) {
+        return { -detail::inf<T>(), detail::inf<T>() };
+    }
+    return { std::sqrt(i.l), std::sqrt(i.u) };
+}
+
+/**
+ * SET OPERATIONS
+*/
+template <class T>
+constexpr interval<T> hull(interval<T> i1, interval<T> i2) {
+    return { detail::fmin(i1.l, i2.l), detail::fmax(i1.u, i2.u) };
+}
+template <class T>
+constexpr interval<T> intersection(interval<T> i1, interval<T> i2) {
+    T rl = detail::fmax(i1.l, i2.l);
+    T ru = detail::fmin(i1.u, i2.u);
+    if (rl > ru) {
+        return { detail::nan<T>(), detail::nan<T>() };
+    }
+    return { rl, ru };
+}
+template <class T>
+constexpr interval<T> minimum(interval<T> i1, interval<T> i2) {
+    return { detail::fmin(i1.l, i2.l), detail::fmin(i1.u, i2.u) };
+}
+template <class T>
+constexpr interval<T> maximum(interval<T> i1, interval<T> i2) {
+    return { detail::fmax(i1.l, i2.l), detail::fmax(i1.u, i2.u) };
+}
+
+/**
+ * PREDICATES
+*/
+template <class T>
+constexpr bool subseteq(interval<T> i1, interval<T> i2) {
+    return i1.l >= i2.l && i1.u <= i2.u;
+}
+template <class T>
+constexpr bool supseteq(interval<T> i1, interval<T> i2) {
+    return i2.l >= i1.l && i2.u <= i1.u;
+}
+template <class T>
+constexpr bool subset(interval<T> i1, interval<T> i2) {
+    return i1.l > i2.l && i1.u < i2.u;
+}
+template <class T>
+constexpr bool supset(interval<T> i1, interval<T> i2) {
+    return i2.l > i1.l && i2.u < i1.u;
+}
+// certainly_*: for every pair of points; possibly_*: for at least one.
+template <class T>
+constexpr bool certainly_lt(interval<T> i1, interval<T> i2) {
+    return i1.u < i2.l;
+}
+template <class T>
+constexpr bool certainly_le(interval<T> i1, interval<T> i2) {
+    return i1.u <= i2.l;
+}
+template <class T>
+constexpr bool certainly_gt(interval<T> i1, interval<T> i2) {
+    return i1.l > i2.u;
+}
+template <class T>
+constexpr bool certainly_ge(interval<T> i1, interval<T> i2) {
+    return i1.l >= i2.u;
+}
+template <class T>
+constexpr bool possibly_lt(interval<T> i1, interval<T> i2) {
+    return i1.l < i2.u;
+}
+template <class T>
+constexpr bool possibly_le(interval<T> i1, interval<T> i2) {
+    return i1.l <= i2.u;
+}
+template <class T>
+constexpr bool possibly_gt(interval<T> i1, interval<T> i2) {
+    return i1.u > i2.l;
+}
+template <class T>
+constexpr bool possibly_ge(interval<T> i1, interval<T> i2) {
+    return i1.u >= i2.l;
+}
+template <class T>
+constexpr bool contains(interval<T> i, T x) {
+    return i.l <= x && x <= i.u;
+}
+template <class T>
+constexpr bool overlaps(interval<T> i1, interval<T> i2) {
+    return i1.l <= i2.u && i2.l <= i1.u;
+}
+template <class T>
+constexpr bool operator==(interval<T> i1, interval<T> i2) {
+    return i1.l == i2.l && i1.u == i2.u;
+}
+template <class T>
+constexpr bool operator!=(interval<T> i1, interval<T> i2) {
+    return !(i1 == i2);
+}
+
+/**
+ * OPERATORS on scalars of interval<T>
+*/
+template <class T>
+constexpr interval<T> operator+(interval<T> a, interval<T> b) { return add(a, b); }
+template <class T>
+constexpr interval<T> operator+(interval<T> a, T s) { return add(a, s); }
+template <class T>
+constexpr interval<T> operator+(T s, interval<T> a) { return add(s, a); }
+template <class T>
+constexpr interval<T> operator-(interval<T> a, interval<T> b) { return subtract(a, b); }
+template <class T>
+constexpr interval<T> operator-(interval<T> a, T s) { return subtract(a, s); }
+template <class T>
+constexpr interval<T> operator-(T s, interval<T> a) { return subtract(s, a); }
+template <class T>
+constexpr interval<T> operator*(interval<T> a, interval<T> b) { return multiply(a, b); }
+template <class T>
+constexpr interval<T> operator*(interval<T> a, T s) { return multiply(a, s); }
+template <class T>
+constexpr interval<T> operator*(T s, interval<T> a) { return multiply(s, a); }
+template <class T>
+constexpr interval<T> operator/(interval<T> a, interval<T> b) { return divide(a, b); }
+template <class T>
+constexpr interval<T> operator/(interval<T> a, T s) { return divide(a, s); }
+template <class T>
+constexpr interval<T> operator/(T s, interval<T> a) { return divide(s, a); }
+template <class T>
+constexpr interval<T> operator-(interval<T> a) { return negative(a); }
+template <class T>
+constexpr interval<T> operator+(interval<T> a) { return a; }
+
+template <class T>
+constexpr interval<T>& operator+=(interval<T>& a, interval<T> b) { return a = a + b; }
+template <class T>
+constexpr interval<T>& operator-=(interval<T>& a, interval<T> b) { return a = a - b; }
+template <class T>
+constexpr interval<T>& operator*=(interval<T>& a, interval<T> b) { return a = a * b; }
+template <class T>
+constexpr interval<T>& operator/=(interval<T>& a, interval<T> b) { return a = a / b; }
+
+/**
+ * SPANS
+*/
+#ifdef NPINTERVAL_HAS_STD_SPAN
+template <class T>
+using span = std::span<T>;
+#else
+// Minimal stand-in for std::span before C++20.
+template <class T>
+class span {
+public:
+    constexpr span() : ptr_(nullptr), size_(0) {}
+    constexpr span(T* ptr, std::size_t size) : ptr_(ptr), size_(size) {}
+    template <class C, class = decltype(std::declval<C&>().data())>
+    constexpr span(C& c) : ptr_(c.data()), size_(c.size()) {}
+    constexpr T* data() const { return ptr_; }
+    constexpr std::size_t size() const { return size_; }
+    constexpr T& operator[](std::size_t i) const { return ptr_[i]; }
+    constexpr T* begin() const { return ptr_; }
+    constexpr T* end() const { return ptr_ + size_; }
+private:
+    T* ptr_;
+    std::size_t size_;
+};
+#endif
+
+/**
+ * EXPRESSION TEMPLATES
+ *
+ * expr<E> is the CRTP base of lazily evaluated interval arrays.  Leaves are
+ * array_ref (a span of intervals) and ivector; nodes combine them
+ * elementwise.  Nothing is computed until an expression is assigned with
+ * ivector::operator= or evaluate(), which then runs one loop over all
+ * elements.  Nodes hold ivector leaves by reference and everything else
+ * (array_ref, scalar_ref, other nodes) by value, so an expression must not
+ * outlive the vectors it reads.
+*/
+template <class T>
+class ivector;
+
+template <class E>
+struct expr {
+    constexpr const E& self() const { return static_cast<const E&>(*this); }
+    constexpr std::size_t size() const { return self().size(); }
+    constexpr auto operator[](std::size_t i) const { return self()[i]; }
+};
+
+template <class T>
+struct array_ref : expr<array_ref<T>> {
+    const interval<T>* ptr;
+    std::size_t n;
+    constexpr array_ref(const interval<T>* p, std::size_t n_) : ptr(p), n(n_) {}
+    constexpr array_ref(span<const interval<T>> s) : ptr(s.data()), n(s.size()) {}
+    constexpr std::size_t size() const { return n; }
+    constexpr interval<T> operator[](std::size_t i) const { return ptr[i]; }
+};
+
+template <class T>
+struct scalar_ref : expr<scalar_ref<T>> {
+    interval<T> v;
+    std::size_t n;
+    constexpr scalar_ref(interval<T> v_, std::size_t n_) : v(v_), n(n_) {}
+    constexpr std::size_t size() const { return n; }
+    constexpr interval<T> operator[](std::size_t) const { return v; }
+};
+
+// How a node stores an operand of type E.
+template <class E>
+struct expr_closure { using type = E; };
+template <class T>
+struct expr_closure<ivector<T>> { using type = const ivector<T>&; };
+template <class E>
+using expr_closure_t = typename expr_closure<E>::type;
+
+template <class Op, class A, class B>
+struct binary_expr : expr<binary_expr<Op, A, B>> {
+    expr_closure_t<A> a;
+    expr_closure_t<B> b;
+    constexpr binary_expr(const A& a_, const B& b_) : a(a_), b(b_) {}
+    constexpr std::size_t size() const { return a.size(); }
+    constexpr auto operator[](std::size_t i) const { return Op::apply(a[i], b[i]); }
+};
+
+template <class Op, class A>
+struct unary_expr : expr<unary_expr<Op, A>> {
+    expr_closure_t<A> a;
+    constexpr explicit unary_expr(const A& a_) : a(a_) {}
+    constexpr std::size_t size() const { return a.size(); }
+    constexpr auto operator[](std::size_t i) const { return Op::apply(a[i]); }
+};
+
+// Elementwise operations on scalar operands of interval<T> or T.
+template <class S, class V>
+struct scaled_expr : expr<scaled_expr<S, V>> {
+    S s;
+    expr_closure_t<V> v;
+    int left;
+    constexpr scaled_expr(S s_, const V& v_, int left_) : s(s_), v(v_), left(left_) {}
+    constexpr std::size_t size() const { return v.size(); }
+    constexpr auto operator[](std::size_t i) const { return left ? s * v[i] : v[i] * s; }
+};
+
+namespace ops {
+struct add { template <class A, class B> static constexpr auto apply(A a, B b) { return a + b; } };
+struct sub { template <class A, class B> static constexpr auto apply(A a, B b) { return a - b; } };
+struct mul { template <class A, class B> static constexpr auto apply(A a, B b) { return a * b; } };
+struct div { template <class A, class B> static constexpr auto apply(A a, B b) { return a / b; } };
+struct neg { template <class A> static constexpr auto apply(A a) { return -a; } };
+struct sin { template <class A> static auto apply(A a) { return npinterval::sin(a); } };
+struct cos { template <class A> static auto apply(A a) { return npinterval::cos(a); } };
+struct exp { template <class A> static auto apply(A a) { return npinterval::exp(a); } };
+struct sqrt { template <class A> static auto apply(A a) { return npinterval::sqrt(a); } };
+struct square { template <class A> static constexpr auto apply(A a) { return npinterval::square(a); } };
+} // namespace ops
+
+template <class A, class B>
+constexpr auto operator+(const expr<A>& a, const expr<B>& b) { return binary_expr<ops::add, A, B>(a.self(), b.self()); }
+template <class A, class B>
+constexpr auto operator-(const expr<A>& a, const expr<B>& b) { return binary_expr<ops::sub, A, B>(a.self(), b.self()); }
+template <class A, class B>
+constexpr auto operator*(const expr<A>& a, const expr<B>& b) { return binary_expr<ops::mul, A, B>(a.self(), b.self()); }
+template <class A, class B>
+constexpr auto operator/(const expr<A>& a, const expr<B>& b) { return binary_expr<ops::div, A, B>(a.self(), b.self()); }
+template <class A>
+constexpr auto operator-(const expr<A>& a) { return unary_expr<ops::neg, A>(a.self()); }
+
+template <class A, class S, class = std::enable_if_t<!std::is_base_of<expr<S>, S>::value>>
+constexpr auto operator*(const S& s, const expr<A>& a) { return scaled_expr<S, A>(s, a.self(), 1); }
+template <class A, class S, class = std::enable_if_t<!std::is_base_of<expr<S>, S>::value>>
+constexpr auto operator*(const expr<A>& a, const S& s) { return scaled_expr<S, A>(s, a.self(), 0); }
+
+template <class A> auto sin(const expr<A>& a) { return unary_expr<ops::sin, A>(a.self()); }
+template <class A> auto cos(const expr<A>& a) { return unary_expr<ops::cos, A>(a.self()); }
+template <class A> auto exp(const expr<A>& a) { return unary_expr<ops::exp, A>(a.self()); }
+template <class A> auto sqrt(const expr<A>& a) { return unary_expr<ops::sqrt, A>(a.self()); }
+template <class A> constexpr auto square(const expr<A>& a) { return unary_expr<ops::square, A>(a.self()); }
+
+// Evaluate an expression into out in a single pass.
+template <class T, class E>
+void evaluate(const expr<E>& e, span<interval<T>> out) {
+    const E& x = e.self();
+    const std::size_t n = out.size();
+    for (std::size_t i = 0; i < n; i++) {
+        out[i] = x[i];
+    }
+}
+
+// An owning interval array that takes part in expression templates.
+template <class T>
+class ivector : public expr<ivector<T>> {
+public:
+    ivector() = default;
+    explicit ivector(std::size_t n, interval<T> v = interval<T>()) : data_(n, v) {}
+    template <class E>
+    ivector(const expr<E>& e) : data_(e.size()) { assign(e); }
+    template <class E>
+    ivector& operator=(const expr<E>& e) {
+        if (data_.size() != e.size()) {
+            // e may alias this vector; evaluate into fresh storage.
+            std::vector<interval<T>> tmp(e.size());
+            npinterval::evaluate(e, span<interval<T>>(tmp.data(), tmp.size()));
+            data_.swap(tmp);
+        } else {
+            assign(e);
+        }
+        return *this;
+    }
+    std::size_t size() const { return data_.size(); }
+    interval<T> operator[](std::size_t i) const { return data_[i]; }
+    interval<T>& operator[](std::size_t i) { return data_[i]; }
+    interval<T>* data() { return data_.data(); }
+    const interval<T>* data() const { return data_.data(); }
+    array_ref<T> ref() const { return array_ref<T>(data_.data(), data_.size()); }
+private:
+    template <class E>
+    void assign(const expr<E>& e) {
+        npinterval::evaluate(e, span<interval<T>>(data_.data(), data_.size()));
+    }
+    std::vector<interval<T>> data_;
+};
+
+/**
+ * BATCH FUNCTIONS over spans
+*/
+#define NPINTERVAL_BATCH_BINARY(name)                                      \
+    template <class T>                                                     \
+    void name(span<const interval<T>> a, span<const interval<T>> b,        \
+              span<interval<T>> out) {                                     \
+        const std::size_t n = out.size();                                  \
+        for (std::size_t i = 0; i < n; i++) { out[i] = name(a[i], b[i]); } \
+    }                                                                      \
+    template <class T>                                                     \
+    void name(span<const interval<T>> a, T s, span<interval<T>> out) {     \
+        const std::size_t n = out.size();                                  \
+        for (std::size_t i = 0; i < n; i++) { out[i] = name(a[i], s); }    \
+    }
+NPINTERVAL_BATCH_BINARY(add)
+NPINTERVAL_BATCH_BINARY(subtract)
+NPINTERVAL_BATCH_BINARY(multiply)
+NPINTERVAL_BATCH_BINARY(divide)
+#undef NPINTERVAL_BATCH_BINARY
+
+#define NPINTERVAL_BATCH_UNARY(name)                                       \
+    template <class T>                                                     \
+    void name(span<const interval<T>> a, span<interval<T>> out) {          \
+        const std::size_t n = out.size();                                  \
+        for (std::size_t i = 0; i < n; i++) { out[i] = name(a[i]); }       \
+    }
+NPINTERVAL_BATCH_UNARY(negative)
+NPINTERVAL_BATCH_UNARY(inverse)
+NPINTERVAL_BATCH_UNARY(square)
+NPINTERVAL_BATCH_UNARY(sin)
+NPINTERVAL_BATCH_UNARY(cos)
+NPINTERVAL_BATCH_UNARY(tan)
+NPINTERVAL_BATCH_UNARY(arctan)
+NPINTERVAL_BATCH_UNARY(tanh)
+NPINTERVAL_BATCH_UNARY(relu)
+NPINTERVAL_BATCH_UNARY(sigmoid)
+NPINTERVAL_BATCH_UNARY(exp)
+NPINTERVAL_BATCH_UNARY(sqrt)
+#undef NPINTERVAL_BATCH_UNARY
+
+// Interval dot product sum_i a[i]*b[i], accumulated like INTERVAL_dot.
+template <class T>
+constexpr interval<T> dot(span<const interval<T>> a, span<const interval<T>> b) {
+    interval<T> r{};
+    for (std::size_t i = 0; i < a.size(); i++) {
+        r = add(r, multiply(a[i], b[i]));
+    }
+    return r;
+}
+
+} // namespace npinterval
+
+#ifdef __INTERVAL_H__
+// Conversions to and from the C struct when both headers are in use.
+static_assert(sizeof(npinterval::interval<double>) == sizeof(::interval),
+              "npinterval::interval<double> must match the C interval layout");
+namespace npinterval {
+inline interval<double> from_c(::interval i) { return { i.l, i.u }; }
+inline ::interval to_c(interval<double> i) { ::interval r; r.l = i.l; r.u = i.u; return r; }
+} // namespace npinterval
+#endif
+
+#endif
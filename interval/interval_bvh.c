@@ -0,0 +1,463 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "interval_bvh.h"
+#include "interval_parallel.h"
+
+// Queries per thread below which a batch is not split up.
+#define BVH_GRAIN_QUERIES 256
+
+/**
+ * STORAGE
+*/
+
+static intptr_t
+bvh_new_node(interval_bvh *t)
+{
+    intptr_t d, id;
+    if (t->num_nodes == t->node_capacity) {
+        intptr_t cap = 2*t->node_capacity + 16;
+        interval_bvh_node *nodes = realloc(t->nodes, cap*sizeof(interval_bvh_node));
+        interval *hulls;
+        if (nodes == NULL) {
+            return -1;
+        }
+        t->nodes = nodes;
+        hulls = realloc(t->hulls, cap*t->n*sizeof(interval));
+        if (hulls == NULL) {
+            return -1;
+        }
+        t->hulls = hulls;
+        t->node_capacity = cap;
+    }
+    id = t->num_nodes++;
+    t->nodes[id].child[0] = t->nodes[id].child[1] = -1;
+    t->nodes[id].count = 0;
+    for (d = 0; d < t->n; d++) {
+        t->hulls[id*t->n + d] = (interval) { INFINITY, -INFINITY };
+    }
+    return id;
+}
+
+static int
+bvh_reserve_boxes(interval_bvh *t, intptr_t count)
+{
+    if (t->size + count > t->capacity) {
+        intptr_t cap = 2*t->capacity + 16;
+        interval *boxes;
+        if (cap < t->size + count) {
+            cap = t->size + count;
+        }
+        boxes = realloc(t->boxes, cap*t->n*sizeof(interval));
+        if (boxes == NULL) {
+            return -1;
+        }
+        t->boxes = boxes;
+        t->capacity = cap;
+    }
+    return 0;
+}
+
+static inline void
+bvh_hull_add(interval *hull, const interval *box, intptr_t n)
+{
+    intptr_t d;
+    for (d = 0; d < n; d++) {
+        hull[d].l = fmin(hull[d].l, box[d].l);
+        hull[d].u = fmax(hull[d].u, box[d].u);
+    }
+}
+
+/**
+ * SPLITTING
+*/
+
+// The axis along which the centers of the boxes idx[0..cnt) spread most.
+static intptr_t
+bvh_split_axis(const interval_bvh *t, const intptr_t *idx, intptr_t cnt)
+{
+    intptr_t n = t->n, d, i, axis = 0;
+    double best = -1;
+    for (d = 0; d < n; d++) {
+        double lo = INFINITY, hi = -INFINITY;
+        for (i = 0; i < cnt; i++) {
+            const interval b = t->boxes[idx[i]*n + d];
+            double c = (b.l + b.u)/2;
+            lo = fmin(lo, c);
+            hi = fmax(hi, c);
+        }
+        if (hi - lo > best) {
+            best = hi - lo;
+            axis = d;
+        }
+    }
+    return axis;
+}
+
+// Reorder idx[0..cnt) (with key[] alongside) so that idx[k] has the k-th
+// smallest key, smaller-or-equal keys before it and larger-or-equal after.
+static void
+bvh_select(intptr_t *idx, double *key, intptr_t cnt, intptr_t k)
+{
+    intptr_t lo = 0, hi = cnt - 1;
+    while (hi > lo) {
+        double pivot = key[lo + (hi - lo)/2];
+        intptr_t i = lo, j = hi;
+        while (i <= j) {
+            while (key[i] < pivot) { i++; }
+            while (pivot < key[j]) { j--; }
+            if (i <= j) {
+                double tk = key[i]; key[i] = key[j]; key[j] = tk;
+                intptr_t ti = idx[i]; idx[i] = idx[j]; idx[j] = ti;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) {
+            hi = j;
+        } else if (k >= i) {
+            lo = i;
+        } else {
+            return;
+        }
+    }
+}
+
+// Median split of idx[0..cnt) along the widest axis; returns the size of
+// the first half.
+static intptr_t
+bvh_partition(const interval_bvh *t, intptr_t *idx, double *key, intptr_t cnt)
+{
+    intptr_t axis = bvh_split_axis(t, idx, cnt), i, half = cnt/2;
+    for (i = 0; i < cnt; i++) {
+        const interval b = t->boxes[idx[i]*t->n + axis];
+        key[i] = (b.l + b.u)/2;
+        if (key[i] != key[i]) {
+            key[i] = 0;
+        }
+    }
+    bvh_select(idx, key, cnt, half);
+    return half;
+}
+
+/**
+ * BULK LOADING
+*/
+
+static int
+bvh_build_node(interval_bvh *t, intptr_t node, intptr_t *idx, double *key, intptr_t cnt)
+{
+    intptr_t i, half, c0, c1;
+    for (i = 0; i < cnt; i++) {
+        bvh_hull_add(t->hulls + node*t->n, t->boxes + idx[i]*t->n, t->n);
+    }
+    if (cnt <= INTERVAL_BVH_LEAF) {
+        t->nodes[node].count = cnt;
+        memcpy(t->nodes[node].items, idx, cnt*sizeof(intptr_t));
+        return 0;
+    }
+    half = bvh_partition(t, idx, key, cnt);
+    if ((c0 = bvh_new_node(t)) < 0 || (c1 = bvh_new_node(t)) < 0) {
+        return -1;
+    }
+    t->nodes[node].child[0] = c0;
+    t->nodes[node].child[1] = c1;
+    if (bvh_build_node(t, c0, idx, key, half) < 0) {
+        return -1;
+    }
+    return bvh_build_node(t, c1, idx + half, key + half, cnt - half);
+}
+
+interval_bvh *
+interval_bvh_build(intptr_t n, const interval *boxes, intptr_t count)
+{
+    interval_bvh *t = calloc(1, sizeof(interval_bvh));
+    intptr_t *idx = NULL, i;
+    double *key = NULL;
+    if (t == NULL) {
+        return NULL;
+    }
+    t->n = n;
+    if (bvh_reserve_boxes(t, count) < 0 || bvh_new_node(t) < 0) {
+        goto fail;
+    }
+    memcpy(t->boxes, boxes, count*n*sizeof(interval));
+    t->size = count;
+    if (count == 0) {
+        return t;
+    }
+    idx = malloc(count*sizeof(intptr_t));
+    key = malloc(count*sizeof(double));
+    if (idx == NULL || key == NULL) {
+        goto fail;
+    }
+    for (i = 0; i < count; i++) {
+        idx[i] = i;
+    }
+    if (bvh_build_node(t, 0, idx, key, count) < 0) {
+        goto fail;
+    }
+    free(idx);
+    free(key);
+    return t;
+
+ fail:
+    free(idx);
+    free(key);
+    interval_bvh_free(t);
+    return NULL;
+}
+
+void
+interval_bvh_free(interval_bvh *t)
+{
+    if (t == NULL) {
+        return;
+    }
+    free(t->boxes);
+    free(t->nodes);
+    free(t->hulls);
+    free(t);
+}
+
+/**
+ * INSERTION
+*/
+
+// Summed width of hull & box minus that of hull.
+static double
+bvh_growth(const interval *hull, const interval *box, intptr_t n)
+{
+    double g = 0;
+    intptr_t d;
+    for (d = 0; d < n; d++) {
+        double w = hull[d].u > hull[d].l ? hull[d].u - hull[d].l : 0;
+        g += (fmax(hull[d].u, box[d].u) - fmin(hull[d].l, box[d].l)) - w;
+    }
+    return g;
+}
+
+static int
+bvh_insert_one(interval_bvh *t, intptr_t b)
+{
+    const intptr_t n = t->n;
+    const interval *box = t->boxes + b*n;
+    intptr_t node = 0, items[INTERVAL_BVH_LEAF + 1], c0, c1, half, i;
+    double key[INTERVAL_BVH_LEAF + 1];
+
+    while (t->nodes[node].child[0] >= 0) {
+        intptr_t a = t->nodes[node].child[0], z = t->nodes[node].child[1];
+        bvh_hull_add(t->hulls + node*n, box, n);
+        node = bvh_growth(t->hulls + z*n, box, n) < bvh_growth(t->hulls + a*n, box, n) ? z : a;
+    }
+    bvh_hull_add(t->hulls + node*n, box, n);
+    if (t->nodes[node].count < INTERVAL_BVH_LEAF) {
+        t->nodes[node].items[t->nodes[node].count++] = b;
+        return 0;
+    }
+
+    // Split the full leaf into two new leaves.
+    memcpy(items, t->nodes[node].items, INTERVAL_BVH_LEAF*sizeof(intptr_t));
+    items[INTERVAL_BVH_LEAF] = b;
+    half = bvh_partition(t, items, key, INTERVAL_BVH_LEAF + 1);
+    if ((c0 = bvh_new_node(t)) < 0 || (c1 = bvh_new_node(t)) < 0) {
+        return -1;
+    }
+    t->nodes[c0].count = half;
+    t->nodes[c1].count = INTERVAL_BVH_LEAF + 1 - half;
+    memcpy(t->nodes[c0].items, items, half*sizeof(intptr_t));
+    memcpy(t->nodes[c1].items, items + half, (INTERVAL_BVH_LEAF + 1 - half)*sizeof(intptr_t));
+    for (i = 0; i < half; i++) {
+        bvh_hull_add(t->hulls + c0*n, t->boxes + items[i]*n, n);
+    }
+    for (i = half; i <= INTERVAL_BVH_LEAF; i++) {
+        bvh_hull_add(t->hulls + c1*n, t->boxes + items[i]*n, n);
+    }
+    t->nodes[node].count = 0;
+    t->nodes[node].child[0] = c0;
+    t->nodes[node].child[1] = c1;
+    return 0;
+}
+
+int
+interval_bvh_insert(interval_bvh *t, const interval *boxes, intptr_t count)
+{
+    intptr_t i;
+    if (bvh_reserve_boxes(t, count) < 0) {
+        return -1;
+    }
+    memcpy(t->boxes + t->size*t->n, boxes, count*t->n*sizeof(interval));
+    for (i = 0; i < count; i++) {
+        if (bvh_insert_one(t, t->size) < 0) {
+            return -1;
+        }
+        t->size++;
+    }
+    return 0;
+}
+
+/**
+ * QUERIES
+*/
+
+static inline int
+bvh_test(const interval *b, const interval *q, intptr_t n, int predicate)
+{
+    intptr_t d;
+    switch (predicate) {
+        case INTERVAL_BVH_WITHIN:
+            for (d = 0; d < n; d++) {
+                if (!(q[d].l <= b[d].l && b[d].u <= q[d].u)) { return 0; }
+            }
+            return 1;
+        case INTERVAL_BVH_CONTAINS:
+            for (d = 0; d < n; d++) {
+                if (!(b[d].l <= q[d].l && q[d].u <= b[d].u)) { return 0; }
+            }
+            return 1;
+        default:
+            for (d = 0; d < n; d++) {
+                if (!(b[d].l <= q[d].u && q[d].l <= b[d].u)) { return 0; }
+            }
+            return 1;
+    }
+}
+
+typedef struct {
+    intptr_t *data;
+    intptr_t size, capacity;
+} bvh_buffer;
+
+static int
+bvh_push(bvh_buffer *buf, intptr_t v)
+{
+    if (buf->size == buf->capacity) {
+        intptr_t cap = 2*buf->capacity + 64;
+        intptr_t *data = realloc(buf->data, cap*sizeof(intptr_t));
+        if (data == NULL) {
+            return -1;
+        }
+        buf->data = data;
+        buf->capacity = cap;
+    }
+    buf->data[buf->size++] = v;
+    return 0;
+}
+
+typedef struct {
+    const interval_bvh *t;
+    const interval *queries;
+    intptr_t m, blocks;
+    int predicate;
+    bvh_buffer *out;     // one per block
+    int *failed;         // one per block
+} bvh_query_ctx;
+
+static int
+bvh_query_block(const bvh_query_ctx *ctx, intptr_t q0, intptr_t q1, bvh_buffer *out)
+{
+    const interval_bvh *t = ctx->t;
+    const intptr_t n = t->n;
+    // Whole subtrees are skipped unless their hull overlaps the query (or
+    // contains it, for CONTAINS).
+    const int node_predicate = ctx->predicate == INTERVAL_BVH_CONTAINS ?
+        INTERVAL_BVH_CONTAINS : INTERVAL_BVH_OVERLAPS;
+    bvh_buffer stack = { NULL, 0, 0 };
+    intptr_t q, i;
+    for (q = q0; q < q1; q++) {
+        const interval *qb = ctx->queries + q*n;
+        stack.size = 0;
+        if (bvh_push(&stack, 0) < 0) {
+            goto fail;
+        }
+        while (stack.size) {
+            intptr_t node = stack.data[--stack.size];
+            const interval_bvh_node *nd = t->nodes + node;
+            if (!bvh_test(t->hulls + node*n, qb, n, node_predicate)) {
+                continue;
+            }
+            if (nd->child[0] < 0) {
+                for (i = 0; i < nd->count; i++) {
+                    if (bvh_test(t->boxes + nd->items[i]*n, qb, n, ctx->predicate)) {
+                        if (bvh_push(out, q) < 0 || bvh_push(out, nd->items[i]) < 0) {
+                            goto fail;
+                        }
+                    }
+                }
+            } else if (bvh_push(&stack, nd->child[1]) < 0 || bvh_push(&stack, nd->child[0]) < 0) {
+                goto fail;
+            }
+        }
+    }
+    free(stack.data);
+    return 0;
+
+ fail:
+    free(stack.data);
+    return -1;
+}
+
+static void
+bvh_query_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+    const bvh_query_ctx *ctx = (const bvh_query_ctx *)ctx_;
+    intptr_t k;
+    for (k = start; k < stop; k++) {
+        ctx->failed[k] = bvh_query_block(ctx, ctx->m*k/ctx->blocks, ctx->m*(k + 1)/ctx->blocks,
+                                         ctx->out + k);
+    }
+}
+
+int
+interval_bvh_query(const interval_bvh *t, const interval *queries, intptr_t m,
+                   int predicate, intptr_t **pairs, intptr_t *npairs)
+{
+    intptr_t blocks = interval_get_num_threads(), k, total = 0;
+    bvh_query_ctx ctx;
+    int err = 0;
+
+    if (blocks > m/BVH_GRAIN_QUERIES) {
+        blocks = m/BVH_GRAIN_QUERIES;
+    }
+    if (blocks < 1) {
+        blocks = 1;
+    }
+    ctx.t = t;
+    ctx.queries = queries;
+    ctx.m = m;
+    ctx.blocks = blocks;
+    ctx.predicate = predicate;
+    ctx.out = calloc(blocks, sizeof(bvh_buffer));
+    ctx.failed = calloc(blocks, sizeof(int));
+    if (ctx.out == NULL || ctx.failed == NULL) {
+        free(ctx.out);
+        free(ctx.failed);
+        return -1;
+    }
+    // One block per thread; each block's pairs are then appended in order.
+    interval_parallel_for(blocks, 1, bvh_query_range, &ctx);
+
+    for (k = 0; k < blocks; k++) {
+        err |= ctx.failed[k];
+        total += ctx.out[k].size;
+    }
+    *npairs = total/2;
+    *pairs = err ? NULL : malloc((total ? total : 1)*sizeof(intptr_t));
+    if (*pairs == NULL) {
+        err = -1;
+    } else {
+        total = 0;
+        for (k = 0; k < blocks; k++) {
+            if (ctx.out[k].size) {
+                memcpy(*pairs + total, ctx.out[k].data, ctx.out[k].size*sizeof(intptr_t));
+            }
+            total += ctx.out[k].size;
+        }
+    }
+    for (k = 0; k < blocks; k++) {
+        free(ctx.out[k].data);
+    }
+    free(ctx.out);
+    free(ctx.failed);
+    return err ? -1 : 0;
+}
@@ -0,0 +1,66 @@
+#ifndef __INTERVAL_BVH_H__
+#define __INTERVAL_BVH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * BOUNDING VOLUME HIERARCHY over n-dimensional interval boxes
+ *
+ * A binary tree whose leaves hold up to INTERVAL_BVH_LEAF boxes and whose
+ * nodes carry the hull of everything below them.  interval_bvh_build
+ * bulk-loads a tree by recursive median splits of the box centers along
+ * their widest axis; interval_bvh_insert adds boxes one at a time,
+ * descending into the child whose hull grows least (in summed width) and
+ * splitting full leaves.  Boxes are numbered in insertion order.
+ *
+ * Queries take a batch of m query boxes and report every (query, box)
+ * pair satisfying the predicate, ordered by query and then by traversal
+ * order, which is the same for any number of threads.  Concurrent
+ * queries are fine; inserting while querying is not.
+*/
+#define INTERVAL_BVH_LEAF 8
+
+#define INTERVAL_BVH_OVERLAPS  0   // box & query is nonempty
+#define INTERVAL_BVH_WITHIN    1   // box is a subset of query
+#define INTERVAL_BVH_CONTAINS  2   // query is a subset of box
+
+typedef struct {
+    intptr_t child[2];                  // -1 in leaves
+    intptr_t count;                     // boxes in a leaf
+    intptr_t items[INTERVAL_BVH_LEAF];
+} interval_bvh_node;
+
+typedef struct {
+    intptr_t n;                         // dimension
+    intptr_t size, capacity;            // boxes
+    interval *boxes;                    // size x n
+    intptr_t num_nodes, node_capacity;
+    interval_bvh_node *nodes;           // node 0 is the root
+    interval *hulls;                    // num_nodes x n
+} interval_bvh;
+
+// A tree over the count boxes (count x n, C order), or NULL when out of
+// memory.  count may be 0.
+interval_bvh *interval_bvh_build(intptr_t n, const interval *boxes, intptr_t count);
+void interval_bvh_free(interval_bvh *t);
+
+// Append count boxes; returns 0, or -1 when out of memory (the tree then
+// holds a prefix of the new boxes).
+int interval_bvh_insert(interval_bvh *t, const interval *boxes, intptr_t count);
+
+// All pairs for m query boxes.  On success returns 0 and stores a
+// malloc'ed array of npairs (query, box) index pairs in *pairs; returns
+// -1 when out of memory.
+int interval_bvh_query(const interval_bvh *t, const interval *queries, intptr_t m,
+                       int predicate, intptr_t **pairs, intptr_t *npairs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
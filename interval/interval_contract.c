@@ -0,0 +1,296 @@
+#include <math.h>
+#include <stdlib.h>
+#include "interval_contract.h"
+#include "interval_parallel.h"
+
+// Node evaluations per thread below which a batch is not split up.
+#define HC4_GRAIN_NODES 16384
+
+/**
+ * PROJECTIONS
+ *
+ * Each narrows *x to the points of *x compatible with the constraint and
+ * returns 0 when none are left.  NaN bounds (0*inf and the like) prove
+ * nothing: fmax and fmin skip them.
+*/
+
+static inline int
+hc4_meet(interval *x, interval y)
+{
+    x->l = fmax(x->l, y.l);
+    x->u = fmin(x->u, y.u);
+    return x->l <= x->u;
+}
+
+// The nonnegative part of z, NaN bounds taken as unbounded.
+static inline interval
+hc4_nonnegative(interval z)
+{
+    return (interval) { fmax(z.l, 0), z.u != z.u ? INFINITY : z.u };
+}
+
+// x in p1 | p2.
+static inline int
+hc4_meet_union(interval *x, interval p1, interval p2)
+{
+    interval a = *x, b = *x;
+    int in1 = hc4_meet(&a, p1), in2 = hc4_meet(&b, p2);
+    if (in1 && in2) {
+        *x = interval_union(a, b);
+    } else if (in1) {
+        *x = a;
+    } else if (in2) {
+        *x = b;
+    }
+    return in1 || in2;
+}
+
+// x in z / y, with the two rays of the extended division when y
+// contains 0 and z does not.
+static inline int
+hc4_meet_quotient(interval *x, interval z, interval y)
+{
+    const interval none = { NAN, NAN };
+    interval p1 = none, p2 = none;
+    if (y.l > 0 || y.u < 0) {
+        return hc4_meet(x, interval_divide(z, y));
+    }
+    if (z.l <= 0 && z.u >= 0) {
+        return 1;
+    }
+    if (z.l > 0) {
+        if (y.l < 0) {
+            p1 = (interval) { -INFINITY, z.l/y.l };
+        }
+        if (y.u > 0) {
+            p2 = (interval) { z.l/y.u, INFINITY };
+        }
+    } else {
+        if (y.l < 0) {
+            p1 = (interval) { z.u/y.l, INFINITY };
+        }
+        if (y.u > 0) {
+            p2 = (interval) { -INFINITY, z.u/y.u };
+        }
+    }
+    if (p1.l != p1.l && p2.l != p2.l) {
+        return 0;
+    }
+    if (p1.l != p1.l) {
+        return hc4_meet(x, p2);
+    }
+    if (p2.l != p2.l) {
+        return hc4_meet(x, p1);
+    }
+    return hc4_meet_union(x, p1, p2);
+}
+
+// x in sqrt(z) | -sqrt(z).
+static inline int
+hc4_meet_square_root(interval *x, interval z)
+{
+    interval r;
+    z = hc4_nonnegative(z);
+    if (z.l > z.u) {
+        return 0;
+    }
+    r = (interval) { sqrt(z.l), sqrt(z.u) };
+    return hc4_meet_union(x, r, interval_negative(r));
+}
+
+// x in arcsin(z): the union over k of [2 pi k + a, 2 pi k + b] and
+// [2 pi k + pi - b, 2 pi k + pi - a], a = asin(z.l), b = asin(z.u).  The
+// bounds of x move up (down) to the first (last) piece they reach.
+static inline int
+hc4_meet_arcsin(interval *x, interval z)
+{
+    double a, b, k, lo = x->l, hi = x->u;
+    int j;
+    if (!hc4_meet(&z, (interval) { -1, 1 })) {
+        return 0;
+    }
+    if (!isfinite(lo) || !isfinite(hi)) {
+        return 1;
+    }
+    a = asin(z.l);
+    b = asin(z.u);
+    k = floor(lo/(2*M_PI)) - 1;
+    for (j = 0; j < 6; j++) {
+        double base = 2*M_PI*(k + j/2);
+        double pl = j % 2 ? base + M_PI - b : base + a;
+        double pu = j % 2 ? base + M_PI - a : base + b;
+        if (pu >= lo) {
+            lo = fmax(lo, pl);
+            break;
+        }
+    }
+    k = floor(hi/(2*M_PI)) + 1;
+    for (j = 0; j < 6; j++) {
+        double base = 2*M_PI*(k - j/2);
+        double pl = j % 2 ? base + a : base + M_PI - b;
+        double pu = j % 2 ? base + b : base + M_PI - a;
+        if (pl <= hi) {
+            hi = fmin(hi, pu);
+            break;
+        }
+    }
+    x->l = lo;
+    x->u = hi;
+    return lo <= hi;
+}
+
+/**
+ * SWEEPS
+*/
+
+static inline interval
+hc4_forward(const interval_hc4_node *nd, const interval *v, const interval *box)
+{
+    switch (nd->op) {
+    case INTERVAL_HC4_CONST: return nd->value;
+    case INTERVAL_HC4_VAR:   return box[nd->a];
+    case INTERVAL_HC4_ADD:   return interval_add(v[nd->a], v[nd->b]);
+    case INTERVAL_HC4_SUB:   return interval_subtract(v[nd->a], v[nd->b]);
+    case INTERVAL_HC4_MUL:   return interval_multiply(v[nd->a], v[nd->b]);
+    case INTERVAL_HC4_DIV:   return interval_divide(v[nd->a], v[nd->b]);
+    case INTERVAL_HC4_NEG:   return interval_negative(v[nd->a]);
+    case INTERVAL_HC4_SQR:   return interval_square(v[nd->a]);
+    case INTERVAL_HC4_SQRT:
+        // Only the nonnegative part of the operand is in the domain.
+        return interval_sqrt((interval) { fmax(v[nd->a].l, 0), v[nd->a].u });
+    case INTERVAL_HC4_EXP:   return interval_exp(v[nd->a]);
+    case INTERVAL_HC4_SIN:   return interval_sin(v[nd->a]);
+    case INTERVAL_HC4_COS:   return interval_cos(v[nd->a]);
+    }
+    return (interval) { -INFINITY, INFINITY };
+}
+
+// Project the value z of nd onto its operands in v; 0 if one is emptied.
+static inline int
+hc4_backward(const interval_hc4_node *nd, interval z, interval *v)
+{
+    interval *x = v + nd->a, *y = v + nd->b;
+    switch (nd->op) {
+    case INTERVAL_HC4_ADD:
+        return hc4_meet(x, interval_subtract(z, *y)) && hc4_meet(y, interval_subtract(z, *x));
+    case INTERVAL_HC4_SUB:
+        return hc4_meet(x, interval_add(z, *y)) && hc4_meet(y, interval_subtract(*x, z));
+    case INTERVAL_HC4_MUL:
+        return hc4_meet_quotient(x, z, *y) && hc4_meet_quotient(y, z, *x);
+    case INTERVAL_HC4_DIV:
+        return hc4_meet(x, interval_multiply(z, *y)) && hc4_meet_quotient(y, *x, z);
+    case INTERVAL_HC4_NEG:
+        return hc4_meet(x, interval_negative(z));
+    case INTERVAL_HC4_SQR:
+        return hc4_meet_square_root(x, z);
+    case INTERVAL_HC4_SQRT:
+        z = hc4_nonnegative(z);
+        return z.l <= z.u && hc4_meet(x, (interval) { z.l*z.l, z.u*z.u });
+    case INTERVAL_HC4_EXP:
+        z = hc4_nonnegative(z);
+        return z.u > 0 && hc4_meet(x, (interval) { log(z.l), log(z.u) });
+    case INTERVAL_HC4_SIN:
+        return hc4_meet_arcsin(x, z);
+    case INTERVAL_HC4_COS: {
+        // cos(x) = sin(x + pi/2)
+        interval s = { x->l + M_PI/2, x->u + M_PI/2 };
+        if (!hc4_meet_arcsin(&s, z)) {
+            return 0;
+        }
+        return hc4_meet(x, (interval) { s.l - M_PI/2, s.u - M_PI/2 });
+    }
+    }
+    return 1;
+}
+
+typedef struct {
+    const interval_hc4_node *nodes;
+    intptr_t num_nodes;
+    const int32_t *roots;
+    const interval *bounds;
+    intptr_t num_roots, n;
+    interval *boxes;
+    int maxiter;
+    double ratio;
+    int8_t *verdict;
+    int failed;
+} hc4_ctx;
+
+static int8_t
+hc4_box(const hc4_ctx *ctx, interval *box, interval *v)
+{
+    const interval_hc4_node *nodes = ctx->nodes;
+    intptr_t num_nodes = ctx->num_nodes, k, r;
+    int it, last = 0;
+    for (it = 0; ; it++) {
+        int inner = 1, shrunk = 0;
+        for (k = 0; k < num_nodes; k++) {
+            // sqrt is undefined on the negative part of its operand.
+            if (nodes[k].op == INTERVAL_HC4_SQRT && v[nodes[k].a].l < 0) {
+                if (v[nodes[k].a].u < 0) {
+                    return INTERVAL_HC4_EMPTY;
+                }
+                inner = 0;
+            }
+            v[k] = hc4_forward(nodes + k, v, box);
+        }
+        for (r = 0; r < ctx->num_roots; r++) {
+            interval *g = v + ctx->roots[r];
+            inner &= interval_subseteq(*g, ctx->bounds[r]);
+            if (!hc4_meet(g, ctx->bounds[r])) {
+                return INTERVAL_HC4_EMPTY;
+            }
+        }
+        if (inner) {
+            return INTERVAL_HC4_INNER;
+        }
+        if (last || it >= ctx->maxiter) {
+            return INTERVAL_HC4_BOUNDARY;
+        }
+        for (k = num_nodes - 1; k >= 0; k--) {
+            if (!hc4_backward(nodes + k, v[k], v)) {
+                return INTERVAL_HC4_EMPTY;
+            }
+        }
+        for (k = 0; k < num_nodes; k++) {
+            if (nodes[k].op == INTERVAL_HC4_VAR) {
+                interval *x = box + nodes[k].a;
+                double w = x->u - x->l;
+                if (!hc4_meet(x, v[k])) {
+                    return INTERVAL_HC4_EMPTY;
+                }
+                shrunk |= w - (x->u - x->l) > ctx->ratio*w;
+            }
+        }
+        // One more forward sweep classifies the contracted box.
+        last = !shrunk;
+    }
+}
+
+static void
+hc4_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+    hc4_ctx *ctx = (hc4_ctx *)ctx_;
+    interval *v = malloc((ctx->num_nodes + 1)*sizeof(interval));
+    intptr_t s;
+    if (v == NULL) {
+        ctx->failed = 1;
+        return;
+    }
+    for (s = start; s < stop; s++) {
+        ctx->verdict[s] = hc4_box(ctx, ctx->boxes + s*ctx->n, v);
+    }
+    free(v);
+}
+
+int
+interval_hc4_contract(const interval_hc4_node *nodes, intptr_t num_nodes,
+                      const int32_t *roots, const interval *bounds, intptr_t num_roots,
+                      intptr_t n, interval *boxes, intptr_t count,
+                      int maxiter, double ratio, int8_t *verdict)
+{
+    hc4_ctx ctx = { nodes, num_nodes, roots, bounds, num_roots, n, boxes, maxiter, ratio,
+                    verdict, 0 };
+    interval_parallel_for(count, HC4_GRAIN_NODES/(num_nodes + 1) + 1, hc4_range, &ctx);
+    return ctx.failed ? -1 : 0;
+}
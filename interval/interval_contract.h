@@ -0,0 +1,65 @@
+#ifndef __INTERVAL_CONTRACT_H__
+#define __INTERVAL_CONTRACT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * HC4 CONTRACTOR
+ *
+ * Constraints g_r(x) in [a_r, b_r] over boxes x in R^n, with the g_r
+ * given as one expression DAG: a list of nodes in which every operand
+ * comes before the node using it, so common subexpressions are shared
+ * between constraints.  HC4-revise sweeps the DAG forward (evaluating
+ * every node over the box), intersects each root with its bounds, and
+ * sweeps it backward, projecting every node onto its operands (x + y in
+ * z gives x in z - y, sin(x) in z gives x in the arcsines of z, ...).
+ * The variables then get the intersection of the box and whatever the
+ * sweep left on their nodes.  No point satisfying all constraints is
+ * ever lost.
+ *
+ * Sweeps are repeated on a box until one shrinks no side by more than
+ * ratio of its width, or maxiter sweeps were done.  Each box ends with
+ * a verdict:
+*/
+#define INTERVAL_HC4_EMPTY    0   // no point of the box satisfies the constraints
+#define INTERVAL_HC4_INNER    1   // every point of the box satisfies them
+#define INTERVAL_HC4_BOUNDARY 2   // anything else
+
+#define INTERVAL_HC4_CONST 0      // value
+#define INTERVAL_HC4_VAR   1      // x[a]
+#define INTERVAL_HC4_ADD   2      // a + b
+#define INTERVAL_HC4_SUB   3      // a - b
+#define INTERVAL_HC4_MUL   4      // a * b
+#define INTERVAL_HC4_DIV   5      // a / b
+#define INTERVAL_HC4_NEG   6      // -a
+#define INTERVAL_HC4_SQR   7      // a^2
+#define INTERVAL_HC4_SQRT  8      // sqrt(a)
+#define INTERVAL_HC4_EXP   9      // exp(a)
+#define INTERVAL_HC4_SIN   10     // sin(a)
+#define INTERVAL_HC4_COS   11     // cos(a)
+#define INTERVAL_HC4_NUM_OPS 12
+
+typedef struct {
+    int32_t op;
+    int32_t a, b;           // operand nodes; the variable index of VAR nodes
+    interval value;         // CONST nodes
+} interval_hc4_node;
+
+// Contract count boxes (count x n) in place.  roots[r] is the node of
+// g_r and bounds[r] its range.  Boxes are spread over threads.  Returns
+// 0, or -1 when out of memory.
+int interval_hc4_contract(const interval_hc4_node *nodes, intptr_t num_nodes,
+                          const int32_t *roots, const interval *bounds, intptr_t num_roots,
+                          intptr_t n, interval *boxes, intptr_t count,
+                          int maxiter, double ratio, int8_t *verdict);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
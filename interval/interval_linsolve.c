@@ -0,0 +1,278 @@
+#include <math.h>
+#include "interval_linsolve.h"
+#include "interval_parallel.h"
+
+// Floating point work per thread below which a batch is not split up.
+#define LINSOLVE_GRAIN_FLOPS 65536
+
+static inline double interval_mag(interval i) {
+    return fmax(fabs(i.l), fabs(i.u));
+}
+static inline double interval_mig(interval i) {
+    if (i.l <= 0 && i.u >= 0) { return 0; }
+    return fmin(fabs(i.l), fabs(i.u));
+}
+
+static intptr_t
+linsolve_grain(intptr_t n, intptr_t work_per_entry)
+{
+    intptr_t flops = n*n*work_per_entry + 1;
+    return LINSOLVE_GRAIN_FLOPS/flops + 1;
+}
+
+/**
+ * PRECONDITIONING
+*/
+
+typedef struct {
+    intptr_t n;
+    const double *C;
+    const interval *A, *b;
+    interval *Ap, *bp;
+} precondition_ctx;
+
+static void
+precondition_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+    const precondition_ctx *ctx = (const precondition_ctx *)ctx_;
+    intptr_t n = ctx->n, s, i, j, k;
+    for (s = start; s < stop; s++) {
+        const double *C = ctx->C + s*n*n;
+        const interval *A = ctx->A + s*n*n, *b = ctx->b + s*n;
+        interval *Ap = ctx->Ap + s*n*n, *bp = ctx->bp + s*n;
+        for (i = 0; i < n; i++) {
+            interval r = { 0, 0 };
+            for (j = 0; j < n; j++) {
+                Ap[i*n + j] = (interval) { 0, 0 };
+            }
+            for (k = 0; k < n; k++) {
+                const double c = C[i*n + k];
+                for (j = 0; j < n; j++) {
+                    Ap[i*n + j] = interval_add(Ap[i*n + j], interval_scalar_multiply(c, A[k*n + j]));
+                }
+                r = interval_add(r, interval_scalar_multiply(c, b[k]));
+            }
+            bp[i] = r;
+        }
+    }
+}
+
+void
+interval_precondition(intptr_t batch, intptr_t n, const double *C,
+                      const interval *A, const interval *b,
+                      interval *Ap, interval *bp)
+{
+    precondition_ctx ctx = { n, C, A, b, Ap, bp };
+    interval_parallel_for(batch, linsolve_grain(n, n), precondition_range, &ctx);
+}
+
+/**
+ * ITERATIVE SOLVERS
+*/
+
+// Replace *x by *x & y.  Returns -1 if the intersection is empty, 1 if
+// it contracted *x by more than tol times its width, and 0 otherwise.
+static inline int
+linsolve_update(interval *x, interval y, double tol)
+{
+    interval old = *x;
+    double w = old.u - old.l;
+    interval r = { fmax(old.l, y.l), fmin(old.u, y.u) };
+    if (r.l > r.u) {
+        return -1;
+    }
+    *x = r;
+    if (!isfinite(w)) {
+        return r.l != old.l || r.u != old.u;
+    }
+    return (r.l - old.l) > tol*w || (old.u - r.u) > tol*w;
+}
+
+// The box |x| <= ||b'|| / (1 - ||I - A'||), or -1 if ||I - A'|| >= 1.
+static double
+linsolve_radius(intptr_t n, const interval *Ap, const interval *bp)
+{
+    double beta = 0, bnorm = 0;
+    intptr_t i, j;
+    for (i = 0; i < n; i++) {
+        double row = 0;
+        for (j = 0; j < n; j++) {
+            row += interval_mag(interval_scalar_subtract(i == j, Ap[i*n + j]));
+        }
+        beta = fmax(beta, row);
+        bnorm = fmax(bnorm, interval_mag(bp[i]));
+    }
+    if (!(beta < 1)) {
+        return -1;
+    }
+    return bnorm/(1 - beta);
+}
+
+static void
+linsolve_fill(intptr_t n, interval *x, interval v)
+{
+    intptr_t i;
+    for (i = 0; i < n; i++) {
+        x[i] = v;
+    }
+}
+
+// Returns the status of one system.
+static int
+linsolve_system(intptr_t n, const interval *Ap, const interval *bp, interval *x,
+                int method, int have_x0, int maxiter, double tol)
+{
+    intptr_t i, j;
+    int it, contracted, u;
+    double r = linsolve_radius(n, Ap, bp);
+
+    if (r >= 0) {
+        for (i = 0; i < n; i++) {
+            if (have_x0) {
+                if (linsolve_update(&x[i], (interval) { -r, r }, tol) < 0) {
+                    linsolve_fill(n, x, (interval) { NAN, NAN });
+                    return INTERVAL_LINSOLVE_EMPTY;
+                }
+            } else {
+                x[i] = (interval) { -r, r };
+            }
+        }
+    } else if (!have_x0) {
+        linsolve_fill(n, x, (interval) { -INFINITY, INFINITY });
+        return INTERVAL_LINSOLVE_FAILED;
+    }
+
+    for (it = 0; it < maxiter; it++) {
+        contracted = 0;
+        for (i = 0; i < n; i++) {
+            interval s = bp[i], y;
+            if (method == INTERVAL_LINSOLVE_KRAWCZYK) {
+                // b'_i + sum_j (I - A')_ij x_j
+                for (j = 0; j < n; j++) {
+                    s = interval_add(s, interval_multiply(
+                        interval_scalar_subtract(i == j, Ap[i*n + j]), x[j]));
+                }
+                y = s;
+            } else {
+                // (b'_i - sum_{j != i} A'_ij x_j) / A'_ii
+                const interval d = Ap[i*n + i];
+                if (d.l <= 0 && d.u >= 0) {
+                    continue;
+                }
+                for (j = 0; j < n; j++) {
+                    if (j != i) {
+                        s = interval_subtract(s, interval_multiply(Ap[i*n + j], x[j]));
+                    }
+                }
+                y = interval_divide(s, d);
+            }
+            u = linsolve_update(&x[i], y, tol);
+            if (u < 0) {
+                linsolve_fill(n, x, (interval) { NAN, NAN });
+                return INTERVAL_LINSOLVE_EMPTY;
+            }
+            contracted |= u;
+        }
+        if (!contracted) {
+            return INTERVAL_LINSOLVE_CONVERGED;
+        }
+    }
+    return INTERVAL_LINSOLVE_MAXITER;
+}
+
+typedef struct {
+    intptr_t n;
+    const interval *Ap, *bp;
+    const double *M;
+    interval *x;
+    int *status;
+    int method, have_x0, maxiter;
+    double tol;
+} linsolve_ctx;
+
+static void
+linsolve_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+    const linsolve_ctx *ctx = (const linsolve_ctx *)ctx_;
+    intptr_t n = ctx->n, s;
+    for (s = start; s < stop; s++) {
+        ctx->status[s] = linsolve_system(n, ctx->Ap + s*n*n, ctx->bp + s*n, ctx->x + s*n,
+                                         ctx->method, ctx->have_x0, ctx->maxiter, ctx->tol);
+    }
+}
+
+void
+interval_linsolve_iterate(intptr_t batch, intptr_t n, const interval *Ap,
+                          const interval *bp, interval *x, int *status,
+                          int method, int have_x0, int maxiter, double tol)
+{
+    linsolve_ctx ctx = { n, Ap, bp, NULL, x, status, method, have_x0, maxiter, tol };
+    interval_parallel_for(batch, linsolve_grain(n, maxiter > 0 ? maxiter : 1), linsolve_range, &ctx);
+}
+
+/**
+ * HANSEN-BLIEK-ROHN HULL
+ *
+ * With u = M|b'| and d = diag(M),
+ *     x_i = (b'_i + [-beta_i, beta_i]) / (A'_ii + [-alpha_i, alpha_i]),
+ *     alpha_i = <A'>_ii - 1/d_i,  beta_i = u_i/d_i - |b'_i|
+ * (A. Neumaier, "A simple derivation of the Hansen-Bliek-Rohn-Ning-
+ * Kearfott enclosure for linear interval equations", 1999).
+*/
+
+static int
+hansen_bliek_system(intptr_t n, const interval *Ap, const interval *bp, const double *M,
+                    interval *x, int have_x0)
+{
+    intptr_t i, j;
+    for (i = 0; i < n*n; i++) {
+        if (!(M[i] >= 0)) {
+            linsolve_fill(n, x, (interval) { -INFINITY, INFINITY });
+            return INTERVAL_LINSOLVE_FAILED;
+        }
+    }
+    for (i = 0; i < n; i++) {
+        double u = 0, d = M[i*n + i], alpha, beta;
+        interval y;
+        for (j = 0; j < n; j++) {
+            u += M[i*n + j]*interval_mag(bp[j]);
+        }
+        if (!(d > 0)) {
+            linsolve_fill(n, x, (interval) { -INFINITY, INFINITY });
+            return INTERVAL_LINSOLVE_FAILED;
+        }
+        alpha = interval_mig(Ap[i*n + i]) - 1/d;
+        beta = fmax(u/d - interval_mag(bp[i]), 0);
+        y = interval_divide((interval) { bp[i].l - beta, bp[i].u + beta },
+                            (interval) { Ap[i*n + i].l - alpha, Ap[i*n + i].u + alpha });
+        if (have_x0) {
+            if (linsolve_update(&x[i], y, 0) < 0) {
+                linsolve_fill(n, x, (interval) { NAN, NAN });
+                return INTERVAL_LINSOLVE_EMPTY;
+            }
+        } else {
+            x[i] = y;
+        }
+    }
+    return INTERVAL_LINSOLVE_CONVERGED;
+}
+
+static void
+hansen_bliek_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+    const linsolve_ctx *ctx = (const linsolve_ctx *)ctx_;
+    intptr_t n = ctx->n, s;
+    for (s = start; s < stop; s++) {
+        ctx->status[s] = hansen_bliek_system(n, ctx->Ap + s*n*n, ctx->bp + s*n, ctx->M + s*n*n,
+                                             ctx->x + s*n, ctx->have_x0);
+    }
+}
+
+void
+interval_hansen_bliek(intptr_t batch, intptr_t n, const interval *Ap,
+                      const interval *bp, const double *M, interval *x,
+                      int *status, int have_x0)
+{
+    linsolve_ctx ctx = { n, Ap, bp, M, x, status, 0, have_x0, 0, 0 };
+    interval_parallel_for(batch, linsolve_grain(n, 1), hansen_bliek_range, &ctx);
+}
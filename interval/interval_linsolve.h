@@ -0,0 +1,58 @@
+#ifndef __INTERVAL_LINSOLVE_H__
+#define __INTERVAL_LINSOLVE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * BATCHED INTERVAL LINEAR SYSTEMS
+ *
+ * Enclosures of the solution set of [A]x = [b] for a batch of n x n
+ * systems, stored C-contiguously one after the other (A as batch x n x n,
+ * b and x as batch x n).  The systems are first preconditioned with an
+ * approximate inverse C of mid(A) (interval_precondition), and the
+ * solvers then work on A' = C[A], b' = C[b].  Systems of a batch are
+ * independent and are split across threads.
+*/
+
+// Per-system outcome, written to status[].
+#define INTERVAL_LINSOLVE_CONVERGED 0   // x stopped contracting
+#define INTERVAL_LINSOLVE_MAXITER   1   // x encloses the solutions but was still contracting
+#define INTERVAL_LINSOLVE_EMPTY     2   // the initial box holds no solution; x is NaN
+#define INTERVAL_LINSOLVE_FAILED    3   // A' is not verified regular; x is unbounded
+
+#define INTERVAL_LINSOLVE_GAUSS_SEIDEL 0
+#define INTERVAL_LINSOLVE_KRAWCZYK     1
+
+// Ap = C A and bp = C b, with C a batch of n x n double matrices.
+void interval_precondition(intptr_t batch, intptr_t n, const double *C,
+                           const interval *A, const interval *b,
+                           interval *Ap, interval *bp);
+
+// Iterate the preconditioned Gauss-Seidel or Krawczyk operator on x in
+// place, intersecting with the current box, until no component contracts
+// by more than tol times its width or maxiter sweeps have run.  Unless
+// have_x0, x is initialized to the box |x| <= ||b'||/(1 - ||I - A'||)
+// (infinity norms); otherwise that box, when it exists, is intersected
+// with the given x.
+void interval_linsolve_iterate(intptr_t batch, intptr_t n, const interval *Ap,
+                               const interval *bp, interval *x, int *status,
+                               int method, int have_x0, int maxiter, double tol);
+
+// The Hansen-Bliek-Rohn hull of the preconditioned systems, in Neumaier's
+// form, given M = inverse of the comparison matrix <A'>.  The hull is only
+// valid when M >= 0; systems where it is not are marked FAILED.  With
+// have_x0 the result is intersected with x.
+void interval_hansen_bliek(intptr_t batch, intptr_t n, const interval *Ap,
+                           const interval *bp, const double *M, interval *x,
+                           int *status, int have_x0);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,69 @@
+#include <math.h>
+#include "interval_newton.h"
+#include "interval_parallel.h"
+
+// Floating point work per thread below which a batch is not split up.
+#define KRAWCZYK_GRAIN_FLOPS 65536
+
+typedef struct {
+    intptr_t n;
+    const interval *X, *fc, *J;
+    const double *c, *C;
+    interval *Y;
+    int8_t *verdict;
+} krawczyk_ctx;
+
+static int8_t
+krawczyk_box(intptr_t n, const interval *X, const double *c, const interval *fc,
+             const interval *J, const double *C, interval *Y)
+{
+    intptr_t i, j, k;
+    int interior = 1, empty = 0;
+    for (i = 0; i < n; i++) {
+        interval K = { c[i], c[i] };
+        for (k = 0; k < n; k++) {
+            K = interval_subtract(K, interval_scalar_multiply(C[i*n + k], fc[k]));
+        }
+        for (j = 0; j < n; j++) {
+            // (I - C J)_ij (X_j - c_j)
+            interval m = { i == j, i == j };
+            for (k = 0; k < n; k++) {
+                m = interval_subtract(m, interval_scalar_multiply(C[i*n + k], J[k*n + j]));
+            }
+            K = interval_add(K, interval_multiply(m, interval_subtract_scalar(X[j], c[j])));
+        }
+        interior &= X[i].l < K.l && K.u < X[i].u;
+        Y[i] = (interval) { fmax(K.l, X[i].l), fmin(K.u, X[i].u) };
+        // A NaN bound (e.g. 0*inf) proves nothing.
+        if (K.l != K.l || K.u != K.u) {
+            Y[i] = X[i];
+            interior = 0;
+        } else if (Y[i].l > Y[i].u) {
+            empty = 1;
+        }
+    }
+    if (empty) {
+        return INTERVAL_KRAWCZYK_NONE;
+    }
+    return interior ? INTERVAL_KRAWCZYK_UNIQUE : INTERVAL_KRAWCZYK_UNDECIDED;
+}
+
+static void
+krawczyk_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+    const krawczyk_ctx *ctx = (const krawczyk_ctx *)ctx_;
+    intptr_t n = ctx->n, s;
+    for (s = start; s < stop; s++) {
+        ctx->verdict[s] = krawczyk_box(n, ctx->X + s*n, ctx->c + s*n, ctx->fc + s*n,
+                                       ctx->J + s*n*n, ctx->C + s*n*n, ctx->Y + s*n);
+    }
+}
+
+void
+interval_krawczyk(intptr_t batch, intptr_t n, const interval *X, const double *c,
+                  const interval *fc, const interval *J, const double *C,
+                  interval *Y, int8_t *verdict)
+{
+    krawczyk_ctx ctx = { n, X, fc, J, c, C, Y, verdict };
+    interval_parallel_for(batch, KRAWCZYK_GRAIN_FLOPS/(n*n*n + 1) + 1, krawczyk_range, &ctx);
+}
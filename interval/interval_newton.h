@@ -0,0 +1,32 @@
+#ifndef __INTERVAL_NEWTON_H__
+#define __INTERVAL_NEWTON_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * BATCHED KRAWCZYK OPERATOR
+ *
+ * For a batch of boxes X (batch x n), points c in them, enclosures fc of
+ * f(c), interval Jacobians J of f over X (batch x n x n) and approximate
+ * inverses C of mid(J), computes
+ *     K(X) = c - C f(c) + (I - C J)(X - c)
+ * and writes Y = K(X) & X.  verdict[] tells what K proves about X:
+*/
+#define INTERVAL_KRAWCZYK_NONE      0   // K(X) & X is empty: no root in X
+#define INTERVAL_KRAWCZYK_UNIQUE    1   // K(X) is interior to X: exactly one root, in Y
+#define INTERVAL_KRAWCZYK_UNDECIDED 2   // any roots in X are in Y
+
+void interval_krawczyk(intptr_t batch, intptr_t n, const interval *X, const double *c,
+                       const interval *fc, const interval *J, const double *C,
+                       interval *Y, int8_t *verdict);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+#include "interval_nn.h"
+#include "interval_parallel.h"
+
+// Doubles written (or activations evaluated) per thread below which a
+// batch is not split up.
+#define IBP_GRAIN 16384
+
+typedef struct {
+    intptr_t count, n;
+    const interval *X;
+    double *P;
+} ibp_planes_ctx;
+
+static void
+ibp_planes_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+    const ibp_planes_ctx *ctx = (const ibp_planes_ctx *)ctx_;
+    intptr_t n = ctx->n, s, k;
+    for (s = start; s < stop; s++) {
+        const interval *x = ctx->X + s*n;
+        double *lower = ctx->P + s*2*n, *upper = ctx->P + (ctx->count + s)*2*n;
+        for (k = 0; k < n; k++) {
+            lower[k] = upper[n + k] = x[k].l;
+            lower[n + k] = upper[k] = x[k].u;
+        }
+    }
+}
+
+void
+interval_ibp_planes(intptr_t count, intptr_t n, const interval *X, double *P)
+{
+    ibp_planes_ctx ctx = { count, n, X, P };
+    interval_parallel_for(count, IBP_GRAIN/(4*n + 1) + 1, ibp_planes_range, &ctx);
+}
+
+typedef struct {
+    intptr_t count, n, m;
+    const interval *X;
+    const double *S, *G, *b;
+    int act;
+    interval *Y;
+} ibp_activate_ctx;
+
+static void
+ibp_activate_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+    const ibp_activate_ctx *ctx = (const ibp_activate_ctx *)ctx_;
+    intptr_t n = ctx->n, m = ctx->m, s, j, k;
+    for (s = start; s < stop; s++) {
+        const interval *x = ctx->X + s*n;
+        const double *lower = ctx->G + s*m, *upper = ctx->G + (ctx->count + s)*m;
+        interval *y = ctx->Y + s*m;
+        for (k = 0; k < n && isfinite(x[k].l) && isfinite(x[k].u); k++);
+        if (k == n) {
+            for (j = 0; j < m; j++) {
+                y[j] = (interval) { lower[j] + ctx->b[j], upper[j] + ctx->b[j] };
+            }
+        } else {
+            // Not finite: the product in G may hold 0*inf = NaN.
+            for (j = 0; j < m; j++) {
+                y[j] = (interval) { ctx->b[j], ctx->b[j] };
+            }
+            for (k = 0; k < n; k++) {
+                const double *wp = ctx->S + k*m, *wm = ctx->S + (n + k)*m;
+                for (j = 0; j < m; j++) {
+                    if (wp[j] != 0) {
+                        y[j].l += wp[j]*x[k].l;
+                        y[j].u += wp[j]*x[k].u;
+                    }
+                    if (wm[j] != 0) {
+                        y[j].l += wm[j]*x[k].u;
+                        y[j].u += wm[j]*x[k].l;
+                    }
+                }
+            }
+        }
+        switch (ctx->act) {
+        case INTERVAL_ACT_RELU:
+            for (j = 0; j < m; j++) {
+                y[j] = interval_relu(y[j]);
+            }
+            break;
+        case INTERVAL_ACT_TANH:
+            for (j = 0; j < m; j++) {
+                y[j] = interval_tanh(y[j]);
+            }
+            break;
+        case INTERVAL_ACT_SIGMOID:
+            for (j = 0; j < m; j++) {
+                y[j] = interval_sigmoid(y[j]);
+            }
+            break;
+        }
+    }
+}
+
+void
+interval_ibp_activate(intptr_t count, intptr_t n, intptr_t m, const interval *X,
+                      const double *S, const double *G, const double *b,
+                      int act, interval *Y)
+{
+    ibp_activate_ctx ctx = { count, n, m, X, S, G, b, act, Y };
+    intptr_t cost = act == INTERVAL_ACT_TANH || act == INTERVAL_ACT_SIGMOID ? 32*m : 2*m;
+    interval_parallel_for(count, IBP_GRAIN/(cost + 1) + 1, ibp_activate_range, &ctx);
+}
@@ -0,0 +1,53 @@
+#ifndef __INTERVAL_NN_H__
+#define __INTERVAL_NN_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * INTERVAL BOUND PROPAGATION
+ *
+ * A dense layer y = act(W x + b) with float weights maps a box x to the
+ * box with bounds
+ *
+ *     y.l = act(W+ x.l + W- x.u + b),    y.u = act(W+ x.u + W- x.l + b),
+ *
+ * W+ = max(W, 0) and W- = min(W, 0), for any monotone act.  For a batch
+ * of boxes both bounds come out of one float64 product P @ S with the
+ * sign split S = [W+^T; W-^T] (2n x m) of W (m x n) and the input planes
+ *
+ *     P = [[x.l  x.u]      one row per box for the lower bounds,
+ *          [x.u  x.l]]     then one per box for the upper bounds,
+ *
+ * which the caller hands to BLAS.  The bias and the activation are then
+ * applied to the result while packing it into intervals.
+ *
+ * A zero weight against an infinite bound makes BLAS produce 0*inf = NaN
+ * where the sign split means 0, so the bounds of a box with an infinite
+ * (or NaN) bound are instead summed here from S, skipping zero weights.
+*/
+#define INTERVAL_ACT_NONE    0
+#define INTERVAL_ACT_RELU    1
+#define INTERVAL_ACT_TANH    2
+#define INTERVAL_ACT_SIGMOID 3
+#define INTERVAL_NUM_ACTS    4
+
+// P (2 count x 2n) from count boxes X (count x n).
+void interval_ibp_planes(intptr_t count, intptr_t n, const interval *X, double *P);
+
+// Y (count x m) from G = P @ S (2 count x m), the bias b (m) and act,
+// given the boxes X (count x n) and the sign split S (2n x m) for the
+// boxes that are not finite.
+void interval_ibp_activate(intptr_t count, intptr_t n, intptr_t m, const interval *X,
+                           const double *S, const double *G, const double *b,
+                           int act, interval *Y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
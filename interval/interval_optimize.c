@@ -0,0 +1,388 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "interval_optimize.h"
+
+interval_minimizer *
+interval_minimizer_new(intptr_t n)
+{
+    interval_minimizer *m = calloc(1, sizeof(interval_minimizer));
+    if (m == NULL) {
+        return NULL;
+    }
+    m->n = n;
+    m->best = INFINITY;
+    return m;
+}
+
+void
+interval_minimizer_free(interval_minimizer *m)
+{
+    if (m == NULL) {
+        return;
+    }
+    free(m->keys);
+    free(m->slots);
+    free(m->pool);
+    free(m->free_slots);
+    free(m->done_keys);
+    free(m->done);
+    free(m);
+}
+
+/**
+ * HEAP
+*/
+
+static void
+minimizer_sift_up(interval_minimizer *m, intptr_t i)
+{
+    double key = m->keys[i];
+    intptr_t slot = m->slots[i];
+    while (i > 0) {
+        intptr_t parent = (i - 1)/2;
+        if (m->keys[parent] <= key) {
+            break;
+        }
+        m->keys[i] = m->keys[parent];
+        m->slots[i] = m->slots[parent];
+        i = parent;
+    }
+    m->keys[i] = key;
+    m->slots[i] = slot;
+}
+
+static void
+minimizer_sift_down(interval_minimizer *m, intptr_t i)
+{
+    double key = m->keys[i];
+    intptr_t slot = m->slots[i];
+    for (;;) {
+        intptr_t c = 2*i + 1;
+        if (c >= m->size) {
+            break;
+        }
+        if (c + 1 < m->size && m->keys[c + 1] < m->keys[c]) {
+            c++;
+        }
+        if (key <= m->keys[c]) {
+            break;
+        }
+        m->keys[i] = m->keys[c];
+        m->slots[i] = m->slots[c];
+        i = c;
+    }
+    m->keys[i] = key;
+    m->slots[i] = slot;
+}
+
+// Room for count more queued boxes.
+static int
+minimizer_reserve(interval_minimizer *m, intptr_t count)
+{
+    intptr_t cap, k;
+    double *keys;
+    intptr_t *slots, *free_slots;
+    interval *pool;
+    if (m->size + count <= m->capacity) {
+        return 0;
+    }
+    cap = 2*m->capacity > m->size + count ? 2*m->capacity : m->size + count + 64;
+    keys = realloc(m->keys, cap*sizeof(double));
+    if (keys == NULL) {
+        return -1;
+    }
+    m->keys = keys;
+    slots = realloc(m->slots, cap*sizeof(intptr_t));
+    if (slots == NULL) {
+        return -1;
+    }
+    m->slots = slots;
+    free_slots = realloc(m->free_slots, cap*sizeof(intptr_t));
+    if (free_slots == NULL) {
+        return -1;
+    }
+    m->free_slots = free_slots;
+    pool = realloc(m->pool, cap*m->n*sizeof(interval));
+    if (pool == NULL) {
+        return -1;
+    }
+    m->pool = pool;
+    // The unused slots are the first capacity - size entries of free_slots.
+    for (k = 0; k < cap - m->capacity; k++) {
+        m->free_slots[m->capacity - m->size + k] = m->capacity + k;
+    }
+    m->capacity = cap;
+    return 0;
+}
+
+// Rebuild the heap from the entries whose key is at most best.
+static void
+minimizer_prune_queue(interval_minimizer *m)
+{
+    intptr_t i, kept = 0, nfree = m->capacity - m->size;
+    for (i = 0; i < m->size; i++) {
+        if (m->keys[i] <= m->best) {
+            m->keys[kept] = m->keys[i];
+            m->slots[kept] = m->slots[i];
+            kept++;
+        } else {
+            m->free_slots[nfree++] = m->slots[i];
+        }
+    }
+    m->size = kept;
+    for (i = kept/2 - 1; i >= 0; i--) {
+        minimizer_sift_down(m, i);
+    }
+}
+
+void
+interval_minimizer_prune(interval_minimizer *m)
+{
+    intptr_t i, kept = 0, n = m->n;
+    if (!m->stale) {
+        return;
+    }
+    minimizer_prune_queue(m);
+    for (i = 0; i < m->num_done; i++) {
+        if (m->done_keys[i] <= m->best) {
+            if (kept != i) {
+                m->done_keys[kept] = m->done_keys[i];
+                memcpy(m->done + kept*n, m->done + i*n, n*sizeof(interval));
+            }
+            kept++;
+        }
+    }
+    m->num_done = kept;
+    m->stale = 0;
+}
+
+/**
+ * BOUNDS
+*/
+
+void
+interval_minimizer_bound(interval_minimizer *m, const interval *values, intptr_t count)
+{
+    double best = m->best;
+    intptr_t i;
+    for (i = 0; i < count; i++) {
+        best = fmin(best, values[i].u);
+    }
+    if (best < m->best) {
+        m->best = best;
+        m->stale = 1;
+    }
+}
+
+int
+interval_minimizer_push(interval_minimizer *m, const interval *boxes, const interval *F,
+                        intptr_t count)
+{
+    intptr_t i, n = m->n;
+    interval_minimizer_bound(m, F, count);
+    if (minimizer_reserve(m, count) < 0) {
+        return -1;
+    }
+    for (i = 0; i < count; i++) {
+        double key = F[i].l != F[i].l ? -INFINITY : F[i].l;
+        intptr_t slot;
+        if (key > m->best) {
+            continue;
+        }
+        slot = m->free_slots[m->capacity - m->size - 1];
+        memcpy(m->pool + slot*n, boxes + i*n, n*sizeof(interval));
+        m->keys[m->size] = key;
+        m->slots[m->size] = slot;
+        m->size++;
+        minimizer_sift_up(m, m->size - 1);
+    }
+    return 0;
+}
+
+/**
+ * BRANCHING
+*/
+
+// Set box aside as a candidate minimizer.
+static int
+minimizer_set_aside(interval_minimizer *m, const interval *box, double key)
+{
+    intptr_t n = m->n;
+    if (m->num_done == m->done_capacity) {
+        intptr_t cap = 2*m->done_capacity + 16;
+        double *keys = realloc(m->done_keys, cap*sizeof(double));
+        interval *done;
+        if (keys == NULL) {
+            return -1;
+        }
+        m->done_keys = keys;
+        done = realloc(m->done, cap*n*sizeof(interval));
+        if (done == NULL) {
+            return -1;
+        }
+        m->done = done;
+        m->done_capacity = cap;
+    }
+    m->done_keys[m->num_done] = key;
+    memcpy(m->done + m->num_done*n, box, n*sizeof(interval));
+    m->num_done++;
+    return 0;
+}
+
+intptr_t
+interval_minimizer_split(interval_minimizer *m, intptr_t count, double tol, interval *children)
+{
+    intptr_t n = m->n, written = 0, d;
+    interval_minimizer_prune(m);
+    while (count > 0 && m->size > 0) {
+        double key = m->keys[0], widest = -1;
+        intptr_t slot = m->slots[0], axis = 0;
+        const interval *box = m->pool + slot*n;
+        interval *lo, *hi;
+
+        m->size--;
+        m->free_slots[m->capacity - m->size - 1] = slot;
+        if (m->size > 0) {
+            m->keys[0] = m->keys[m->size];
+            m->slots[0] = m->slots[m->size];
+            minimizer_sift_down(m, 0);
+        }
+        if (key > m->best) {
+            continue;
+        }
+        for (d = 0; d < n; d++) {
+            double w = box[d].u - box[d].l;
+            if (w > widest) {
+                widest = w;
+                axis = d;
+            }
+        }
+        if (widest < tol) {
+            if (minimizer_set_aside(m, box, key) < 0) {
+                return -1;
+            }
+            continue;
+        }
+        lo = children + written*n;
+        hi = lo + n;
+        memcpy(lo, box, n*sizeof(interval));
+        memcpy(hi, box, n*sizeof(interval));
+        lo[axis].u = hi[axis].l = 0.5*box[axis].l + 0.5*box[axis].u;
+        written += 2;
+        count--;
+    }
+    return written;
+}
+
+/**
+ * RESULTS
+*/
+
+double
+interval_minimizer_lower(const interval_minimizer *m)
+{
+    double lower = m->size > 0 ? m->keys[0] : INFINITY;
+    intptr_t i;
+    for (i = 0; i < m->num_done; i++) {
+        lower = fmin(lower, m->done_keys[i]);
+    }
+    return lower;
+}
+
+intptr_t
+interval_minimizer_count(interval_minimizer *m)
+{
+    interval_minimizer_prune(m);
+    return m->size + m->num_done;
+}
+
+// Swap boxes i and j set aside, with their keys.
+static void
+minimizer_swap_done(interval_minimizer *m, intptr_t i, intptr_t j)
+{
+    intptr_t n = m->n, d;
+    double key = m->done_keys[i];
+    m->done_keys[i] = m->done_keys[j];
+    m->done_keys[j] = key;
+    for (d = 0; d < n; d++) {
+        interval t = m->done[i*n + d];
+        m->done[i*n + d] = m->done[j*n + d];
+        m->done[j*n + d] = t;
+    }
+}
+
+// Restore the max-heap of the first size boxes set aside below i.
+static void
+minimizer_sift_done(interval_minimizer *m, intptr_t i, intptr_t size)
+{
+    for (;;) {
+        intptr_t c = 2*i + 1;
+        if (c >= size) {
+            break;
+        }
+        if (c + 1 < size && m->done_keys[c + 1] > m->done_keys[c]) {
+            c++;
+        }
+        if (m->done_keys[i] >= m->done_keys[c]) {
+            break;
+        }
+        minimizer_swap_done(m, i, c);
+        i = c;
+    }
+}
+
+// The queue comes out in order of lower bound by heapsorting it in place,
+// and so do the boxes set aside; the two runs are then merged from the
+// back of out.
+void
+interval_minimizer_export(interval_minimizer *m, interval *out, double *lower)
+{
+    intptr_t n = m->n, size, i, j, k;
+    interval_minimizer_prune(m);
+    size = m->size;
+    for (i = 0; i < size; i++) {
+        memcpy(out + i*n, m->pool + m->slots[0]*n, n*sizeof(interval));
+        lower[i] = m->keys[0];
+        m->size--;
+        if (m->size > 0) {
+            double key = m->keys[0];
+            intptr_t slot = m->slots[0];
+            m->keys[0] = m->keys[m->size];
+            m->slots[0] = m->slots[m->size];
+            minimizer_sift_down(m, 0);
+            m->keys[m->size] = key;
+            m->slots[m->size] = slot;
+        }
+    }
+    // Popping to the end of the array leaves it sorted in decreasing
+    // order, which is a valid heap only reversed: restore it.
+    m->size = size;
+    for (i = 0; i < size/2; i++) {
+        double tk = m->keys[i];
+        intptr_t ts = m->slots[i];
+        m->keys[i] = m->keys[size - 1 - i];
+        m->slots[i] = m->slots[size - 1 - i];
+        m->keys[size - 1 - i] = tk;
+        m->slots[size - 1 - i] = ts;
+    }
+
+    for (i = m->num_done/2 - 1; i >= 0; i--) {
+        minimizer_sift_done(m, i, m->num_done);
+    }
+    for (i = m->num_done - 1; i > 0; i--) {
+        minimizer_swap_done(m, 0, i);
+        minimizer_sift_done(m, 0, i);
+    }
+    i = size - 1;
+    j = m->num_done - 1;
+    for (k = size + m->num_done - 1; j >= 0; k--) {
+        if (i >= 0 && lower[i] > m->done_keys[j]) {
+            memcpy(out + k*n, out + i*n, n*sizeof(interval));
+            lower[k] = lower[i--];
+        } else {
+            memcpy(out + k*n, m->done + j*n, n*sizeof(interval));
+            lower[k] = m->done_keys[j--];
+        }
+    }
+}
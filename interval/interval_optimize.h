@@ -0,0 +1,79 @@
+#ifndef __INTERVAL_OPTIMIZE_H__
+#define __INTERVAL_OPTIMIZE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * MOORE-SKELBOE GLOBAL MINIMIZATION
+ *
+ * The work list of a branch-and-bound search for min f over a box.  The
+ * caller evaluates interval enclosures F(X) of f over boxes X (a batch at
+ * a time) and hands them in; the minimizer keeps the boxes in a binary
+ * min-heap keyed on the lower bound F(X).l, and tracks `best`, the least
+ * upper bound of the minimum seen so far (F(X).u, or f over a point such
+ * as the midpoint of X).  A box with F(X).l > best cannot contain a
+ * global minimizer and is dropped, on arrival or when best improves.
+ *
+ * interval_minimizer_split pops the boxes of least lower bound and
+ * bisects them at the midpoint of their widest side (the first one on
+ * ties).  Boxes narrower than tol in every side are set aside instead;
+ * with the boxes still queued they make up the candidate minimizers,
+ * and the least of their lower bounds and best enclose the minimum.
+*/
+typedef struct {
+    intptr_t n;                 // dimension
+    double best;                // upper bound of the minimum, +inf at first
+    intptr_t size, capacity;    // queued boxes
+    double *keys;               // size lower bounds, a min-heap
+    intptr_t *slots;            // the box of each heap entry, in pool
+    interval *pool;             // capacity x n boxes
+    intptr_t *free_slots;       // capacity - size unused slots of pool
+    intptr_t num_done, done_capacity;
+    double *done_keys;          // lower bounds of the boxes set aside
+    interval *done;             // num_done x n
+    int stale;                  // best improved since the last prune
+} interval_minimizer;
+
+// An empty minimizer over boxes of dimension n, or NULL when out of memory.
+interval_minimizer *interval_minimizer_new(intptr_t n);
+void interval_minimizer_free(interval_minimizer *m);
+
+// Lower best to the least upper endpoint of the count intervals values
+// (enclosures of f at points, or over boxes).
+void interval_minimizer_bound(interval_minimizer *m, const interval *values, intptr_t count);
+
+// Queue count boxes (count x n) with the enclosures F (count) of f over
+// them.  F also bounds best.  A NaN lower bound counts as -inf.
+// Returns 0, or -1 when out of memory.
+int interval_minimizer_push(interval_minimizer *m, const interval *boxes, const interval *F,
+                            intptr_t count);
+
+// Pop up to count boxes, least lower bound first, and write the two
+// halves of each to children (2*count x n at most); boxes narrower than
+// tol are set aside.  Returns the number of children written, or -1 when
+// out of memory.
+intptr_t interval_minimizer_split(interval_minimizer *m, intptr_t count, double tol,
+                                  interval *children);
+
+// Drop queued and set-aside boxes whose lower bound exceeds best.
+void interval_minimizer_prune(interval_minimizer *m);
+
+// The least lower bound over queued and set-aside boxes (+inf if none).
+double interval_minimizer_lower(const interval_minimizer *m);
+
+// The candidate minimizers, queued and set aside, least lower bound first
+// (interval_minimizer_count(m) x n).  Prunes first, and sorts the boxes
+// set aside in place.
+intptr_t interval_minimizer_count(interval_minimizer *m);
+void interval_minimizer_export(interval_minimizer *m, interval *out, double *lower);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
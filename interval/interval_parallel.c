@@ -0,0 +1,188 @@
+#include <stdlib.h>
+#include "interval_parallel.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define INTERVAL_MAX_THREADS 256
+
+static int interval_num_threads = 0;
+
+// NPINTERVAL_NUM_THREADS if set to a positive number, otherwise the
+// number of online processors.
+static int
+interval_default_num_threads(void)
+{
+    const char *env = getenv("NPINTERVAL_NUM_THREADS");
+    if (env != NULL && atoi(env) > 0) {
+        int n = atoi(env);
+        return n < INTERVAL_MAX_THREADS ? n : INTERVAL_MAX_THREADS;
+    }
+#if !defined(_WIN32) && defined(_SC_NPROCESSORS_ONLN)
+    {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        if (n > 0) {
+            return n < INTERVAL_MAX_THREADS ? (int)n : INTERVAL_MAX_THREADS;
+        }
+    }
+#endif
+    return 1;
+}
+
+int
+interval_get_num_threads(void)
+{
+    if (interval_num_threads < 1) {
+        interval_num_threads = interval_default_num_threads();
+    }
+    return interval_num_threads;
+}
+
+void
+interval_set_num_threads(int n)
+{
+    interval_num_threads = n < INTERVAL_MAX_THREADS ? n : INTERVAL_MAX_THREADS;
+}
+
+#ifndef _WIN32
+/**
+ * THREAD POOL
+ *
+ * Workers are started on first use and then wait on `work` for the next
+ * job.  A job is published under `lock` by bumping `generation`; worker k
+ * runs range k of nt (if k < nt) and the last one to finish signals
+ * `done`.  The caller runs range 0 itself.  `busy` admits one job at a
+ * time: a call made while the pool is running a job (from another Python
+ * thread, or from inside a job) runs on its own thread instead of
+ * waiting.
+*/
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work, done;
+    int size;
+    unsigned long generation;
+    unsigned long seen[INTERVAL_MAX_THREADS];
+    interval_parallel_fn fn;
+    void *ctx;
+    intptr_t n, nt, pending;
+} interval_thread_pool;
+
+static interval_thread_pool interval_pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER
+};
+static pthread_mutex_t interval_pool_busy = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t interval_pool_once = PTHREAD_ONCE_INIT;
+
+// A forked child has none of the workers; start over.
+static void
+interval_pool_atfork_child(void)
+{
+    pthread_mutex_init(&interval_pool.lock, NULL);
+    pthread_cond_init(&interval_pool.work, NULL);
+    pthread_cond_init(&interval_pool.done, NULL);
+    pthread_mutex_init(&interval_pool_busy, NULL);
+    interval_pool.size = 0;
+}
+
+static void
+interval_pool_init(void)
+{
+    pthread_atfork(NULL, NULL, interval_pool_atfork_child);
+}
+
+static void *
+interval_pool_worker(void *arg)
+{
+    interval_thread_pool *pool = &interval_pool;
+    intptr_t k = (intptr_t)arg;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->seen[k] == pool->generation) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        pool->seen[k] = pool->generation;
+        if (k < pool->nt) {
+            interval_parallel_fn fn = pool->fn;
+            void *ctx = pool->ctx;
+            intptr_t n = pool->n, nt = pool->nt;
+            pthread_mutex_unlock(&pool->lock);
+            fn(ctx, n*k/nt, n*(k + 1)/nt);
+            pthread_mutex_lock(&pool->lock);
+            if (--pool->pending == 0) {
+                pthread_cond_signal(&pool->done);
+            }
+        }
+    }
+    return NULL;
+}
+
+// Starts workers 1..nt-1 that are not running yet; returns how many
+// threads (counting the caller) are available.
+static intptr_t
+interval_pool_reserve(intptr_t nt)
+{
+    interval_thread_pool *pool = &interval_pool;
+    pthread_once(&interval_pool_once, interval_pool_init);
+    pthread_mutex_lock(&pool->lock);
+    while (pool->size + 1 < nt) {
+        pthread_t thread;
+        intptr_t k = pool->size + 1;
+        pool->seen[k] = pool->generation;
+        if (pthread_create(&thread, NULL, interval_pool_worker, (void *)k) != 0) {
+            break;
+        }
+        pthread_detach(thread);
+        pool->size++;
+    }
+    if (nt > pool->size + 1) {
+        nt = pool->size + 1;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return nt;
+}
+#endif
+
+void
+interval_parallel_for(intptr_t n, intptr_t grain, interval_parallel_fn fn, void *ctx)
+{
+    intptr_t nt = interval_get_num_threads();
+    if (grain < 1) {
+        grain = 1;
+    }
+    if (nt > n/grain) {
+        nt = n/grain;
+    }
+#ifndef _WIN32
+    if (nt > 1 && pthread_mutex_trylock(&interval_pool_busy) == 0) {
+        interval_thread_pool *pool = &interval_pool;
+        nt = interval_pool_reserve(nt);
+        if (nt > 1) {
+            pthread_mutex_lock(&pool->lock);
+            pool->fn = fn;
+            pool->ctx = ctx;
+            pool->n = n;
+            pool->nt = nt;
+            pool->pending = nt - 1;
+            pool->generation++;
+            pthread_cond_broadcast(&pool->work);
+            pthread_mutex_unlock(&pool->lock);
+
+            fn(ctx, 0, n/nt);
+
+            pthread_mutex_lock(&pool->lock);
+            while (pool->pending > 0) {
+                pthread_cond_wait(&pool->done, &pool->lock);
+            }
+            pthread_mutex_unlock(&pool->lock);
+            pthread_mutex_unlock(&interval_pool_busy);
+            return;
+        }
+        pthread_mutex_unlock(&interval_pool_busy);
+    }
+#endif
+    if (n > 0) {
+        fn(ctx, 0, n);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef __INTERVAL_PARALLEL_H__
+#define __INTERVAL_PARALLEL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * PARALLEL FOR
+ *
+ * interval_parallel_for(n, grain, fn, ctx) calls fn(ctx, start, stop) on
+ * disjoint ranges covering [0, n), at most one range per thread and none
+ * shorter than grain (so small problems stay on the calling thread).
+ * The ranges only depend on n, grain and the thread count, and callers
+ * give every index its own output, so results never depend on how the
+ * work was split.  fn must not call back into Python.
+ *
+ * The ranges run on a pool of worker threads that is started on first
+ * use and kept for the life of the process; the calling thread runs the
+ * first range.  A call made while the pool is busy (from another thread,
+ * or nested inside fn) runs entirely on the calling thread.
+ *
+ * Without pthreads (_WIN32) everything runs on the calling thread.
+*/
+typedef void (*interval_parallel_fn)(void *ctx, intptr_t start, intptr_t stop);
+
+void interval_parallel_for(intptr_t n, intptr_t grain, interval_parallel_fn fn, void *ctx);
+
+// Number of threads used by interval_parallel_for; defaults to the
+// NPINTERVAL_NUM_THREADS environment variable, or else the number of
+// online processors.  n < 1 restores the default.
+int interval_get_num_threads(void);
+void interval_set_num_threads(int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
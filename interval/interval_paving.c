@@ -0,0 +1,397 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "interval_paving.h"
+
+/**
+ * NODES
+*/
+
+static intptr_t
+paving_alloc(interval_paving *p)
+{
+    intptr_t id;
+    if (p->free_list >= 0) {
+        id = p->free_list;
+        p->free_list = p->nodes[id].child[0];
+    } else {
+        if (p->num_nodes == p->capacity) {
+            intptr_t cap = 2*p->capacity + 16;
+            interval_paving_node *nodes = realloc(p->nodes, cap*sizeof(interval_paving_node));
+            if (nodes == NULL) {
+                return -1;
+            }
+            p->nodes = nodes;
+            p->capacity = cap;
+        }
+        id = p->num_nodes++;
+    }
+    p->nodes[id].state = INTERVAL_PAVING_OUT;
+    p->nodes[id].child[0] = p->nodes[id].child[1] = -1;
+    return id;
+}
+
+// Put the subtrees below node on the free list.
+static void
+paving_drop_children(interval_paving *p, intptr_t node)
+{
+    int k;
+    if (p->nodes[node].state != INTERVAL_PAVING_SPLIT) {
+        return;
+    }
+    for (k = 0; k < 2; k++) {
+        intptr_t c = p->nodes[node].child[k];
+        paving_drop_children(p, c);
+        p->nodes[c].child[0] = p->free_list;
+        p->free_list = c;
+    }
+    p->nodes[node].child[0] = p->nodes[node].child[1] = -1;
+}
+
+static void
+paving_set_leaf(interval_paving *p, intptr_t node, int8_t state)
+{
+    paving_drop_children(p, node);
+    p->nodes[node].state = state;
+}
+
+// Merge the children of node if they are leaves in the same state.
+static void
+paving_merge(interval_paving *p, intptr_t node)
+{
+    const interval_paving_node *nd = p->nodes + node;
+    int8_t s0, s1;
+    if (nd->state != INTERVAL_PAVING_SPLIT) {
+        return;
+    }
+    s0 = p->nodes[nd->child[0]].state;
+    s1 = p->nodes[nd->child[1]].state;
+    if (s0 == s1 && s0 != INTERVAL_PAVING_SPLIT) {
+        paving_set_leaf(p, node, s0);
+    }
+}
+
+// Make a leaf node SPLIT with two OUT children.
+static int
+paving_split(interval_paving *p, intptr_t node)
+{
+    intptr_t c0 = paving_alloc(p), c1;
+    if (c0 < 0) {
+        return -1;
+    }
+    c1 = paving_alloc(p);
+    if (c1 < 0) {
+        return -1;
+    }
+    p->nodes[node].state = INTERVAL_PAVING_SPLIT;
+    p->nodes[node].child[0] = c0;
+    p->nodes[node].child[1] = c1;
+    return 0;
+}
+
+/**
+ * GEOMETRY
+ *
+ * Boxes of nodes are not stored; traversals carry the current box and
+ * narrow it in place on the way down.
+*/
+
+static intptr_t
+paving_axis(const interval *box, intptr_t n)
+{
+    intptr_t d, axis = 0;
+    for (d = 1; d < n; d++) {
+        if (box[d].u - box[d].l > box[axis].u - box[axis].l) {
+            axis = d;
+        }
+    }
+    return axis;
+}
+
+// Visit child k of the node with this box: narrow box[axis] to its half.
+#define PAVING_CHILD(box, axis, k, body)                                  \
+    do {                                                                  \
+        interval _saved = (box)[axis];                                    \
+        double _mid = (_saved.l + _saved.u)/2;                            \
+        if (k) { (box)[axis].l = _mid; } else { (box)[axis].u = _mid; }   \
+        body;                                                             \
+        (box)[axis] = _saved;                                             \
+    } while (0)
+
+interval_paving *
+interval_paving_new(intptr_t n, const interval *root)
+{
+    interval_paving *p = calloc(1, sizeof(interval_paving));
+    if (p == NULL) {
+        return NULL;
+    }
+    p->n = n;
+    p->free_list = -1;
+    p->root = malloc((n ? n : 1)*sizeof(interval));
+    if (p->root == NULL || paving_alloc(p) < 0) {
+        interval_paving_free(p);
+        return NULL;
+    }
+    memcpy(p->root, root, n*sizeof(interval));
+    return p;
+}
+
+void
+interval_paving_free(interval_paving *p)
+{
+    if (p == NULL) {
+        return;
+    }
+    free(p->root);
+    free(p->nodes);
+    free(p);
+}
+
+/**
+ * INSERTION
+*/
+
+static int
+paving_insert_rec(interval_paving *p, intptr_t node, interval *box, const interval *q,
+                  double eps, int outer)
+{
+    intptr_t d, axis, n = p->n;
+    int inside = 1, err = 0;
+    double width = 0, mid;
+
+    if (p->nodes[node].state == INTERVAL_PAVING_IN) {
+        return 0;
+    }
+    for (d = 0; d < n; d++) {
+        // Boxes that only touch a face do not overlap, unless q is flat
+        // in that direction.
+        interval r = interval_intersection(box[d], q[d]);
+        if (r.l != r.l || (r.l == r.u && q[d].l != q[d].u && box[d].l != box[d].u)) {
+            return 0;
+        }
+        inside &= interval_subseteq(box[d], q[d]);
+        width = fmax(width, box[d].u - box[d].l);
+    }
+    if (inside) {
+        paving_set_leaf(p, node, INTERVAL_PAVING_IN);
+        return 0;
+    }
+    // Cells whose widest side has no float strictly inside it cannot be
+    // bisected, whatever eps asks for.
+    axis = paving_axis(box, n);
+    mid = (box[axis].l + box[axis].u)/2;
+    if (width <= eps || !(box[axis].l < mid && mid < box[axis].u)) {
+        if (outer) {
+            paving_set_leaf(p, node, INTERVAL_PAVING_IN);
+        }
+        return 0;
+    }
+    if (p->nodes[node].state == INTERVAL_PAVING_OUT && paving_split(p, node) < 0) {
+        return -1;
+    }
+    PAVING_CHILD(box, axis, 0,
+                 err = paving_insert_rec(p, p->nodes[node].child[0], box, q, eps, outer));
+    if (err) {
+        return -1;
+    }
+    PAVING_CHILD(box, axis, 1,
+                 err = paving_insert_rec(p, p->nodes[node].child[1], box, q, eps, outer));
+    if (err) {
+        return -1;
+    }
+    paving_merge(p, node);
+    return 0;
+}
+
+int
+interval_paving_insert(interval_paving *p, const interval *boxes, intptr_t count,
+                       double eps, int outer)
+{
+    intptr_t i;
+    interval *box;
+    if (!(eps > 0 && eps < INFINITY)) {
+        return -2;
+    }
+    box = malloc((p->n ? p->n : 1)*sizeof(interval));
+    if (box == NULL) {
+        return -1;
+    }
+    for (i = 0; i < count; i++) {
+        memcpy(box, p->root, p->n*sizeof(interval));
+        if (paving_insert_rec(p, 0, box, boxes + i*p->n, eps, outer) < 0) {
+            free(box);
+            return -1;
+        }
+    }
+    free(box);
+    return 0;
+}
+
+/**
+ * SET OPERATIONS
+*/
+
+// Copy the subtree of src at s into dst at node d.
+static int
+paving_copy_rec(interval_paving *dst, intptr_t d, const interval_paving *src, intptr_t s)
+{
+    int k;
+    if (src->nodes[s].state != INTERVAL_PAVING_SPLIT) {
+        dst->nodes[d].state = src->nodes[s].state;
+        return 0;
+    }
+    if (paving_split(dst, d) < 0) {
+        return -1;
+    }
+    for (k = 0; k < 2; k++) {
+        if (paving_copy_rec(dst, dst->nodes[d].child[k], src, src->nodes[s].child[k]) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// dominant is the leaf state that decides the result on its own: IN for
+// union, OUT for intersection.
+static int
+paving_combine_rec(interval_paving *dst, intptr_t d, const interval_paving *a, intptr_t an,
+                   const interval_paving *b, intptr_t bn, int8_t dominant)
+{
+    int8_t sa = a->nodes[an].state, sb = b->nodes[bn].state;
+    int k;
+    if (sa == dominant || sb == dominant) {
+        dst->nodes[d].state = dominant;
+        return 0;
+    }
+    if (sa != INTERVAL_PAVING_SPLIT) {
+        return paving_copy_rec(dst, d, b, bn);
+    }
+    if (sb != INTERVAL_PAVING_SPLIT) {
+        return paving_copy_rec(dst, d, a, an);
+    }
+    if (paving_split(dst, d) < 0) {
+        return -1;
+    }
+    for (k = 0; k < 2; k++) {
+        if (paving_combine_rec(dst, dst->nodes[d].child[k], a, a->nodes[an].child[k],
+                               b, b->nodes[bn].child[k], dominant) < 0) {
+            return -1;
+        }
+    }
+    paving_merge(dst, d);
+    return 0;
+}
+
+static interval_paving *
+paving_combine(const interval_paving *a, const interval_paving *b, int8_t dominant)
+{
+    interval_paving *p = interval_paving_new(a->n, a->root);
+    if (p == NULL) {
+        return NULL;
+    }
+    if (paving_combine_rec(p, 0, a, 0, b, 0, dominant) < 0) {
+        interval_paving_free(p);
+        return NULL;
+    }
+    return p;
+}
+
+interval_paving *
+interval_paving_union(const interval_paving *a, const interval_paving *b)
+{
+    return paving_combine(a, b, INTERVAL_PAVING_IN);
+}
+
+interval_paving *
+interval_paving_intersection(const interval_paving *a, const interval_paving *b)
+{
+    return paving_combine(a, b, INTERVAL_PAVING_OUT);
+}
+
+int
+interval_paving_compact(interval_paving *p)
+{
+    interval_paving *q = interval_paving_new(p->n, p->root);
+    interval_paving_node *nodes;
+    if (q == NULL) {
+        return -1;
+    }
+    if (paving_copy_rec(q, 0, p, 0) < 0) {
+        interval_paving_free(q);
+        return -1;
+    }
+    // Swap the node pools and free the old one with q.
+    nodes = p->nodes;
+    p->nodes = q->nodes;
+    q->nodes = nodes;
+    p->num_nodes = q->num_nodes;
+    p->capacity = q->capacity;
+    p->free_list = -1;
+    interval_paving_free(q);
+    return 0;
+}
+
+/**
+ * TRAVERSALS
+*/
+
+typedef struct {
+    intptr_t count;
+    double volume;
+    interval *out;
+} paving_visit;
+
+static void
+paving_visit_rec(const interval_paving *p, intptr_t node, interval *box, paving_visit *v)
+{
+    const interval_paving_node *nd = p->nodes + node;
+    intptr_t d, axis;
+    if (nd->state == INTERVAL_PAVING_IN) {
+        double vol = 1;
+        for (d = 0; d < p->n; d++) {
+            vol *= box[d].u - box[d].l;
+        }
+        v->volume += vol;
+        if (v->out != NULL) {
+            memcpy(v->out + v->count*p->n, box, p->n*sizeof(interval));
+        }
+        v->count++;
+    } else if (nd->state == INTERVAL_PAVING_SPLIT) {
+        axis = paving_axis(box, p->n);
+        PAVING_CHILD(box, axis, 0, paving_visit_rec(p, nd->child[0], box, v));
+        PAVING_CHILD(box, axis, 1, paving_visit_rec(p, nd->child[1], box, v));
+    }
+}
+
+static paving_visit
+paving_visit_all(const interval_paving *p, interval *out)
+{
+    paving_visit v = { 0, 0, out };
+    interval *box = malloc((p->n ? p->n : 1)*sizeof(interval));
+    if (box == NULL) {
+        v.count = -1;
+        return v;
+    }
+    memcpy(box, p->root, p->n*sizeof(interval));
+    paving_visit_rec(p, 0, box, &v);
+    free(box);
+    return v;
+}
+
+intptr_t
+interval_paving_count(const interval_paving *p)
+{
+    return paving_visit_all(p, NULL).count;
+}
+
+double
+interval_paving_volume(const interval_paving *p)
+{
+    return paving_visit_all(p, NULL).volume;
+}
+
+void
+interval_paving_export(const interval_paving *p, interval *out)
+{
+    paving_visit_all(p, out);
+}
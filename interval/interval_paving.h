@@ -0,0 +1,73 @@
+#ifndef __INTERVAL_PAVING_H__
+#define __INTERVAL_PAVING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * REGULAR SUBPAVINGS
+ *
+ * A set in R^n represented as a binary k-d tree over a fixed root box.
+ * Every node splits its box at the midpoint of its widest side (the
+ * first one on ties), so the split of a node only depends on its box and
+ * two pavings over the same root line up node for node.  Leaves are
+ * either in or out of the set.
+ *
+ * The tree is kept canonical: siblings that are both in (or both out)
+ * are merged into their parent as soon as they appear, so a set is
+ * stored with the fewest boxes this bisection scheme allows.  Nodes
+ * freed by merging are reused by later insertions; interval_paving_compact
+ * also returns the memory.
+*/
+#define INTERVAL_PAVING_OUT   0
+#define INTERVAL_PAVING_IN    1
+#define INTERVAL_PAVING_SPLIT 2
+
+typedef struct {
+    int8_t state;
+    intptr_t child[2];      // SPLIT nodes only; free nodes chain through child[0]
+} interval_paving_node;
+
+typedef struct {
+    intptr_t n;
+    interval *root;         // n intervals
+    intptr_t num_nodes, capacity, free_list;
+    interval_paving_node *nodes;   // node 0 is the root
+} interval_paving;
+
+// An empty paving over root (n intervals), or NULL when out of memory.
+interval_paving *interval_paving_new(intptr_t n, const interval *root);
+void interval_paving_free(interval_paving *p);
+
+// Add count boxes (count x n) to the set.  Nodes narrower than eps in
+// every side are not split; with outer they are put in the set when a
+// box covers part of them (an outer approximation of the union),
+// otherwise only when a box covers them completely (an inner one).
+// Parts of boxes outside the root box are ignored.  Returns 0, -1 when
+// out of memory, or -2 when eps is not positive and finite.
+int interval_paving_insert(interval_paving *p, const interval *boxes, intptr_t count,
+                           double eps, int outer);
+
+// The union or intersection of two pavings over the same root box, or
+// NULL when out of memory.
+interval_paving *interval_paving_union(const interval_paving *a, const interval_paving *b);
+interval_paving *interval_paving_intersection(const interval_paving *a, const interval_paving *b);
+
+// Number of boxes in the set, their total volume, and the boxes
+// themselves (interval_paving_count(p) x n, depth-first order).
+intptr_t interval_paving_count(const interval_paving *p);
+double interval_paving_volume(const interval_paving *p);
+void interval_paving_export(const interval_paving *p, interval *out);
+
+// Repack the nodes without free slots; returns 0, or -1 when out of memory.
+int interval_paving_compact(interval_paving *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
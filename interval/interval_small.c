@@ -0,0 +1,488 @@
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "interval_small.h"
+#include "interval_parallel.h"
+
+// Entries of the products (or eliminations) per thread below which a
+// batch is not split up.
+#define SMALL_GRAIN_TERMS 16384
+
+#define AT(p, s, t, i, j) (*(const interval *)((p) + (i)*(s) + (j)*(t)))
+
+/**
+ * PRODUCTS
+*/
+
+#define SMALL_PRODUCTS(N)                                                    \
+    static void                                                              \
+    small_matmul_##N(const char *a, intptr_t a_m, intptr_t a_n,              \
+                     const char *b, intptr_t b_n, intptr_t b_p,              \
+                     char *c, intptr_t c_m, intptr_t c_p)                    \
+    {                                                                        \
+        interval A[N][N], B[N][N];                                           \
+        int i, j, k;                                                         \
+        for (i = 0; i < N; i++) {                                            \
+            for (j = 0; j < N; j++) {                                        \
+                A[i][j] = AT(a, a_m, a_n, i, j);                             \
+                B[i][j] = AT(b, b_n, b_p, i, j);                             \
+            }                                                                \
+        }                                                                    \
+        for (i = 0; i < N; i++) {                                            \
+            for (j = 0; j < N; j++) {                                        \
+                interval r = { 0, 0 };                                       \
+                for (k = 0; k < N; k++) {                                    \
+                    r = interval_add(r, interval_multiply_sign(A[i][k], B[k][j])); \
+                }                                                            \
+                *(interval *)(c + i*c_m + j*c_p) = r;                        \
+            }                                                                \
+        }                                                                    \
+    }                                                                        \
+    static void                                                              \
+    small_matvec_##N(const char *a, intptr_t a_m, intptr_t a_n,              \
+                     const char *x, intptr_t x_n, char *y, intptr_t y_m)     \
+    {                                                                        \
+        interval X[N];                                                       \
+        int i, k;                                                            \
+        for (k = 0; k < N; k++) {                                            \
+            X[k] = *(const interval *)(x + k*x_n);                           \
+        }                                                                    \
+        for (i = 0; i < N; i++) {                                            \
+            interval r = { 0, 0 };                                           \
+            for (k = 0; k < N; k++) {                                        \
+                r = interval_add(r, interval_multiply_sign(AT(a, a_m, a_n, i, k), X[k])); \
+            }                                                                \
+            *(interval *)(y + i*y_m) = r;                                    \
+        }                                                                    \
+    }
+SMALL_PRODUCTS(2)
+SMALL_PRODUCTS(3)
+SMALL_PRODUCTS(4)
+SMALL_PRODUCTS(5)
+SMALL_PRODUCTS(6)
+SMALL_PRODUCTS(7)
+SMALL_PRODUCTS(8)
+
+static interval_small_matmul_fn *const small_matmul[INTERVAL_SMALL_MAX + 1] = {
+    NULL, NULL, small_matmul_2, small_matmul_3, small_matmul_4, small_matmul_5,
+    small_matmul_6, small_matmul_7, small_matmul_8
+};
+static interval_small_matvec_fn *const small_matvec[INTERVAL_SMALL_MAX + 1] = {
+    NULL, NULL, small_matvec_2, small_matvec_3, small_matvec_4, small_matvec_5,
+    small_matvec_6, small_matvec_7, small_matvec_8
+};
+
+interval_small_matmul_fn *
+interval_small_matmul(intptr_t n)
+{
+    return n >= INTERVAL_SMALL_MIN && n <= INTERVAL_SMALL_MAX ? small_matmul[n] : NULL;
+}
+
+interval_small_matvec_fn *
+interval_small_matvec(intptr_t n)
+{
+    return n >= INTERVAL_SMALL_MIN && n <= INTERVAL_SMALL_MAX ? small_matvec[n] : NULL;
+}
+
+/**
+ * ELIMINATION
+ *
+ * Interval elimination on A directly widens quickly with n, so A is
+ * first preconditioned with the inverse C of its midpoint matrix: the
+ * inverse is (C A)^-1 C and the determinant det(C A)/det(C), with C A
+ * close to the identity.  C is computed in floats, and only needs to be
+ * close to the inverse; without C (a singular midpoint matrix) A is
+ * eliminated as is.  Interval arithmetic rounds to nearest, so every
+ * operation below, det(C) included, is widened outward by one ulp on
+ * each side, which covers its rounding.
+ *
+ * The bodies take n as an argument and are inlined into a copy per size,
+ * where n is a constant.  Their scratch is n^2 intervals P and 2 n^2
+ * doubles C, W.
+*/
+
+// x widened by at least half an ulp on each side (which bounds the
+// rounding of the operation that made it), inline rather than through
+// nextafter: |x| DBL_EPSILON is at least an ulp of x, and SMALL_TINY one
+// of a subnormal.  An infinite bound, where this gives NaN, is kept.
+#define SMALL_TINY 4.9406564584124654e-324
+
+static inline interval
+small_outward(interval x)
+{
+    double l = x.l - (fabs(x.l)*DBL_EPSILON + SMALL_TINY);
+    double u = x.u + (fabs(x.u)*DBL_EPSILON + SMALL_TINY);
+    return (interval) { l < x.l ? l : x.l, u > x.u ? u : x.u };
+}
+
+// Operations with an exact [0, 0] operand are exact and not widened:
+// this keeps the zeros of the identity and of eliminated columns, which
+// would otherwise fill up with subnormals that are slow to compute with.
+static inline int
+small_zero(interval x)
+{
+    return x.l == 0 && x.u == 0;
+}
+
+static inline interval
+small_add(interval a, interval b)
+{
+    interval r = interval_add(a, b);
+    return small_zero(a) || small_zero(b) ? r : small_outward(r);
+}
+
+static inline interval
+small_sub(interval a, interval b)
+{
+    interval r = interval_subtract(a, b);
+    return small_zero(a) || small_zero(b) ? r : small_outward(r);
+}
+
+static inline interval
+small_mul(interval a, interval b)
+{
+    interval r = interval_multiply(a, b);
+    return small_zero(a) || small_zero(b) ? r : small_outward(r);
+}
+
+static inline interval
+small_inverse(interval a)
+{
+    return small_outward(interval_inverse(a));
+}
+
+static inline double
+small_mig(interval x)
+{
+    return x.l > 0 ? x.l : x.u < 0 ? -x.u : 0;
+}
+
+// Row of M (n x n) holding the pivot of column k, from rows k on, or -1
+// if every candidate contains 0.
+static inline intptr_t
+small_pivot(intptr_t n, const interval *M, intptr_t k)
+{
+    intptr_t i, p = -1;
+    double best = 0;
+    for (i = k; i < n; i++) {
+        double m = small_mig(M[i*n + k]);
+        if (m > best) {
+            best = m;
+            p = i;
+        }
+    }
+    return p;
+}
+
+static inline void
+small_swap_rows(intptr_t n, interval *M, intptr_t i, intptr_t j)
+{
+    intptr_t c;
+    for (c = 0; c < n; c++) {
+        interval t = M[i*n + c];
+        M[i*n + c] = M[j*n + c];
+        M[j*n + c] = t;
+    }
+}
+
+// C = inverse of the midpoint matrix of M by Gauss-Jordan elimination
+// with partial pivoting in W; 0 if a pivot vanished.
+static inline int
+small_mid_inverse(intptr_t n, const interval *M, double *C, double *W)
+{
+    intptr_t i, j, k;
+    for (i = 0; i < n*n; i++) {
+        W[i] = 0.5*M[i].l + 0.5*M[i].u;
+        C[i] = 0;
+    }
+    for (i = 0; i < n; i++) {
+        C[i*n + i] = 1;
+    }
+    for (k = 0; k < n; k++) {
+        intptr_t p = k;
+        double inv;
+        for (i = k + 1; i < n; i++) {
+            if (fabs(W[i*n + k]) > fabs(W[p*n + k])) {
+                p = i;
+            }
+        }
+        if (!(W[p*n + k] != 0 && isfinite(W[p*n + k]))) {
+            return 0;
+        }
+        for (j = 0; p != k && j < n; j++) {
+            double t = W[p*n + j];
+            W[p*n + j] = W[k*n + j];
+            W[k*n + j] = t;
+            t = C[p*n + j];
+            C[p*n + j] = C[k*n + j];
+            C[k*n + j] = t;
+        }
+        inv = 1/W[k*n + k];
+        for (j = 0; j < n; j++) {
+            W[k*n + j] *= inv;
+            C[k*n + j] *= inv;
+        }
+        for (i = 0; i < n; i++) {
+            double f = W[i*n + k];
+            if (i == k) {
+                continue;
+            }
+            for (j = 0; j < n; j++) {
+                W[i*n + j] -= f*W[k*n + j];
+                C[i*n + j] -= f*C[k*n + j];
+            }
+        }
+    }
+    return 1;
+}
+
+// P = C @ M, for a point C.
+static inline void
+small_precondition(intptr_t n, const double *C, const interval *M, interval *P)
+{
+    intptr_t i, j, k;
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            interval r = { 0, 0 };
+            for (k = 0; k < n; k++) {
+                r = small_add(r, small_mul((interval) { C[i*n + k], C[i*n + k] }, M[k*n + j]));
+            }
+            P[i*n + j] = r;
+        }
+    }
+}
+
+// det of M by interval Gaussian elimination, destroying M.
+static inline interval
+small_det_eliminate(intptr_t n, interval *M)
+{
+    interval det = { 1, 1 };
+    intptr_t i, j, k;
+    for (k = 0; k < n; k++) {
+        intptr_t p = small_pivot(n, M, k);
+        interval inv;
+        if (p < 0) {
+            return (interval) { -INFINITY, INFINITY };
+        }
+        if (p != k) {
+            small_swap_rows(n, M, p, k);
+            det = interval_negative(det);
+        }
+        det = small_mul(det, M[k*n + k]);
+        inv = small_inverse(M[k*n + k]);
+        for (i = k + 1; i < n; i++) {
+            interval f = small_mul(M[i*n + k], inv);
+            for (j = k + 1; j < n; j++) {
+                M[i*n + j] = small_sub(M[i*n + j], small_mul(f, M[k*n + j]));
+            }
+        }
+    }
+    return det;
+}
+
+// X = inverse of M by interval Gauss-Jordan elimination, destroying M.
+static inline void
+small_inv_eliminate(intptr_t n, interval *M, interval *X)
+{
+    intptr_t i, j, k;
+    for (i = 0; i < n*n; i++) {
+        X[i] = (interval) { 0, 0 };
+    }
+    for (i = 0; i < n; i++) {
+        X[i*n + i] = (interval) { 1, 1 };
+    }
+    for (k = 0; k < n; k++) {
+        intptr_t p = small_pivot(n, M, k);
+        interval inv;
+        if (p < 0) {
+            for (i = 0; i < n*n; i++) {
+                X[i] = (interval) { -INFINITY, INFINITY };
+            }
+            return;
+        }
+        if (p != k) {
+            small_swap_rows(n, M, p, k);
+            small_swap_rows(n, X, p, k);
+        }
+        inv = small_inverse(M[k*n + k]);
+        for (j = k + 1; j < n; j++) {
+            M[k*n + j] = small_mul(M[k*n + j], inv);
+        }
+        for (j = 0; j < n; j++) {
+            X[k*n + j] = small_mul(X[k*n + j], inv);
+        }
+        for (i = 0; i < n; i++) {
+            interval f = M[i*n + k];
+            if (i == k) {
+                continue;
+            }
+            for (j = k + 1; j < n; j++) {
+                M[i*n + j] = small_sub(M[i*n + j], small_mul(f, M[k*n + j]));
+            }
+            for (j = 0; j < n; j++) {
+                X[i*n + j] = small_sub(X[i*n + j], small_mul(f, X[k*n + j]));
+            }
+        }
+    }
+}
+
+static inline interval
+small_det_body(intptr_t n, const interval *A, interval *P, double *C, double *W)
+{
+    const interval *M = A;
+    intptr_t i;
+    if (n == 1) {
+        return M[0];
+    }
+    if (n == 2) {
+        return small_sub(small_mul(M[0], M[3]), small_mul(M[1], M[2]));
+    }
+    if (n == 3) {
+        interval c0 = small_sub(small_mul(M[4], M[8]), small_mul(M[5], M[7]));
+        interval c1 = small_sub(small_mul(M[3], M[8]), small_mul(M[5], M[6]));
+        interval c2 = small_sub(small_mul(M[3], M[7]), small_mul(M[4], M[6]));
+        return small_add(small_sub(small_mul(M[0], c0), small_mul(M[1], c1)), small_mul(M[2], c2));
+    }
+    if (small_mid_inverse(n, A, C, W)) {
+        interval d;
+        small_precondition(n, C, A, P);
+        d = small_det_eliminate(n, P);
+        for (i = 0; i < n*n; i++) {
+            P[i] = (interval) { C[i], C[i] };
+        }
+        return small_mul(d, small_inverse(small_det_eliminate(n, P)));
+    }
+    memcpy(P, A, n*n*sizeof(interval));
+    return small_det_eliminate(n, P);
+}
+
+static inline void
+small_inv_body(intptr_t n, const interval *A, interval *X, interval *P, double *C, double *W)
+{
+    intptr_t i, j, k;
+    if (!small_mid_inverse(n, A, C, W)) {
+        memcpy(P, A, n*n*sizeof(interval));
+        small_inv_eliminate(n, P, X);
+        return;
+    }
+    small_precondition(n, C, A, P);
+    small_inv_eliminate(n, P, X);
+    // X C, through P.
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            interval r = { 0, 0 };
+            for (k = 0; k < n; k++) {
+                r = small_add(r, small_mul(X[i*n + k], (interval) { C[k*n + j], C[k*n + j] }));
+            }
+            P[i*n + j] = r;
+        }
+    }
+    memcpy(X, P, n*n*sizeof(interval));
+}
+
+#define SMALL_ELIMINATION(N)                                                 \
+    static interval                                                          \
+    small_det_##N(const interval *A)                                         \
+    {                                                                        \
+        interval P[N*N];                                                     \
+        double C[N*N], W[N*N];                                               \
+        return small_det_body(N, A, P, C, W);                                \
+    }                                                                        \
+    static void                                                              \
+    small_inv_##N(const interval *A, interval *X)                            \
+    {                                                                        \
+        interval P[N*N];                                                     \
+        double C[N*N], W[N*N];                                               \
+        small_inv_body(N, A, X, P, C, W);                                    \
+    }
+SMALL_ELIMINATION(1)
+SMALL_ELIMINATION(2)
+SMALL_ELIMINATION(3)
+SMALL_ELIMINATION(4)
+SMALL_ELIMINATION(5)
+SMALL_ELIMINATION(6)
+SMALL_ELIMINATION(7)
+SMALL_ELIMINATION(8)
+
+typedef interval small_det_fn(const interval *A);
+typedef void small_inv_fn(const interval *A, interval *X);
+
+static small_det_fn *const small_det[INTERVAL_SMALL_MAX + 1] = {
+    NULL, small_det_1, small_det_2, small_det_3, small_det_4, small_det_5,
+    small_det_6, small_det_7, small_det_8
+};
+static small_inv_fn *const small_inv[INTERVAL_SMALL_MAX + 1] = {
+    NULL, small_inv_1, small_inv_2, small_inv_3, small_inv_4, small_inv_5,
+    small_inv_6, small_inv_7, small_inv_8
+};
+
+typedef struct {
+    intptr_t n;
+    const interval *A;
+    interval *out;
+    int inverse, failed;
+} small_ctx;
+
+static void
+small_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+    small_ctx *ctx = (small_ctx *)ctx_;
+    intptr_t n = ctx->n, nn = n*n, s;
+    int fixed = n <= INTERVAL_SMALL_MAX;
+    // Sizes without a fixed kernel keep their scratch on the heap.
+    interval *P = NULL;
+    double *C = NULL;
+    if (!fixed) {
+        P = malloc(nn*sizeof(interval));
+        C = malloc(2*nn*sizeof(double));
+        if (P == NULL || C == NULL) {
+            free(P);
+            free(C);
+            ctx->failed = 1;
+            return;
+        }
+    }
+    for (s = start; s < stop; s++) {
+        const interval *A = ctx->A + s*nn;
+        if (ctx->inverse) {
+            if (fixed) {
+                small_inv[n](A, ctx->out + s*nn);
+            } else {
+                small_inv_body(n, A, ctx->out + s*nn, P, C, C + nn);
+            }
+        } else {
+            ctx->out[s] = fixed ? small_det[n](A) : small_det_body(n, A, P, C, C + nn);
+        }
+    }
+    free(P);
+    free(C);
+}
+
+static int
+small_run(intptr_t n, const interval *A, interval *out, intptr_t count, int inverse)
+{
+    small_ctx ctx = { n, A, out, inverse, 0 };
+    if (n < 1) {
+        // The determinant of the 0 x 0 matrix is 1; its inverse is empty.
+        intptr_t s;
+        for (s = 0; s < count && !inverse; s++) {
+            out[s] = (interval) { 1, 1 };
+        }
+        return 0;
+    }
+    interval_parallel_for(count, SMALL_GRAIN_TERMS/(n*n*n + 1) + 1, small_range, &ctx);
+    return ctx.failed ? -1 : 0;
+}
+
+int
+interval_det(intptr_t n, const interval *A, interval *det, intptr_t count)
+{
+    return small_run(n, A, det, count, 0);
+}
+
+int
+interval_inv(intptr_t n, const interval *A, interval *X, intptr_t count)
+{
+    return small_run(n, A, X, count, 1);
+}
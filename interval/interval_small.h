@@ -0,0 +1,57 @@
+#ifndef __INTERVAL_SMALL_H__
+#define __INTERVAL_SMALL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * SMALL MATRICES
+ *
+ * Kernels for n x n interval matrices of fixed size n = 2, ..., 8, each
+ * compiled separately for its n so that the loops unroll and the
+ * operands stay in registers.  Matrices are addressed through byte
+ * strides (rows, then columns) like the matmul gufunc hands them over.
+ * Products sum their terms in the same order as the dot kernels of
+ * numpy_interval.c, with interval_multiply_sign, so they agree with the
+ * generic matmul loop.
+*/
+#define INTERVAL_SMALL_MIN 2
+#define INTERVAL_SMALL_MAX 8
+
+// C = A @ B.
+typedef void interval_small_matmul_fn(const char *a, intptr_t a_m, intptr_t a_n,
+                                      const char *b, intptr_t b_n, intptr_t b_p,
+                                      char *c, intptr_t c_m, intptr_t c_p);
+// y = A @ x.
+typedef void interval_small_matvec_fn(const char *a, intptr_t a_m, intptr_t a_n,
+                                      const char *x, intptr_t x_n, char *y, intptr_t y_m);
+
+// The kernels for size n, or NULL outside [INTERVAL_SMALL_MIN, INTERVAL_SMALL_MAX].
+interval_small_matmul_fn *interval_small_matmul(intptr_t n);
+interval_small_matvec_fn *interval_small_matvec(intptr_t n);
+
+/**
+ * DETERMINANT AND INVERSE
+ *
+ * For count contiguous n x n matrices A, any n (unrolled up to
+ * INTERVAL_SMALL_MAX), spread over threads.  The determinant is
+ * expanded by cofactors for n <= 3 and otherwise taken as the product of
+ * the pivots of Gaussian elimination; the inverse comes from
+ * Gauss-Jordan elimination.  Both pick as pivot the candidate of largest
+ * mignitude, and give [-inf, inf] (every entry, for the inverse) when
+ * all candidates contain 0.  Every operation is widened outward by one
+ * ulp to cover its rounding, so each encloses the determinant (inverse)
+ * of every point matrix in A.  Return 0, or -1 when out of memory.
+*/
+int interval_det(intptr_t n, const interval *A, interval *det, intptr_t count);
+int interval_inv(intptr_t n, const interval *A, interval *X, intptr_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,438 @@
+#include <stdlib.h>
+#include <string.h>
+#include "interval_sort.h"
+
+#define SMALL_QUICKSORT 16
+#define PYA_QS_STACK 128
+
+#define INTERVAL_SWAP(a, b) { interval _tmp = (a); (a) = (b); (b) = _tmp; }
+#define INDEX_SWAP(a, b) { intptr_t _tmp = (a); (a) = (b); (b) = _tmp; }
+
+static int
+interval_depth_limit(intptr_t n)
+{
+    int depth = 0;
+    for (; n > 1; n >>= 1) {
+        depth++;
+    }
+    return 2*depth;
+}
+
+/**
+ * HEAPSORT
+*/
+
+int
+interval_heapsort(interval *start, intptr_t n)
+{
+    interval tmp, *a;
+    intptr_t i, j, l;
+
+    // The arithmetic below needs a one-based array.
+    a = start - 1;
+
+    for (l = n >> 1; l > 0; --l) {
+        tmp = a[l];
+        for (i = l, j = l << 1; j <= n;) {
+            if (j < n && interval_lex_lt(a[j], a[j+1])) {
+                j += 1;
+            }
+            if (interval_lex_lt(tmp, a[j])) {
+                a[i] = a[j];
+                i = j;
+                j += j;
+            } else {
+                break;
+            }
+        }
+        a[i] = tmp;
+    }
+
+    for (; n > 1;) {
+        tmp = a[n];
+        a[n] = a[1];
+        n -= 1;
+        for (i = 1, j = 2; j <= n;) {
+            if (j < n && interval_lex_lt(a[j], a[j+1])) {
+                j++;
+            }
+            if (interval_lex_lt(tmp, a[j])) {
+                a[i] = a[j];
+                i = j;
+                j += j;
+            } else {
+                break;
+            }
+        }
+        a[i] = tmp;
+    }
+    return 0;
+}
+
+int
+interval_aheapsort(const interval *vv, intptr_t *tosort, intptr_t n)
+{
+    intptr_t *a, i, j, l, tmp;
+
+    a = tosort - 1;
+
+    for (l = n >> 1; l > 0; --l) {
+        tmp = a[l];
+        for (i = l, j = l << 1; j <= n;) {
+            if (j < n && interval_lex_lt(vv[a[j]], vv[a[j+1]])) {
+                j += 1;
+            }
+            if (interval_lex_lt(vv[tmp], vv[a[j]])) {
+                a[i] = a[j];
+                i = j;
+                j += j;
+            } else {
+                break;
+            }
+        }
+        a[i] = tmp;
+    }
+
+    for (; n > 1;) {
+        tmp = a[n];
+        a[n] = a[1];
+        n -= 1;
+        for (i = 1, j = 2; j <= n;) {
+            if (j < n && interval_lex_lt(vv[a[j]], vv[a[j+1]])) {
+                j++;
+            }
+            if (interval_lex_lt(vv[tmp], vv[a[j]])) {
+                a[i] = a[j];
+                i = j;
+                j += j;
+            } else {
+                break;
+            }
+        }
+        a[i] = tmp;
+    }
+    return 0;
+}
+
+/**
+ * INTROSORT
+*/
+
+int
+interval_quicksort(interval *start, intptr_t num)
+{
+    interval vp;
+    interval *pl = start;
+    interval *pr = pl + num - 1;
+    interval *stack[PYA_QS_STACK];
+    interval **sptr = stack;
+    interval *pm, *pi, *pj, *pk;
+    int depth[PYA_QS_STACK];
+    int *psdepth = depth;
+    int cdepth = interval_depth_limit(num);
+
+    for (;;) {
+        if (cdepth < 0) {
+            interval_heapsort(pl, pr - pl + 1);
+            goto stack_pop;
+        }
+        while ((pr - pl) > SMALL_QUICKSORT) {
+            // quicksort partition
+            pm = pl + ((pr - pl) >> 1);
+            if (interval_lex_lt(*pm, *pl)) INTERVAL_SWAP(*pm, *pl);
+            if (interval_lex_lt(*pr, *pm)) INTERVAL_SWAP(*pr, *pm);
+            if (interval_lex_lt(*pm, *pl)) INTERVAL_SWAP(*pm, *pl);
+            vp = *pm;
+            pi = pl;
+            pj = pr - 1;
+            INTERVAL_SWAP(*pm, *pj);
+            for (;;) {
+                do { ++pi; } while (interval_lex_lt(*pi, vp));
+                do { --pj; } while (interval_lex_lt(vp, *pj));
+                if (pi >= pj) {
+                    break;
+                }
+                INTERVAL_SWAP(*pi, *pj);
+            }
+            pk = pr - 1;
+            INTERVAL_SWAP(*pi, *pk);
+            // push largest partition on stack
+            if (pi - pl < pr - pi) {
+                *sptr++ = pi + 1;
+                *sptr++ = pr;
+                pr = pi - 1;
+            } else {
+                *sptr++ = pl;
+                *sptr++ = pi - 1;
+                pl = pi + 1;
+            }
+            *psdepth++ = --cdepth;
+        }
+
+        // insertion sort
+        for (pi = pl + 1; pi <= pr; ++pi) {
+            vp = *pi;
+            pj = pi;
+            pk = pi - 1;
+            while (pj > pl && interval_lex_lt(vp, *pk)) {
+                *pj-- = *pk--;
+            }
+            *pj = vp;
+        }
+stack_pop:
+        if (sptr == stack) {
+            break;
+        }
+        pr = *(--sptr);
+        pl = *(--sptr);
+        cdepth = *(--psdepth);
+    }
+    return 0;
+}
+
+int
+interval_aquicksort(const interval *v, intptr_t *tosort, intptr_t num)
+{
+    interval vp;
+    intptr_t *pl = tosort;
+    intptr_t *pr = tosort + num - 1;
+    intptr_t *stack[PYA_QS_STACK];
+    intptr_t **sptr = stack;
+    intptr_t *pm, *pi, *pj, *pk, vi;
+    int depth[PYA_QS_STACK];
+    int *psdepth = depth;
+    int cdepth = interval_depth_limit(num);
+
+    for (;;) {
+        if (cdepth < 0) {
+            interval_aheapsort(v, pl, pr - pl + 1);
+            goto stack_pop;
+        }
+        while ((pr - pl) > SMALL_QUICKSORT) {
+            // quicksort partition
+            pm = pl + ((pr - pl) >> 1);
+            if (interval_lex_lt(v[*pm], v[*pl])) INDEX_SWAP(*pm, *pl);
+            if (interval_lex_lt(v[*pr], v[*pm])) INDEX_SWAP(*pr, *pm);
+            if (interval_lex_lt(v[*pm], v[*pl])) INDEX_SWAP(*pm, *pl);
+            vp = v[*pm];
+            pi = pl;
+            pj = pr - 1;
+            INDEX_SWAP(*pm, *pj);
+            for (;;) {
+                do { ++pi; } while (interval_lex_lt(v[*pi], vp));
+                do { --pj; } while (interval_lex_lt(vp, v[*pj]));
+                if (pi >= pj) {
+                    break;
+                }
+                INDEX_SWAP(*pi, *pj);
+            }
+            pk = pr - 1;
+            INDEX_SWAP(*pi, *pk);
+            // push largest partition on stack
+            if (pi - pl < pr - pi) {
+                *sptr++ = pi + 1;
+                *sptr++ = pr;
+                pr = pi - 1;
+            } else {
+                *sptr++ = pl;
+                *sptr++ = pi - 1;
+                pl = pi + 1;
+            }
+            *psdepth++ = --cdepth;
+        }
+
+        // insertion sort
+        for (pi = pl + 1; pi <= pr; ++pi) {
+            vi = *pi;
+            vp = v[vi];
+            pj = pi;
+            pk = pi - 1;
+            while (pj > pl && interval_lex_lt(vp, v[*pk])) {
+                *pj-- = *pk--;
+            }
+            *pj = vi;
+        }
+stack_pop:
+        if (sptr == stack) {
+            break;
+        }
+        pr = *(--sptr);
+        pl = *(--sptr);
+        cdepth = *(--psdepth);
+    }
+    return 0;
+}
+
+/**
+ * RADIX SORT
+*/
+
+typedef struct {
+    uint64_t key;
+    intptr_t idx;
+} interval_radix_item;
+
+// Map a double onto an unsigned integer with the same ordering, with
+// -0.0 folded onto 0.0 and every NaN mapped past +inf.
+static inline uint64_t
+interval_double_key(double d)
+{
+    uint64_t b;
+    if (d != d) {
+        return UINT64_MAX;
+    }
+    if (d == 0) {
+        d = 0.0;
+    }
+    memcpy(&b, &d, sizeof(b));
+    return (b & 0x8000000000000000ULL) ? ~b : (b | 0x8000000000000000ULL);
+}
+
+// Stable LSD radix pass over all eight bytes of the keys in items,
+// using tmp as scratch.  Bytes on which every key agrees are skipped.
+// The result always ends up back in items.
+static void
+interval_radix_pass(interval_radix_item *items, interval_radix_item *tmp, intptr_t n)
+{
+    intptr_t cnt[8][256];
+    intptr_t i;
+    int b, c;
+    interval_radix_item *src = items, *dst = tmp, *swp;
+
+    memset(cnt, 0, sizeof(cnt));
+    for (i = 0; i < n; i++) {
+        uint64_t k = items[i].key;
+        for (b = 0; b < 8; b++) {
+            cnt[b][(k >> (8*b)) & 0xff]++;
+        }
+    }
+
+    for (b = 0; b < 8; b++) {
+        intptr_t a = 0;
+        uint64_t k0 = (items[0].key >> (8*b)) & 0xff;
+        if (cnt[b][k0] == n) {
+            continue;
+        }
+        for (c = 0; c < 256; c++) {
+            intptr_t t = cnt[b][c];
+            cnt[b][c] = a;
+            a += t;
+        }
+        for (i = 0; i < n; i++) {
+            dst[cnt[b][(src[i].key >> (8*b)) & 0xff]++] = src[i];
+        }
+        swp = src; src = dst; dst = swp;
+    }
+    if (src != items) {
+        memcpy(items, src, n*sizeof(interval_radix_item));
+    }
+}
+
+int
+interval_aradixsort(const interval *v, intptr_t *tosort, intptr_t n)
+{
+    interval_radix_item *items, *tmp;
+    intptr_t i;
+
+    if (n < 2) {
+        return 0;
+    }
+    items = malloc(2*n*sizeof(interval_radix_item));
+    if (items == NULL) {
+        return -1;
+    }
+    tmp = items + n;
+
+    // Secondary key first, then the primary key; LSD passes are stable.
+    for (i = 0; i < n; i++) {
+        items[i].idx = tosort[i];
+        items[i].key = interval_double_key(v[tosort[i]].u);
+    }
+    interval_radix_pass(items, tmp, n);
+    for (i = 0; i < n; i++) {
+        items[i].key = interval_double_key(v[items[i].idx].l);
+    }
+    interval_radix_pass(items, tmp, n);
+
+    for (i = 0; i < n; i++) {
+        tosort[i] = items[i].idx;
+    }
+    free(items);
+    return 0;
+}
+
+int
+interval_radixsort(interval *v, intptr_t n)
+{
+    intptr_t *idx;
+    interval *copy;
+    intptr_t i;
+
+    if (n < 2) {
+        return 0;
+    }
+    idx = malloc(n*sizeof(intptr_t));
+    copy = malloc(n*sizeof(interval));
+    if (idx == NULL || copy == NULL) {
+        free(idx);
+        free(copy);
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        idx[i] = i;
+    }
+    if (interval_aradixsort(v, idx, n) < 0) {
+        free(idx);
+        free(copy);
+        return -1;
+    }
+    memcpy(copy, v, n*sizeof(interval));
+    for (i = 0; i < n; i++) {
+        v[i] = copy[idx[i]];
+    }
+    free(idx);
+    free(copy);
+    return 0;
+}
+
+int
+interval_argsort_key(const interval *v, intptr_t *tosort, intptr_t n, int key)
+{
+    interval_radix_item *items, *tmp;
+    intptr_t i;
+
+    for (i = 0; i < n; i++) {
+        tosort[i] = i;
+    }
+    if (n < 2) {
+        return 0;
+    }
+    if (key != INTERVAL_KEY_LOWER && key != INTERVAL_KEY_UPPER &&
+        key != INTERVAL_KEY_MIDPOINT && key != INTERVAL_KEY_WIDTH) {
+        return -1;
+    }
+    items = malloc(2*n*sizeof(interval_radix_item));
+    if (items == NULL) {
+        return -1;
+    }
+    tmp = items + n;
+
+    for (i = 0; i < n; i++) {
+        double k;
+        switch (key) {
+            case INTERVAL_KEY_LOWER:    k = v[i].l; break;
+            case INTERVAL_KEY_UPPER:    k = v[i].u; break;
+            case INTERVAL_KEY_MIDPOINT: k = (v[i].l + v[i].u)/2; break;
+            default:                    k = interval_norm(v[i]); break;
+        }
+        items[i].idx = i;
+        items[i].key = interval_double_key(k);
+    }
+    interval_radix_pass(items, tmp, n);
+
+    for (i = 0; i < n; i++) {
+        tosort[i] = items[i].idx;
+    }
+    free(items);
+    return 0;
+}
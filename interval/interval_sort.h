@@ -0,0 +1,67 @@
+#ifndef __INTERVAL_SORT_H__
+#define __INTERVAL_SORT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * ORDERING
+ *
+ * Intervals are totally ordered lexicographically on (l, u).  Endpoints
+ * compare like numpy floats: -0.0 == 0.0, and NaN sorts after everything
+ * else, so intervals with a NaN lower bound (e.g. empty intersections)
+ * end up at the back of a sorted array.
+*/
+
+static inline int interval_double_lt(double a, double b) {
+    return a < b || (b != b && a == a);
+}
+static inline int interval_lex_lt(interval i1, interval i2) {
+    if (interval_double_lt(i1.l, i2.l)) { return 1; }
+    if (interval_double_lt(i2.l, i1.l)) { return 0; }
+    return interval_double_lt(i1.u, i2.u);
+}
+static inline int interval_compare(interval i1, interval i2) {
+    if (interval_lex_lt(i1, i2)) { return -1; }
+    if (interval_lex_lt(i2, i1)) { return 1; }
+    return 0;
+}
+
+/**
+ * SORT KEYS for interval_argsort_key
+*/
+#define INTERVAL_KEY_LOWER     0
+#define INTERVAL_KEY_UPPER     1
+#define INTERVAL_KEY_MIDPOINT  2
+#define INTERVAL_KEY_WIDTH     3
+
+/**
+ * SORTING
+ *
+ * All functions return 0 on success and -1 if a scratch buffer could not
+ * be allocated.  quicksort is an introsort (median-of-three quicksort,
+ * insertion sort on short runs, heapsort past 2*log2(n) levels).
+ * radixsort is a stable LSD radix sort on the order-preserving integer
+ * image of the endpoint bits, and backs numpy's stable/mergesort kind.
+*/
+int interval_quicksort(interval *v, intptr_t n);
+int interval_heapsort(interval *v, intptr_t n);
+int interval_radixsort(interval *v, intptr_t n);
+
+int interval_aquicksort(const interval *v, intptr_t *tosort, intptr_t n);
+int interval_aheapsort(const interval *v, intptr_t *tosort, intptr_t n);
+int interval_aradixsort(const interval *v, intptr_t *tosort, intptr_t n);
+
+// Stable argsort of n intervals by one of the INTERVAL_KEY_* keys.  The
+// result holds indices 0..n-1 and is written to tosort.
+int interval_argsort_key(const interval *v, intptr_t *tosort, intptr_t n, int key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,51 @@
+#include "interval_sparse.h"
+#include "interval_parallel.h"
+
+// Rows per thread below which a product is not split up, scaled down by
+// the number of right-hand sides.
+#define SPARSE_GRAIN_ENTRIES 4096
+
+typedef struct {
+    intptr_t k;
+    const intptr_t *indptr, *indices;
+    const void *data, *b;
+    interval *out;
+} interval_csr_ctx;
+
+#define CSR_MATMUL(suffix, data_type, b_type, mul)                          \
+static void                                                                 \
+interval_csr_rows_##suffix(void *ctx_, intptr_t start, intptr_t stop)       \
+{                                                                           \
+    const interval_csr_ctx *ctx = (const interval_csr_ctx *)ctx_;           \
+    const data_type *data = (const data_type *)ctx->data;                   \
+    const b_type *b = (const b_type *)ctx->b;                               \
+    intptr_t k = ctx->k, i, p, c;                                           \
+    for (i = start; i < stop; i++) {                                        \
+        interval *row = ctx->out + i*k;                                     \
+        for (c = 0; c < k; c++) {                                           \
+            row[c] = (interval) { 0, 0 };                                   \
+        }                                                                   \
+        for (p = ctx->indptr[i]; p < ctx->indptr[i+1]; p++) {              \
+            const data_type a = data[p];                                    \
+            const b_type *brow = b + ctx->indices[p]*k;                     \
+            for (c = 0; c < k; c++) {                                       \
+                row[c] = interval_add(row[c], mul(a, brow[c]));             \
+            }                                                               \
+        }                                                                   \
+    }                                                                       \
+}                                                                           \
+void                                                                        \
+interval_csr_matmul_##suffix(intptr_t m, intptr_t k, const intptr_t *indptr, \
+                             const intptr_t *indices, const data_type *data, \
+                             const b_type *b, interval *out)                \
+{                                                                           \
+    interval_csr_ctx ctx = { k, indptr, indices, data, b, out };            \
+    intptr_t nnz = m > 0 ? indptr[m] - indptr[0] : 0;                       \
+    intptr_t per_row = (nnz/(m > 0 ? m : 1) + 1)*(k > 0 ? k : 1);           \
+    interval_parallel_for(m, SPARSE_GRAIN_ENTRIES/per_row + 1,              \
+                          interval_csr_rows_##suffix, &ctx);                \
+}
+
+CSR_MATMUL(ii, interval, interval, interval_multiply)
+CSR_MATMUL(di, double, interval, interval_scalar_multiply)
+CSR_MATMUL(id, interval, double, interval_multiply_scalar)
@@ -0,0 +1,36 @@
+#ifndef __INTERVAL_SPARSE_H__
+#define __INTERVAL_SPARSE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "interval.h"
+
+/**
+ * SPARSE PRODUCTS
+ *
+ * out = A B for an m-row CSR matrix A (indptr, indices, data) and a dense
+ * C-contiguous matrix B with k columns (k = 1 for a vector); out is m x k
+ * and C-contiguous.  Column indices are trusted to be in range.
+ *
+ * Every row of out is accumulated over the stored entries of the row in
+ * storage order, independently of the other rows, and rows are split
+ * across threads with interval_parallel_for.  The suffix gives the types
+ * of A and B: _ii interval/interval, _di a float matrix against
+ * intervals (two products per entry instead of four), and _id an
+ * interval matrix against floats.
+*/
+void interval_csr_matmul_ii(intptr_t m, intptr_t k, const intptr_t *indptr, const intptr_t *indices,
+                            const interval *data, const interval *b, interval *out);
+void interval_csr_matmul_di(intptr_t m, intptr_t k, const intptr_t *indptr, const intptr_t *indices,
+                            const double *data, const interval *b, interval *out);
+void interval_csr_matmul_id(intptr_t m, intptr_t k, const intptr_t *indptr, const intptr_t *indices,
+                            const interval *data, const double *b, interval *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,188 @@
+"""Enclosures of the solution sets of interval linear systems.
+
+`solve` encloses {x : Ax = b for some A in [A], b in [b]} for a stack of
+n x n systems at once.  Every system is preconditioned with the inverse
+of its midpoint matrix (computed by LAPACK through numpy.linalg.inv), and
+the preconditioned systems are handed to the native solvers, which run
+in place and split the stack across threads:
+
+    gauss_seidel   interval Gauss-Seidel sweeps, intersected with the box
+    krawczyk       Krawczyk iteration x <- (b' + (I - A')x) & x
+    hansen_bliek   the Hansen-Bliek-Rohn hull of the preconditioned system
+
+The iterative methods start from the box |x| <= ||b'||/(1 - ||I - A'||)
+(or from the given x0 intersected with it) and stop once no component
+contracts by more than tol of its width.
+
+`expm` encloses the matrix exponential exp(A h) of interval matrices, as
+needed to propagate linear time-invariant dynamics over a time step.  It
+scales and squares a Taylor polynomial with a bound on its remainder;
+the products go through the interval matmul kernel and whole stacks of
+matrices (or of step sizes) are spread across threads.
+
+`det` and `inv` enclose determinants and inverses of stacks of interval
+matrices by elimination, with kernels unrolled for sizes up to 8
+(interval_small.h); matmul dispatches to the same unrolled products.
+"""
+
+import numpy
+
+from npinterval.interval.numpy_interval import (interval, precondition, linsolve as _linsolve,
+                                                expm_stack, det_stack, inv_stack)
+
+__all__ = ['solve', 'expm', 'det', 'inv', 'midpoint', 'CONVERGED', 'MAXITER', 'EMPTY', 'FAILED']
+
+# Values of the status array returned by solve(..., return_status=True).
+CONVERGED = 0   # the enclosure stopped contracting
+MAXITER = 1     # maxiter sweeps ran; x is still a valid enclosure
+EMPTY = 2       # x0 contains no solution; x is NaN
+FAILED = 3      # the system could not be verified regular; x is unbounded
+
+_METHODS = {'gauss_seidel' : 0, 'krawczyk' : 1, 'hansen_bliek' : 2}
+
+_lu_dtype = numpy.dtype([('l','=f8'),('u','=f8')])
+
+def _bounds (iarray) :
+    lu = numpy.ascontiguousarray(iarray).view(_lu_dtype)
+    return lu['l'], lu['u']
+
+def midpoint (iarray) :
+    """Midpoints of an interval array, as floats."""
+    l, u = _bounds(iarray)
+    return (l + u)/2
+
+def _inverse (mats) :
+    """Batched inverse; singular (or non-finite) matrices give zeros."""
+    try :
+        with numpy.errstate(all='ignore') :
+            return numpy.linalg.inv(mats)
+    except numpy.linalg.LinAlgError :
+        out = numpy.zeros_like(mats)
+        for k in range(len(mats)) :
+            try :
+                out[k] = numpy.linalg.inv(mats[k])
+            except numpy.linalg.LinAlgError :
+                pass
+        return out
+
+def _comparison (Ap) :
+    """Comparison matrices <A'>: mignitudes on the diagonal, -magnitudes off it."""
+    l, u = _bounds(Ap)
+    mag = numpy.maximum(numpy.abs(l), numpy.abs(u))
+    mig = numpy.where((l <= 0) & (u >= 0), 0.0, numpy.minimum(numpy.abs(l), numpy.abs(u)))
+    cmp = -mag
+    n = Ap.shape[-1]
+    idx = numpy.arange(n)
+    cmp[:, idx, idx] = mig[:, idx, idx]
+    return cmp
+
+def solve (A, b, method='hansen_bliek', x0=None, maxiter=50, tol=1e-10, return_status=False) :
+    """Enclose the solutions of interval linear systems A x = b.
+
+    Parameters
+    ----------
+    A : array_like, shape (..., n, n)
+        Interval (or float) matrices.
+    b : array_like, shape (..., n)
+        Interval (or float) right-hand sides; broadcasts against A.
+    method : {'hansen_bliek', 'gauss_seidel', 'krawczyk'}
+    x0 : array_like, shape (..., n), optional
+        Initial enclosure to intersect with.
+    maxiter : int
+        Maximum number of sweeps of the iterative methods.
+    tol : float
+        Relative contraction below which iteration stops.
+    return_status : bool
+        Also return an int array of CONVERGED/MAXITER/EMPTY/FAILED per system.
+
+    Returns
+    -------
+    x : ndarray of interval, shape (..., n)
+    status : ndarray of int, shape (...), if return_status
+    """
+    if method not in _METHODS :
+        raise ValueError("unknown method %r; expected one of %s" % (method, ', '.join(_METHODS)))
+    A = numpy.asarray(A)
+    b = numpy.asarray(b)
+    if A.dtype != interval :
+        A = A.astype(numpy.float64).astype(interval)
+    if b.dtype != interval :
+        b = b.astype(numpy.float64).astype(interval)
+    if A.ndim < 2 or A.shape[-1] != A.shape[-2] or b.ndim < 1 or b.shape[-1] != A.shape[-1] :
+        raise ValueError("expected A (..., n, n) and b (..., n), got %r and %r" % (A.shape, b.shape))
+    n = A.shape[-1]
+    batch = numpy.broadcast_shapes(A.shape[:-2], b.shape[:-1])
+    A = numpy.ascontiguousarray(numpy.broadcast_to(A, batch + (n, n))).reshape(-1, n, n)
+    b = numpy.ascontiguousarray(numpy.broadcast_to(b, batch + (n,))).reshape(-1, n)
+    if x0 is not None :
+        x0 = numpy.asarray(x0)
+        if x0.dtype != interval :
+            x0 = x0.astype(numpy.float64).astype(interval)
+        x0 = numpy.broadcast_to(x0, batch + (n,)).reshape(-1, n)
+
+    C = _inverse(midpoint(A))
+    Ap, bp = precondition(A, b, C)
+    M = _inverse(_comparison(Ap)) if method == 'hansen_bliek' else None
+    x, status = _linsolve(Ap, bp, x0, _METHODS[method], int(maxiter), float(tol), M)
+
+    x = x.reshape(batch + (n,))
+    if return_status :
+        return x, status.reshape(batch)
+    return x
+
+def expm (A, h=1.0) :
+    """Enclose exp(A h) for interval (or float) matrices A (..., n, n).
+
+    The step h (a float or an array) broadcasts against the stack
+    dimensions of A, so one matrix with an array of step sizes gives the
+    exponentials for a whole time-varying horizon in a single call.
+    Every step is widened outward by a bound on its rounding error, so
+    even a point matrix gives a (narrow) interval result.  Matrices with
+    non-finite entries give unbounded enclosures.
+
+    Returns
+    -------
+    E : ndarray of interval, shape (..., n, n)
+        E contains exp(A h) for every point matrix in A.
+    """
+    A = numpy.asarray(A)
+    if A.dtype != interval :
+        A = A.astype(numpy.float64).astype(interval)
+    if A.ndim < 2 or A.shape[-1] != A.shape[-2] :
+        raise ValueError("expected square matrices A (..., n, n), got %r" % (A.shape,))
+    h = numpy.asarray(h, dtype=numpy.float64)
+    n = A.shape[-1]
+    batch = numpy.broadcast_shapes(A.shape[:-2], h.shape)
+    count = int(numpy.prod(batch))
+    A = numpy.ascontiguousarray(numpy.broadcast_to(A, batch + (n, n))).reshape(count, n, n)
+    h = numpy.ascontiguousarray(numpy.broadcast_to(h, batch)).reshape(count)
+    return expm_stack(A, h).reshape(batch + (n, n))
+
+def _stack (A) :
+    A = numpy.asarray(A)
+    if A.dtype != interval :
+        A = A.astype(numpy.float64).astype(interval)
+    if A.ndim < 2 or A.shape[-1] != A.shape[-2] :
+        raise ValueError("expected square matrices A (..., n, n), got %r" % (A.shape,))
+    n = A.shape[-1]
+    return A.shape[:-2], numpy.ascontiguousarray(A).reshape(int(numpy.prod(A.shape[:-2])), n, n)
+
+def det (A) :
+    """Enclose the determinants of interval (or float) matrices A (..., n, n).
+
+    Returns an interval array of shape (...); [-inf, inf] where
+    elimination met a column with no pivot excluding 0.
+    """
+    batch, A = _stack(A)
+    return det_stack(A).reshape(batch)
+
+def inv (A) :
+    """Enclose the inverses of interval (or float) matrices A (..., n, n).
+
+    Every entry is [-inf, inf] where elimination met a column with no
+    pivot excluding 0 (as for every singular matrix); `solve` with the
+    identity as right-hand side gives tighter enclosures.
+    """
+    batch, A = _stack(A)
+    n = A.shape[-1]
+    return inv_stack(A).reshape(batch + (n, n))
@@ -0,0 +1,74 @@
+#ifndef __MIDRAD_H__
+#define __MIDRAD_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <math.h>
+#include "interval.h"
+
+/**
+ * MIDPOINT-RADIUS INTERVALS
+ *
+ * The set {x : |x - m| <= r}.  Linear operations act on the midpoints
+ * alone plus a nonnegative combination of radii, so products of midrad
+ * matrices come down to float products of midpoint and radius matrices
+ * (see the matmul loop in numpy_interval.c).  Products overestimate the
+ * endpoint product by at most a factor of 1.5 in the radius.
+*/
+typedef struct {
+    double m;
+    double r;
+} midrad;
+
+static inline midrad midrad_from_interval(interval i) {
+    double m = 0.5*i.l + 0.5*i.u;
+    return (midrad) { m, fmax(m - i.l, i.u - m) };
+}
+static inline interval midrad_to_interval(midrad a) {
+    return (interval) { a.m - a.r, a.m + a.r };
+}
+static inline int midrad_nonzero(midrad a) {
+    return a.m != 0 || a.r != 0;
+}
+
+static inline midrad midrad_negative(midrad a) {
+    return (midrad) { -a.m, a.r };
+}
+static inline midrad midrad_add(midrad a, midrad b) {
+    return (midrad) { a.m + b.m, a.r + b.r };
+}
+static inline midrad midrad_add_scalar(midrad a, double s) {
+    return (midrad) { a.m + s, a.r };
+}
+static inline midrad midrad_scalar_add(double s, midrad a) {
+    return (midrad) { s + a.m, a.r };
+}
+static inline midrad midrad_subtract(midrad a, midrad b) {
+    return (midrad) { a.m - b.m, a.r + b.r };
+}
+static inline midrad midrad_subtract_scalar(midrad a, double s) {
+    return (midrad) { a.m - s, a.r };
+}
+static inline midrad midrad_scalar_subtract(double s, midrad a) {
+    return (midrad) { s - a.m, a.r };
+}
+static inline midrad midrad_multiply(midrad a, midrad b) {
+    return (midrad) { a.m*b.m, fabs(a.m)*b.r + a.r*(fabs(b.m) + b.r) };
+}
+static inline midrad midrad_multiply_scalar(midrad a, double s) {
+    return (midrad) { a.m*s, a.r*fabs(s) };
+}
+static inline midrad midrad_scalar_multiply(double s, midrad a) {
+    return (midrad) { s*a.m, fabs(s)*a.r };
+}
+static inline midrad midrad_divide_scalar(midrad a, double s) {
+    return (midrad) { a.m/s, a.r/fabs(s) };
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+"""Interval bound propagation (IBP) through dense neural networks.
+
+A `Dense` layer y = act(W x + b) with float weights W (m, n) and bias b
+(m,) maps a box x to the box of bounds
+
+    y.l = act(W+ x.l + W- x.u + b),    y.u = act(W+ x.u + W- x.l + b),
+
+with W+ = max(W, 0), W- = min(W, 0) and act one of None, 'relu', 'tanh'
+or 'sigmoid'.  The native kernel (interval_nn.h) computes both bounds of
+a whole batch of boxes with a single BLAS product against the sign split
+[W+^T; W-^T], which is prepared once per layer, and applies the bias and
+activation while packing the result:
+
+    net = Network([Dense(W1, b1, 'relu'), Dense(W2, b2, 'tanh')])
+    Y = net(X)      # X (..., n) interval array of input boxes
+
+A `Network` runs all its layers in one native call.  `W @ x + b` and
+the elementwise ufuncs (numpy.relu, numpy.sigmoid, numpy.tanh) bound the
+same layer in several passes over the batch; both sum the same terms,
+but BLAS may round its sums differently, so the bounds agree up to the
+rounding of a few ulps.  Boxes with an infinite bound skip BLAS, where
+a zero weight would give 0*inf = NaN, and are summed natively instead:
+
+>>> from npinterval.interval.nn import Dense
+>>> x = numpy.array([interval(0, numpy.inf), interval(0, 1)])
+>>> Dense([[1, 2], [-1, .5]], [0, 0], 'relu')(x)
+array([([0, inf]), ([0, 0.5])], dtype=interval)
+"""
+
+import numpy
+
+from npinterval.interval.numpy_interval import interval, ibp_dense, ibp_network
+
+__all__ = ['Dense', 'Network']
+
+# Activation codes of interval_nn.h.
+_ACTIVATIONS = {None : 0, 'relu' : 1, 'tanh' : 2, 'sigmoid' : 3}
+
+
+def _boxes (X, n) :
+    X = numpy.asarray(X)
+    if X.dtype != interval :
+        raise TypeError("expected an interval array, got dtype %s" % X.dtype)
+    if X.shape[-1:] != (n,) :
+        raise ValueError("expected boxes of dimension %d, got shape %r" % (n, X.shape))
+    return X.shape[:-1], X.reshape(-1, n)
+
+
+class Dense :
+    """The layer x -> activation(W @ x + b) for float W (m, n) and b (m,)."""
+
+    def __init__ (self, W, b=None, activation=None) :
+        W = numpy.asarray(W, dtype=numpy.float64)
+        if W.ndim != 2 :
+            raise ValueError("expected a 2-d weight matrix, got shape %r" % (W.shape,))
+        if activation not in _ACTIVATIONS :
+            raise ValueError("activation must be one of %s, got %r"
+                             % (', '.join(map(repr, _ACTIVATIONS)), activation))
+        self.W = W
+        self.b = numpy.zeros(W.shape[0]) if b is None else numpy.asarray(b, dtype=numpy.float64)
+        if self.b.shape != (W.shape[0],) :
+            raise ValueError("expected a bias of shape %r, got %r" % ((W.shape[0],), self.b.shape))
+        self.activation = activation
+        self._S = numpy.ascontiguousarray(numpy.concatenate((numpy.maximum(W, 0).T,
+                                                             numpy.minimum(W, 0).T)))
+
+    @property
+    def shape (self) :
+        """(outputs, inputs)."""
+        return self.W.shape
+
+    def _layer (self) :
+        return (self._S, self.b, _ACTIVATIONS[self.activation])
+
+    def __call__ (self, X) :
+        """Bounds of the layer over an (..., n) interval array of boxes."""
+        shape, X = _boxes(X, self.W.shape[1])
+        Y = ibp_dense(X, *self._layer())
+        return Y.reshape(shape + (self.W.shape[0],))
+
+
+class Network :
+    """A sequence of Dense layers (or (W, b, activation) tuples)."""
+
+    def __init__ (self, layers) :
+        self.layers = [l if isinstance(l, Dense) else Dense(*l) for l in layers]
+        if not self.layers :
+            raise ValueError("expected at least one layer")
+        for k in range(1, len(self.layers)) :
+            if self.layers[k].shape[1] != self.layers[k-1].shape[0] :
+                raise ValueError("layer %d takes %d inputs, but layer %d has %d outputs"
+                                 % (k, self.layers[k].shape[1], k-1, self.layers[k-1].shape[0]))
+
+    def __len__ (self) :
+        return len(self.layers)
+
+    def __call__ (self, X) :
+        """Bounds of the network over an (..., n) interval array of boxes."""
+        shape, X = _boxes(X, self.layers[0].shape[1])
+        Y = ibp_network(X, [l._layer() for l in self.layers])
+        return Y.reshape(shape + (self.layers[-1].shape[0],))
@@ -2,10 +2,26 @@
 #include <numpy/arrayobject.h>
 #include <numpy/npy_math.h>
 #include <numpy/ufuncobject.h>
+#include <fenv.h>
+#include <float.h>
 #include <stdio.h>
 #include "structmember.h"
 
 #include "interval.h"
+#include "midrad.h"
+#include "interval_sort.h"
+#include "interval_sparse.h"
+#include "interval_linsolve.h"
+#include "interval_newton.h"
+#include "interval_bvh.h"
+#include "interval_paving.h"
+#include "interval_optimize.h"
+#include "interval_contract.h"
+#include "interval_nn.h"
+#include "interval_small.h"
+#include "interval_parallel.h"
+#define NPINTERVAL_BUILDING_MODULE
+#include "numpy_interval_api.h"
 
 // The following definitions, along with `#define NPY_PY3K 1`, can
 // also be found in the header <numpy/npy_3kcompat.h>.
@@ -31,14 +47,24 @@ static NPY_INLINE int PyInt_Check(PyObject *op) {
     return Py_INCREF(Py_NotImplemented), Py_NotImplemented
 #endif
 
+// NumPy 2 made PyArray_Descr opaque; user dtypes are registered from a
+// PyArray_DescrProto, which has the NumPy 1.x layout.
+#if NPY_ABI_VERSION < 0x02000000
+typedef PyArray_Descr PyArray_DescrProto;
+#endif
+
+// Built against the NumPy 2 API, the ufunc loops are ArrayMethods (NEP
+// 43) with separate contiguous, strided and unaligned variants, and
+// promoters take over the legacy type resolution for mixed operands.
+// Otherwise they are legacy loops for PyUFunc_RegisterLoopForType.
+#if defined(NPY_2_0_API_VERSION) && NPY_FEATURE_VERSION >= NPY_2_0_API_VERSION
+#define INTERVAL_ARRAYMETHOD
+#endif
 
-typedef struct {
-    PyObject_HEAD
-    interval obval;
-} PyInterval;
 
 static PyTypeObject PyInterval_Type;
 
+static PyArray_DescrProto interval_descr_proto;
 PyArray_Descr* interval_descr;
 
 
@@ -93,7 +119,7 @@ pyinterval_init(PyObject *self, PyObject *args, PyObject *kwds)
 
     Py_ssize_t size = PyTuple_Size(args);
     interval* i;
-    PyObject* I = {0};
+    PyObject* obj = {0};
     i = &(((PyInterval*)self)->obval);
 
     if (kwds && PyDict_Size(kwds)) {
@@ -107,9 +133,9 @@ pyinterval_init(PyObject *self, PyObject *args, PyObject *kwds)
     if(size == 0) {
         return 0;
     } else if(size == 1) {
-        if(PyArg_ParseTuple(args, "O", &I) && PyInterval_Check(I)) {
-            i->l = ((PyInterval*)I)->obval.l;
-            i->u = ((PyInterval*)I)->obval.u;
+        if(PyArg_ParseTuple(args, "O", &obj) && PyInterval_Check(obj)) {
+            i->l = ((PyInterval*)obj)->obval.l;
+            i->u = ((PyInterval*)obj)->obval.u;
             return 0;
         } else if(PyArg_ParseTuple(args, "d", &i->l)) {
             i->u = i->l;
@@ -232,7 +258,7 @@ pyinterval_##fake_name##_array_operator(PyObject* a, PyObject* b) {     \
   }                                                                     \
   iternext = NpyIter_GetIterNext(iter, NULL);                           \
   innerstride = NpyIter_GetInnerStrideArray(iter)[0];                   \
-  itemsize = NpyIter_GetDescrArray(iter)[1]->elsize;                    \
+  itemsize = sizeof(interval);                                          \
   innersizeptr = NpyIter_GetInnerLoopSizePtr(iter);                     \
   dataptrarray = NpyIter_GetDataPtrArray(iter);                         \
   if(PyArray_EquivTypes(PyArray_DESCR((PyArrayObject*) b), interval_descr)) { \
@@ -418,8 +444,7 @@ static PyObject *
 pyinterval__reduce(PyInterval* self)
 {
   /* printf("\n\n\nI'm trying, most of all!\n\n\n"); */
-  return Py_BuildValue("O(OO)", Py_TYPE(self),
-                       PyFloat_FromDouble(self->obval.l), PyFloat_FromDouble(self->obval.u));
+  return Py_BuildValue("O(dd)", Py_TYPE(self), self->obval.l, self->obval.u);
 }
 
 static PyObject *
@@ -428,8 +453,7 @@ pyinterval_getstate(PyInterval* self, PyObject* args)
   /* printf("\n\n\nI'm Trying, OKAY?\n\n\n"); */
   if (!PyArg_ParseTuple(args, ":getstate"))
     return NULL;
-  return Py_BuildValue("OO",
-                       PyFloat_FromDouble(self->obval.l), PyFloat_FromDouble(self->obval.u));
+  return Py_BuildValue("dd", self->obval.l, self->obval.u);
 }
 
 static PyObject *
@@ -791,22 +815,28 @@ static PyTypeObject PyInterval_Type = {
 // nonzero, copyswap, copyswapn, setitem, getitem, and cast.
 static PyArray_ArrFuncs _PyInterval_ArrFuncs;
 
+// Byte-swap a single 8-byte word in place.  Used by the copyswap
+// functions below, which must not touch the Python API since numpy
+// calls them with the GIL released.
+static NPY_INLINE void
+interval_byteswap8(char *p)
+{
+  char t;
+  t = p[0]; p[0] = p[7]; p[7] = t;
+  t = p[1]; p[1] = p[6]; p[6] = t;
+  t = p[2]; p[2] = p[5]; p[5] = t;
+  t = p[3]; p[3] = p[4]; p[4] = t;
+}
+
 static npy_bool
 INTERVAL_nonzero (char *ip, PyArrayObject *ap)
 {
   interval q;
-  interval zero = {0,0};
-  if (ap == NULL || PyArray_ISBEHAVED_RO(ap)) {
-    q = *(interval *)ip;
-  }
-  else {
-    PyArray_Descr *descr;
-    descr = PyArray_DescrFromType(NPY_DOUBLE);
-    descr->f->copyswap(&q.l, ip, !PyArray_ISNOTSWAPPED(ap), NULL);
-    descr->f->copyswap(&q.u, ip+8, !PyArray_ISNOTSWAPPED(ap), NULL);
-    Py_DECREF(descr);
-  }
-  // return (npy_bool) !interval_equal(q, zero);
+  memcpy(&q, ip, sizeof(interval));
+  if (ap != NULL && !PyArray_ISNOTSWAPPED(ap)) {
+    interval_byteswap8((char *)&q.l);
+    interval_byteswap8((char *)&q.u);
+  }
   return (npy_bool) interval_nonzero(q);
 }
 
@@ -814,10 +844,13 @@ static void
 INTERVAL_copyswap(interval *dst, interval *src,
                     int swap, void *NPY_UNUSED(arr))
 {
-  PyArray_Descr *descr;
-  descr = PyArray_DescrFromType(NPY_DOUBLE);
-  descr->f->copyswapn(dst, sizeof(double), src, sizeof(double), 2, swap, NULL);
-  Py_DECREF(descr);
+  if (src != NULL) {
+    memcpy(dst, src, sizeof(interval));
+  }
+  if (swap) {
+    interval_byteswap8((char *)&dst->l);
+    interval_byteswap8((char *)&dst->u);
+  }
 }
 
 static void
@@ -825,11 +858,26 @@ INTERVAL_copyswapn(interval *dst, npy_intp dstride,
                      interval *src, npy_intp sstride,
                      npy_intp n, int swap, void *NPY_UNUSED(arr))
 {
-  PyArray_Descr *descr;
-  descr = PyArray_DescrFromType(NPY_DOUBLE);
-  descr->f->copyswapn(&dst->l, dstride, &src->l, sstride, n, swap, NULL);
-  descr->f->copyswapn(&dst->u, dstride, &src->u, sstride, n, swap, NULL);
-  Py_DECREF(descr);
+  char *d = (char *)dst;
+  npy_intp i;
+  if (src != NULL) {
+    const char *s = (const char *)src;
+    if (dstride == sizeof(interval) && sstride == sizeof(interval)) {
+      // Contiguous runs go through a single memmove.
+      memmove(d, s, n*sizeof(interval));
+    } else {
+      for (i = 0; i < n; i++, d += dstride, s += sstride) {
+        memmove(d, s, sizeof(interval));
+      }
+      d = (char *)dst;
+    }
+  }
+  if (swap) {
+    for (i = 0; i < n; i++, d += dstride) {
+      interval_byteswap8(d);
+      interval_byteswap8(d + sizeof(double));
+    }
+  }
 }
 
 static int INTERVAL_setitem(PyObject* item, interval* qp, void* NPY_UNUSED(ap))
@@ -882,74 +930,178 @@ INTERVAL_fillwithscalar(interval *buffer, npy_intp length, interval *value, void
     buffer[i] = val;
   }
 }
+static int
+INTERVAL_compare(const interval *pa, const interval *pb, void *NPY_UNUSED(ap))
+{
+  interval a, b;
+  memcpy(&a, pa, sizeof(interval));
+  memcpy(&b, pb, sizeof(interval));
+  return interval_compare(a, b);
+}
+
+// argmax and argmin follow the lexicographic (l, u) order of
+// INTERVAL_compare; like the float versions, the first interval with a
+// NaN endpoint wins.
+static int
+INTERVAL_argmax(interval *ip, npy_intp n, npy_intp *max_ind, void *NPY_UNUSED(ap))
+{
+  npy_intp i;
+  interval mp = ip[0];
+  *max_ind = 0;
+  if (npy_isnan(mp.l) || npy_isnan(mp.u)) {
+    return 0;
+  }
+  for (i = 1; i < n; i++) {
+    if (npy_isnan(ip[i].l) || npy_isnan(ip[i].u)) {
+      *max_ind = i;
+      return 0;
+    }
+    if (interval_lex_lt(mp, ip[i])) {
+      mp = ip[i];
+      *max_ind = i;
+    }
+  }
+  return 0;
+}
+
+static int
+INTERVAL_argmin(interval *ip, npy_intp n, npy_intp *min_ind, void *NPY_UNUSED(ap))
+{
+  npy_intp i;
+  interval mp = ip[0];
+  *min_ind = 0;
+  if (npy_isnan(mp.l) || npy_isnan(mp.u)) {
+    return 0;
+  }
+  for (i = 1; i < n; i++) {
+    if (npy_isnan(ip[i].l) || npy_isnan(ip[i].u)) {
+      *min_ind = i;
+      return 0;
+    }
+    if (interval_lex_lt(ip[i], mp)) {
+      mp = ip[i];
+      *min_ind = i;
+    }
+  }
+  return 0;
+}
+
+// Sorting entry points for the quicksort, heapsort, and stable
+// (mergesort) kinds.  The stable kind is an LSD radix sort.
+#define SORT_ARRFUNC(kind)                                              \
+  static int                                                            \
+  INTERVAL_##kind(void *start, npy_intp n, void *NPY_UNUSED(ap))       \
+  {                                                                     \
+    return interval_##kind((interval *)start, n);                       \
+  }                                                                     \
+  static int                                                            \
+  INTERVAL_a##kind(void *vv, npy_intp *tosort, npy_intp n, void *NPY_UNUSED(ap)) \
+  {                                                                     \
+    return interval_a##kind((interval *)vv, tosort, n);                 \
+  }
+SORT_ARRFUNC(quicksort)
+SORT_ARRFUNC(heapsort)
+SORT_ARRFUNC(radixsort)
+
+// Dot product kernels.  All of them sum the terms a_i*x_i in order and
+// only differ in how a term is formed:
+//
+//   four   interval_multiply, the min/max of all four endpoint products
+//   sign   interval_multiply_sign, two products per bound picked by the
+//          signs of a_i's endpoints, without branches
+//   point  a_i (or x_i) is degenerate, so a term is a scalar times an
+//          interval: two products, ordered by the sign of the scalar
+//
+// The kernel is chosen with set_dot_kernel().  Under 'auto' (the default)
+// each product checks whether one operand is a point matrix/vector and
+// otherwise uses INTERVAL_DOT_GENERAL; benchmarks/dot_kernels.py times
+// every kernel per input class and is what picked these defaults.
+#define INTERVAL_DOT_AUTO 0
+#define INTERVAL_DOT_FOUR 1
+#define INTERVAL_DOT_SIGN 2
+#define INTERVAL_DOT_GENERAL INTERVAL_DOT_SIGN
+
+static const char *interval_dot_names[] = { "auto", "four", "sign" };
+static int interval_dot_choice = INTERVAL_DOT_AUTO;
+
+typedef void interval_dot_kernel(const char *ip0, npy_intp is0, const char *ip1,
+                                 npy_intp is1, interval *op, npy_intp n);
+
+#define DOT_KERNEL(name, term)                                          \
+  static void                                                           \
+  interval_dot_##name(const char *ip0, npy_intp is0, const char *ip1,   \
+                      npy_intp is1, interval *op, npy_intp n)           \
+  {                                                                     \
+    interval r = {0, 0};                                                \
+    npy_intp i;                                                         \
+    for (i = 0; i < n; i++) {                                           \
+      const interval a = *(const interval *)ip0;                        \
+      const interval x = *(const interval *)ip1;                        \
+      r = interval_add(r, term);                                        \
+      ip0 += is0;                                                       \
+      ip1 += is1;                                                       \
+    }                                                                   \
+    *op = r;                                                            \
+  }
+DOT_KERNEL(four, interval_multiply(a, x))
+DOT_KERNEL(sign, interval_multiply_sign(a, x))
+DOT_KERNEL(point0, interval_scalar_multiply(a.l, x))
+DOT_KERNEL(point1, interval_multiply_scalar(a, x.l))
+
+// Whether all n intervals at stride s are degenerate.
+static int
+interval_strided_is_point(const char *ip, npy_intp s, npy_intp n)
+{
+  npy_intp i;
+  for (i = 0; i < n; i++, ip += s) {
+    if (((const interval *)ip)->l != ((const interval *)ip)->u) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Whether the m x n intervals at strides (sm, sn) are all degenerate.
+static int
+interval_strided_is_point_2d(const char *ip, npy_intp sm, npy_intp sn, npy_intp m, npy_intp n)
+{
+  npy_intp i;
+  for (i = 0; i < m; i++, ip += sm) {
+    if (!interval_strided_is_point(ip, sn, n)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// The kernel for a product whose left/right operands are (not) points.
+static interval_dot_kernel *
+interval_dot_select(int point0, int point1)
+{
+  switch (interval_dot_choice) {
+    case INTERVAL_DOT_FOUR: return interval_dot_four;
+    case INTERVAL_DOT_SIGN: return interval_dot_sign;
+  }
+  if (point0) {
+    return interval_dot_point0;
+  }
+  if (point1) {
+    return interval_dot_point1;
+  }
+  return INTERVAL_DOT_GENERAL == INTERVAL_DOT_FOUR ? interval_dot_four : interval_dot_sign;
+}
+
 static void
 INTERVAL_dot(void* ip0_, npy_intp is0, void* ip1_, npy_intp is1,
-        void* op, npy_intp n, void* arr) {
-    interval r = {0};
+        void* op, npy_intp n, void* NPY_UNUSED(arr)) {
     const char *ip0 = (char*)ip0_, *ip1 = (char*)ip1_;
-    npy_intp i;
-    for (i = 0; i < n; i++) {
-        r = interval_add(r,interval_multiply(*(interval*)ip0,*(interval*)ip1));
-        ip0 += is0;
-        ip1 += is1;
-    }
-    *(interval*)op = r;
-}
-// static void
-// INTERVAL_dot(void* ip0_, npy_intp is0, void* ip1_, npy_intp is1,
-//         void* op, npy_intp n, void* arr) {
-//     interval r1 = {0,0};
-//     interval r2 = {0,0};
-//     const char *ip0 = (char*)ip0_, *ip1 = (char*)ip1_;
-//     npy_intp i;
-//     for (i = 0; i < n; i++) {
-//         // r = interval_add(r,interval_multiply(*(interval*)ip0,*(interval*)ip1));
-//         interval ai = *(interval*)ip0;
-//         interval xi = *(interval*)ip1;
-//         r1.l += (ai.l>0) ? ai.l*xi.l : ai.l*xi.u;
-//         r1.u += (ai.u>0) ? ai.u*xi.u : ai.u*xi.l;
-//         r2.l += (xi.l>0) ? xi.l*ai.l : xi.l*ai.u;
-//         r2.u += (xi.u>0) ? xi.u*ai.u : xi.u*ai.l;
-//         ip0 += is0;
-//         ip1 += is1;
-//     }
-//     *(interval*)op = interval_intersection(r1, r2);
-//     // *(interval*)op = r1;
-// }
-// static void
-// INTERVAL_dot(void* ip0_, npy_intp is0, void* ip1_, npy_intp is1,
-//         void* op, npy_intp n, void* arr) {
-//     interval r = {0,0};
-//     const char *ip0 = (char*)ip0_, *ip1 = (char*)ip1_;
-//     npy_intp i;
-//     for (i = 0; i < n; i++) {
-//         // r = interval_add(r,interval_multiply(*(interval*)ip0,*(interval*)ip1));
-//         interval ai = *(interval*)ip0;
-//         interval xi = *(interval*)ip1;
-//         if        (ai.l > 0 && xi.l > 0){
-//           r.l += ai.l*xi.l;
-//         } else if (ai.u > 0 && xi.l < 0) {
-//           r.l += ai.u*xi.l;
-//         } else if (ai.l < 0 && xi.u > 0) {
-//           r.l += ai.l*xi.u;
-//         } else if (ai.u < 0 && xi.u < 0) {
-//           r.l += ai.u*ai.u;
-//         }
-//         if        (ai.u > 0 && xi.u > 0) {
-//           r.u += ai.u*xi.u;
-//         } else if (ai.l > 0 && xi.u < 0) {
-//           r.u += ai.l*xi.u;
-//         } else if (ai.u < 0 && xi.l > 0) {
-//           r.u += ai.u*xi.l;
-//         } else if (ai.l < 0 && xi.l < 0) {
-//           r.u += ai.l*xi.l;
-//         }
-//         ip0 += is0;
-//         ip1 += is1;
-//     }
-//     // *(interval*)op = interval_intersection(r1, r2);
-//     *(interval*)op = r;
-// }
+    int point0 = 0, point1 = 0;
+    if (interval_dot_choice == INTERVAL_DOT_AUTO) {
+        point0 = interval_strided_is_point(ip0, is0, n);
+        point1 = !point0 && interval_strided_is_point(ip1, is1, n);
+    }
+    interval_dot_select(point0, point1)(ip0, is0, ip1, is1, (interval*)op, n);
+}
 
 // This is a macro (followed by applications of the macro) that cast
 // the input types to standard intervals with only a nonzero scalar
@@ -990,96 +1142,602 @@ static void register_cast_function(int sourceType, int destType, PyArray_VectorU
 }
 
 
+// Ufunc inner loops over many elements are split across the thread pool
+// of interval_parallel.h, each thread running the serial loop on its own
+// range of the (possibly strided) operands.  Every element is still
+// computed on its own by the same kernel, so results do not depend on the
+// number of threads.  Reductions and accumulations, whose elements chain
+// through the output, always run serially.  Floating point exceptions
+// raised on the workers are collected and raised again on the calling
+// thread, where numpy checks them.  A loop is only split when every
+// thread gets at least its grain of elements; the grains reflect the
+// cost of a kernel, from memory-bound sums to transcendental functions.
+#define INTERVAL_GRAIN_CHEAP (1 << 16)
+#define INTERVAL_GRAIN_MULTIPLY (1 << 14)
+#define INTERVAL_GRAIN_TRANSCENDENTAL (1 << 11)
+
+typedef void interval_ufunc_loop(char **args, npy_intp *dimensions, npy_intp *steps, void *data);
+
+typedef struct {
+  interval_ufunc_loop *loop;
+  char **args;
+  npy_intp *steps;
+  void *data;
+  int nargs;
+  int fpe;
+} interval_ufunc_split;
+
+static void
+interval_ufunc_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+  interval_ufunc_split *ctx = (interval_ufunc_split *)ctx_;
+  char *args[4];
+  npy_intp n = stop - start;
+  int k, fpe;
+  for (k = 0; k < ctx->nargs; k++) {
+    args[k] = ctx->args[k] + start*ctx->steps[k];
+  }
+  feclearexcept(FE_ALL_EXCEPT);
+  ctx->loop(args, &n, ctx->steps, ctx->data);
+  fpe = fetestexcept(FE_ALL_EXCEPT);
+  if (fpe) {
+    feclearexcept(FE_ALL_EXCEPT);
+#ifdef __GNUC__
+    __atomic_fetch_or(&ctx->fpe, fpe, __ATOMIC_RELAXED);
+#else
+    ctx->fpe |= fpe;
+#endif
+  }
+}
+
+// Bytes [lo, hi) spanned by n elements of at most an interval each.
+static void
+interval_ufunc_extent(char *p, npy_intp n, npy_intp step, char **lo, char **hi)
+{
+  char *last = p + (n - 1)*step;
+  *lo = step < 0 ? last : p;
+  *hi = (step < 0 ? p : last) + sizeof(interval);
+}
+
+// Whether elements depend on one another: reductions (output step 0) and
+// accumulations (output overlapping an input other than element for
+// element) chain every element to the previous one.
+static int
+interval_ufunc_chained(int nargs, char **args, npy_intp n, npy_intp *steps)
+{
+  char *olo, *ohi, *lo, *hi;
+  int k;
+  if (steps[nargs - 1] == 0) {
+    return 1;
+  }
+  interval_ufunc_extent(args[nargs - 1], n, steps[nargs - 1], &olo, &ohi);
+  for (k = 0; k < nargs - 1; k++) {
+    if (args[k] == args[nargs - 1] && steps[k] == steps[nargs - 1]) {
+      continue;
+    }
+    interval_ufunc_extent(args[k], n, steps[k], &lo, &hi);
+    if (lo < ohi && olo < hi) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void
+interval_ufunc_threaded(interval_ufunc_loop *loop, int nargs, char **args,
+                        npy_intp *dimensions, npy_intp *steps, void *data, npy_intp grain)
+{
+  interval_ufunc_split ctx = { loop, args, steps, data, nargs, 0 };
+  if (dimensions[0] < 2*grain || interval_get_num_threads() < 2 ||
+      interval_ufunc_chained(nargs, args, dimensions[0], steps)) {
+    loop(args, dimensions, steps, data);
+    return;
+  }
+  interval_parallel_for(dimensions[0], grain, interval_ufunc_range, &ctx);
+  if (ctx.fpe) {
+    feraiseexcept(ctx.fpe);
+  }
+}
+
+#ifdef INTERVAL_ARRAYMETHOD
+// With the ArrayMethod API numpy picks the loop for the memory layout
+// itself.  Operands that are not aligned for their dtype are copied in
+// chunks to aligned buffers and run through the contiguous loop; nargs
+// counts the output, which is the last operand.
+#define INTERVAL_UNALIGNED_CHUNK 128
+
+static void
+interval_ufunc_unaligned(PyArrayMethod_Context *context, interval_ufunc_loop *loop,
+                         int nargs, char *const *args, const npy_intp *dimensions,
+                         const npy_intp *steps)
+{
+  interval buf[4][INTERVAL_UNALIGNED_CHUNK];
+  char *bufargs[4];
+  npy_intp sizes[4];
+  npy_intp n = dimensions[0], start, m, i;
+  int k;
+  for (k = 0; k < nargs; k++) {
+    bufargs[k] = (char *)buf[k];
+    sizes[k] = PyDataType_ELSIZE(context->descriptors[k]);
+  }
+  for (start = 0; start < n; start += m) {
+    m = n - start < INTERVAL_UNALIGNED_CHUNK ? n - start : INTERVAL_UNALIGNED_CHUNK;
+    for (k = 0; k < nargs - 1; k++) {
+      for (i = 0; i < m; i++) {
+        memcpy(bufargs[k] + i*sizes[k], args[k] + (start + i)*steps[k], sizes[k]);
+      }
+    }
+    loop(bufargs, &m, sizes, NULL);
+    for (i = 0; i < m; i++) {
+      memcpy(args[k] + (start + i)*steps[k], bufargs[k] + i*sizes[k], sizes[k]);
+    }
+  }
+}
+
+// Defines the strided, contiguous and unaligned ArrayMethod loops
+// interval_<ufunc_name>_{strided,contig,unaligned} from the serial loops
+// interval_<ufunc_name>_loop and interval_<ufunc_name>_contig_loop with
+// nargs operands, the first two threaded.
+#define THREADED_UFUNC(ufunc_name, nargs, grain)                        \
+  static int                                                            \
+  interval_##ufunc_name##_strided(PyArrayMethod_Context *NPY_UNUSED(context), \
+                                  char *const *args, const npy_intp *dimensions, \
+                                  const npy_intp *steps, NpyAuxData *NPY_UNUSED(auxdata)) { \
+    interval_ufunc_threaded(interval_##ufunc_name##_loop, nargs, (char **)args, \
+                            (npy_intp *)dimensions, (npy_intp *)steps, NULL, grain); \
+    return 0;                                                           \
+  }                                                                     \
+  static int                                                            \
+  interval_##ufunc_name##_contig(PyArrayMethod_Context *NPY_UNUSED(context), \
+                                 char *const *args, const npy_intp *dimensions, \
+                                 const npy_intp *steps, NpyAuxData *NPY_UNUSED(auxdata)) { \
+    interval_ufunc_threaded(interval_##ufunc_name##_contig_loop, nargs, (char **)args, \
+                            (npy_intp *)dimensions, (npy_intp *)steps, NULL, grain); \
+    return 0;                                                           \
+  }                                                                     \
+  static int                                                            \
+  interval_##ufunc_name##_unaligned(PyArrayMethod_Context *context,     \
+                                    char *const *args, const npy_intp *dimensions, \
+                                    const npy_intp *steps, NpyAuxData *NPY_UNUSED(auxdata)) { \
+    interval_ufunc_unaligned(context, interval_##ufunc_name##_contig_loop, nargs, \
+                             args, dimensions, steps);                  \
+    return 0;                                                           \
+  }
+
+// Defines the ArrayMethod loop <name>_strided for the gufunc loop
+// <name>_ufunc, which advances its argument pointers.
+#define GUFUNC_METHOD(name, nargs)                                      \
+  static int                                                            \
+  name##_strided(PyArrayMethod_Context *NPY_UNUSED(context),            \
+                 char *const *data, const npy_intp *dimensions,         \
+                 const npy_intp *steps, NpyAuxData *NPY_UNUSED(auxdata)) { \
+    char *args[nargs];                                                  \
+    int k;                                                              \
+    for (k = 0; k < nargs; k++) {                                       \
+      args[k] = data[k];                                                \
+    }                                                                   \
+    name##_ufunc(args, (npy_intp *)dimensions, (npy_intp *)steps, NULL); \
+    return 0;                                                           \
+  }
+#else
+// Defines interval_<ufunc_name>_ufunc, the threaded version of the
+// serial loop interval_<ufunc_name>_loop with nargs operands.
+#define THREADED_UFUNC(ufunc_name, nargs, grain)                        \
+  static void                                                           \
+  interval_##ufunc_name##_ufunc(char** args, npy_intp* dimensions,      \
+                                npy_intp* steps, void* data) {          \
+    interval_ufunc_threaded(interval_##ufunc_name##_loop, nargs, args,  \
+                            dimensions, steps, data, grain);            \
+  }
+#define GUFUNC_METHOD(name, nargs)
+#endif
+
+// The generated serial loops come in two versions: a contiguous one,
+// interval_<ufunc_name>_contig_loop, whose strides are the item sizes
+// and known at compile time, so its loop is plain array indexing the
+// compiler can vectorize, and interval_<ufunc_name>_loop for any
+// strides, which hands contiguous operands over to the first.
+
 // This is a macro that will be used to define the various basic unary
 // interval functions, so that they can be applied quickly to a
 // numpy array of intervals.
-#define UNARY_GEN_UFUNC(ufunc_name, func_name, ret_type)        \
-  static void                                                           \
-  interval_##ufunc_name##_ufunc(char** args, npy_intp* dimensions,    \
-                                  npy_intp* steps, void* NPY_UNUSED(data)) { \
-    /* fprintf (stderr, "file %s, line %d, interval_%s_ufunc.\n", __FILE__, __LINE__, #ufunc_name); */ \
-    char *ip1 = args[0], *op1 = args[1];                                \
-    npy_intp is1 = steps[0], os1 = steps[1];                            \
-    npy_intp n = dimensions[0];                                         \
+#define UNARY_GEN_UFUNC(ufunc_name, func_name, ret_type, grain) \
+  NPY_FINLINE void                                                      \
+  interval_##ufunc_name##_run(char *ip1, char *op1, npy_intp is1,      \
+                              npy_intp os1, npy_intp n) {              \
     npy_intp i;                                                         \
-    for(i = 0; i < n; i++, ip1 += is1, op1 += os1){                     \
-      const interval in1 = *(interval *)ip1;                        \
-      *((ret_type *)op1) = interval_##func_name(in1);};}
-#define UNARY_UFUNC(name, ret_type) \
-  UNARY_GEN_UFUNC(name, name, ret_type)
+    for(i = 0; i < n; i++) {                                            \
+      const interval in1 = *(interval *)(ip1 + i*is1);                  \
+      *((ret_type *)(op1 + i*os1)) = interval_##func_name(in1);         \
+    }                                                                   \
+  }                                                                     \
+  static void                                                           \
+  interval_##ufunc_name##_contig_loop(char** args, npy_intp* dimensions, \
+                                      npy_intp* NPY_UNUSED(steps), void* NPY_UNUSED(data)) { \
+    interval_##ufunc_name##_run(args[0], args[1], sizeof(interval),    \
+                                sizeof(ret_type), dimensions[0]);      \
+  }                                                                     \
+  static void                                                           \
+  interval_##ufunc_name##_loop(char** args, npy_intp* dimensions,     \
+                                  npy_intp* steps, void* data) {        \
+    if (steps[0] == sizeof(interval) && steps[1] == sizeof(ret_type)) { \
+      interval_##ufunc_name##_contig_loop(args, dimensions, steps, data); \
+      return;                                                           \
+    }                                                                   \
+    interval_##ufunc_name##_run(args[0], args[1], steps[0], steps[1], dimensions[0]); \
+  }                                                                     \
+  THREADED_UFUNC(ufunc_name, 2, grain)
+#define UNARY_UFUNC(name, ret_type, grain) \
+  UNARY_GEN_UFUNC(name, name, ret_type, grain)
 // And these all do the work mentioned above, using the macro
-UNARY_UFUNC(norm, npy_double)
-UNARY_UFUNC(sin, interval)
-UNARY_UFUNC(cos, interval)
-UNARY_UFUNC(tan, interval)
-UNARY_UFUNC(arctan, interval)
-UNARY_UFUNC(tanh, interval)
-UNARY_UFUNC(exp, interval)
-UNARY_UFUNC(sqrt, interval)
-UNARY_UFUNC(square, interval)
-UNARY_UFUNC(negative, interval)
-static void
-interval_positive_ufunc(char** args, npy_intp* dimensions, npy_intp* steps, void* NPY_UNUSED(data)) {
-  char *ip1 = args[0], *op1 = args[1];
-  npy_intp is1 = steps[0], os1 = steps[1];
-  npy_intp n = dimensions[0];
-  npy_intp i;
-  for(i = 0; i < n; i++, ip1 += is1, op1 += os1) {
-    const interval in1 = *(interval *)ip1;
-    *((interval *)op1) = in1;
-  }
-}
+UNARY_UFUNC(norm, npy_double, INTERVAL_GRAIN_CHEAP)
+UNARY_UFUNC(sin, interval, INTERVAL_GRAIN_TRANSCENDENTAL)
+UNARY_UFUNC(cos, interval, INTERVAL_GRAIN_TRANSCENDENTAL)
+UNARY_UFUNC(tan, interval, INTERVAL_GRAIN_TRANSCENDENTAL)
+UNARY_UFUNC(arctan, interval, INTERVAL_GRAIN_TRANSCENDENTAL)
+UNARY_UFUNC(tanh, interval, INTERVAL_GRAIN_TRANSCENDENTAL)
+UNARY_UFUNC(relu, interval, INTERVAL_GRAIN_CHEAP)
+UNARY_UFUNC(sigmoid, interval, INTERVAL_GRAIN_TRANSCENDENTAL)
+UNARY_UFUNC(exp, interval, INTERVAL_GRAIN_TRANSCENDENTAL)
+UNARY_UFUNC(sqrt, interval, INTERVAL_GRAIN_TRANSCENDENTAL)
+UNARY_UFUNC(square, interval, INTERVAL_GRAIN_MULTIPLY)
+UNARY_UFUNC(negative, interval, INTERVAL_GRAIN_CHEAP)
+UNARY_UFUNC(positive, interval, INTERVAL_GRAIN_CHEAP)
 
 // This is a macro that will be used to define the various basic binary
 // interval functions, so that they can be applied quickly to a
 // numpy array of intervals.
-#define BINARY_GEN_UFUNC(ufunc_name, func_name, arg_type1, arg_type2, ret_type) \
-  static void                                                           \
-  interval_##ufunc_name##_ufunc(char** args, npy_intp* dimensions,    \
-                                  npy_intp* steps, void* NPY_UNUSED(data)) { \
-    /* fprintf (stderr, "file %s, line %d, interval_%s_ufunc.\n", __FILE__, __LINE__, #ufunc_name); */ \
-    char *ip1 = args[0], *ip2 = args[1], *op1 = args[2];                \
-    npy_intp is1 = steps[0], is2 = steps[1], os1 = steps[2];            \
-    npy_intp n = dimensions[0];                                         \
+#define BINARY_GEN_RUN(ufunc_name, func_name, arg_type1, arg_type2, ret_type) \
+  NPY_FINLINE void                                                      \
+  interval_##ufunc_name##_run(char *ip1, char *ip2, char *op1, npy_intp is1, \
+                              npy_intp is2, npy_intp os1, npy_intp n) { \
     npy_intp i;                                                         \
-    for(i = 0; i < n; i++, ip1 += is1, ip2 += is2, op1 += os1) {        \
-      const arg_type1 in1 = *(arg_type1 *)ip1;                          \
-      const arg_type2 in2 = *(arg_type2 *)ip2;                          \
-      *((ret_type *)op1) = interval_##func_name(in1, in2);            \
-    };                                                                  \
-  };
+    for(i = 0; i < n; i++) {                                            \
+      const arg_type1 in1 = *(arg_type1 *)(ip1 + i*is1);                \
+      const arg_type2 in2 = *(arg_type2 *)(ip2 + i*is2);                \
+      *((ret_type *)(op1 + i*os1)) = interval_##func_name(in1, in2);    \
+    }                                                                   \
+  }                                                                     \
+  static void                                                           \
+  interval_##ufunc_name##_contig_loop(char** args, npy_intp* dimensions, \
+                                      npy_intp* NPY_UNUSED(steps), void* NPY_UNUSED(data)) { \
+    interval_##ufunc_name##_run(args[0], args[1], args[2], sizeof(arg_type1), \
+                                sizeof(arg_type2), sizeof(ret_type), dimensions[0]); \
+  }
+#define BINARY_GEN_UFUNC(ufunc_name, func_name, arg_type1, arg_type2, ret_type, grain) \
+  BINARY_GEN_RUN(ufunc_name, func_name, arg_type1, arg_type2, ret_type) \
+  static void                                                           \
+  interval_##ufunc_name##_loop(char** args, npy_intp* dimensions,     \
+                                  npy_intp* steps, void* data) {        \
+    if (steps[0] == sizeof(arg_type1) && steps[1] == sizeof(arg_type2) && \
+        steps[2] == sizeof(ret_type)) {                                 \
+      interval_##ufunc_name##_contig_loop(args, dimensions, steps, data); \
+      return;                                                           \
+    }                                                                   \
+    interval_##ufunc_name##_run(args[0], args[1], args[2], steps[0],   \
+                                steps[1], steps[2], dimensions[0]);    \
+  }                                                                     \
+  THREADED_UFUNC(ufunc_name, 3, grain)
 // A couple special-case versions of the above
-#define BINARY_UFUNC(name, ret_type)                    \
-  BINARY_GEN_UFUNC(name, name, interval, interval, ret_type)
-#define BINARY_SCALAR_UFUNC(name, ret_type)                             \
-  BINARY_GEN_UFUNC(name##_scalar, name##_scalar, interval, npy_double, ret_type) \
-  BINARY_GEN_UFUNC(scalar_##name, scalar_##name, npy_double, interval, ret_type)
+#define BINARY_UFUNC(name, ret_type, grain)             \
+  BINARY_GEN_UFUNC(name, name, interval, interval, ret_type, grain)
+
+// Loops for an interval operand against a double that numpy broadcast
+// with stride 0.  The double is loaded once and anything that depends
+// only on it (its sign, its reciprocal) is resolved before the loop, so
+// the loop body is branch-free; contiguous operands get a plain indexed
+// loop the compiler can vectorize.
+#define INTERVAL_CONST_LOOP(expr)                                       \
+  if (is1 == sizeof(interval) && os1 == sizeof(interval)) {             \
+    const interval *in = (const interval *)ip1;                         \
+    interval *out = (interval *)op1;                                    \
+    for(i = 0; i < n; i++) {                                            \
+      const interval in1 = in[i];                                       \
+      out[i] = (expr);                                                  \
+    }                                                                   \
+  } else {                                                              \
+    for(i = 0; i < n; i++, ip1 += is1, op1 += os1) {                    \
+      const interval in1 = *(interval *)ip1;                            \
+      *((interval *)op1) = (expr);                                      \
+    }                                                                   \
+  }
+// interval_multiply_scalar with the sign of s already known.
+static inline interval interval_scale_nonneg(interval i, double s) {
+  return (interval) { i.l*s, i.u*s };
+}
+static inline interval interval_scale_neg(interval i, double s) {
+  return (interval) { i.u*s, i.l*s };
+}
+#define CONST_SCALAR_LOOP(name)                                         \
+  static void                                                           \
+  interval_##name##_const(char *ip1, char *op1, npy_intp is1, npy_intp os1, \
+                          npy_intp n, double s)
+CONST_SCALAR_LOOP(add_scalar) {
+  npy_intp i;
+  INTERVAL_CONST_LOOP(((interval) { in1.l + s, in1.u + s }));
+}
+CONST_SCALAR_LOOP(subtract_scalar) {
+  npy_intp i;
+  INTERVAL_CONST_LOOP(((interval) { in1.l - s, in1.u - s }));
+}
+CONST_SCALAR_LOOP(scalar_subtract) {
+  npy_intp i;
+  INTERVAL_CONST_LOOP(((interval) { s - in1.u, s - in1.l }));
+}
+CONST_SCALAR_LOOP(multiply_scalar) {
+  npy_intp i;
+  if (s >= 0) {
+    INTERVAL_CONST_LOOP(interval_scale_nonneg(in1, s));
+  } else {
+    INTERVAL_CONST_LOOP(interval_scale_neg(in1, s));
+  }
+}
+CONST_SCALAR_LOOP(divide_scalar) {
+  interval_multiply_scalar_const(ip1, op1, is1, os1, n, 1/s);
+}
+CONST_SCALAR_LOOP(scalar_divide) {
+  npy_intp i;
+  if (s >= 0) {
+    INTERVAL_CONST_LOOP(interval_scale_nonneg(interval_inverse(in1), s));
+  } else {
+    INTERVAL_CONST_LOOP(interval_scale_neg(interval_inverse(in1), s));
+  }
+}
+#define interval_scalar_add_const interval_add_scalar_const
+#define interval_scalar_multiply_const interval_multiply_scalar_const
+
+// The loops for func_name on an interval and a double, the double in
+// argument position s (0 or 1), with a hoisted loop for a broadcast
+// double.
+#define BINARY_CONST_UFUNC(ufunc_name, func_name, arg_type1, arg_type2, s, grain) \
+  BINARY_GEN_RUN(ufunc_name, func_name, arg_type1, arg_type2, interval) \
+  static void                                                           \
+  interval_##ufunc_name##_loop(char** args, npy_intp* dimensions,      \
+                                npy_intp* steps, void* data) {          \
+    if (steps[s] == 0) {                                                \
+      if (dimensions[0] > 0) {                                          \
+        interval_##func_name##_const(args[1 - (s)], args[2], steps[1 - (s)], steps[2], \
+                                     dimensions[0], *(npy_double *)args[s]); \
+      }                                                                 \
+      return;                                                           \
+    }                                                                   \
+    if (steps[0] == sizeof(arg_type1) && steps[1] == sizeof(arg_type2) && \
+        steps[2] == sizeof(interval)) {                                 \
+      interval_##ufunc_name##_contig_loop(args, dimensions, steps, data); \
+      return;                                                           \
+    }                                                                   \
+    interval_##ufunc_name##_run(args[0], args[1], args[2], steps[0],   \
+                                steps[1], steps[2], dimensions[0]);    \
+  }                                                                     \
+  THREADED_UFUNC(ufunc_name, 3, grain)
+// The interval, double -> interval loop for func_name.
+#define BINARY_INTERVAL_DOUBLE_UFUNC(ufunc_name, func_name, grain)      \
+  BINARY_CONST_UFUNC(ufunc_name, func_name, interval, npy_double, 1, grain)
+// The double, interval -> interval loop for func_name.
+#define BINARY_DOUBLE_INTERVAL_UFUNC(ufunc_name, func_name, grain)      \
+  BINARY_CONST_UFUNC(ufunc_name, func_name, npy_double, interval, 0, grain)
+#define BINARY_SCALAR_UFUNC(name, ret_type, grain)                      \
+  BINARY_INTERVAL_DOUBLE_UFUNC(name##_scalar, name##_scalar, grain)     \
+  BINARY_DOUBLE_INTERVAL_UFUNC(scalar_##name, scalar_##name, grain)
 // And these all do the work mentioned above, using the macros
-BINARY_GEN_UFUNC(power_scalar, power_scalar, interval, npy_double, interval)
-BINARY_UFUNC(add, interval)
-BINARY_UFUNC(subtract, interval)
-BINARY_UFUNC(multiply, interval)
-BINARY_UFUNC(divide, interval)
-BINARY_GEN_UFUNC(true_divide, divide, interval, interval, interval)
-BINARY_GEN_UFUNC(floor_divide, divide, interval, interval, interval)
-BINARY_UFUNC(equal, npy_bool)
-BINARY_UFUNC(not_equal, npy_bool)
-BINARY_UFUNC(subseteq, npy_bool)
-BINARY_UFUNC(supseteq, npy_bool)
-BINARY_UFUNC(subset, npy_bool)
-BINARY_UFUNC(supset, npy_bool)
-BINARY_SCALAR_UFUNC(add, interval)
-BINARY_SCALAR_UFUNC(subtract, interval)
-BINARY_SCALAR_UFUNC(multiply, interval)
-BINARY_SCALAR_UFUNC(divide, interval)
-BINARY_GEN_UFUNC(true_divide_scalar, divide_scalar, interval, npy_double, interval)
-BINARY_GEN_UFUNC(floor_divide_scalar, divide_scalar, interval, npy_double, interval)
-BINARY_GEN_UFUNC(scalar_true_divide, scalar_divide, npy_double, interval, interval)
-BINARY_GEN_UFUNC(scalar_floor_divide, scalar_divide, npy_double, interval, interval)
-BINARY_UFUNC(union, interval)
-BINARY_UFUNC(intersection, interval)
-BINARY_UFUNC(maximum, interval)
-BINARY_UFUNC(minimum, interval)
+BINARY_UFUNC(add, interval, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(subtract, interval, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(multiply, interval, INTERVAL_GRAIN_MULTIPLY)
+BINARY_UFUNC(divide, interval, INTERVAL_GRAIN_MULTIPLY)
+BINARY_GEN_UFUNC(true_divide, divide, interval, interval, interval, INTERVAL_GRAIN_MULTIPLY)
+BINARY_GEN_UFUNC(floor_divide, divide, interval, interval, interval, INTERVAL_GRAIN_MULTIPLY)
+BINARY_UFUNC(equal, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(not_equal, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(subseteq, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(supseteq, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(subset, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(supset, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(certainly_lt, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(certainly_le, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(certainly_gt, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(certainly_ge, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(possibly_lt, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(possibly_le, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(possibly_gt, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(possibly_ge, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(compare_lt, npy_byte, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(compare_le, npy_byte, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(compare_gt, npy_byte, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(compare_ge, npy_byte, INTERVAL_GRAIN_CHEAP)
+BINARY_GEN_UFUNC(contains, contains, interval, npy_double, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(overlaps, npy_bool, INTERVAL_GRAIN_CHEAP)
+BINARY_SCALAR_UFUNC(add, interval, INTERVAL_GRAIN_CHEAP)
+BINARY_SCALAR_UFUNC(subtract, interval, INTERVAL_GRAIN_CHEAP)
+BINARY_SCALAR_UFUNC(multiply, interval, INTERVAL_GRAIN_MULTIPLY)
+BINARY_SCALAR_UFUNC(divide, interval, INTERVAL_GRAIN_MULTIPLY)
+BINARY_INTERVAL_DOUBLE_UFUNC(true_divide_scalar, divide_scalar, INTERVAL_GRAIN_MULTIPLY)
+BINARY_INTERVAL_DOUBLE_UFUNC(floor_divide_scalar, divide_scalar, INTERVAL_GRAIN_MULTIPLY)
+BINARY_DOUBLE_INTERVAL_UFUNC(scalar_true_divide, scalar_divide, INTERVAL_GRAIN_MULTIPLY)
+BINARY_DOUBLE_INTERVAL_UFUNC(scalar_floor_divide, scalar_divide, INTERVAL_GRAIN_MULTIPLY)
+BINARY_UFUNC(union, interval, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(intersection, interval, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(maximum, interval, INTERVAL_GRAIN_CHEAP)
+BINARY_UFUNC(minimum, interval, INTERVAL_GRAIN_CHEAP)
+
+// Fused multiply-add loops: fma(a, b, c) = a*b + c, and axpy(alpha, x, y)
+// = alpha*x + y, in one pass instead of a product, a temporary and a sum.
+// When the double multiplier of an fma is broadcast (alpha, or the dt of
+// an Euler step x + dt*f(x)), its sign picks the endpoint pairing once,
+// outside the loop.
+#define TERNARY_GEN_RUN(ufunc_name, func_name, arg_type1, arg_type2, arg_type3) \
+  NPY_FINLINE void                                                      \
+  interval_##ufunc_name##_run(char **args, npy_intp is1, npy_intp is2,  \
+                              npy_intp is3, npy_intp os1, npy_intp n) { \
+    char *ip1 = args[0], *ip2 = args[1], *ip3 = args[2], *op1 = args[3]; \
+    npy_intp i;                                                         \
+    for(i = 0; i < n; i++) {                                            \
+      const arg_type1 in1 = *(arg_type1 *)(ip1 + i*is1);                \
+      const arg_type2 in2 = *(arg_type2 *)(ip2 + i*is2);                \
+      const arg_type3 in3 = *(arg_type3 *)(ip3 + i*is3);                \
+      *((interval *)(op1 + i*os1)) = interval_##func_name(in1, in2, in3); \
+    }                                                                   \
+  }                                                                     \
+  static void                                                           \
+  interval_##ufunc_name##_contig_loop(char** args, npy_intp* dimensions, \
+                                      npy_intp* NPY_UNUSED(steps), void* NPY_UNUSED(data)) { \
+    interval_##ufunc_name##_run(args, sizeof(arg_type1), sizeof(arg_type2), \
+                                sizeof(arg_type3), sizeof(interval), dimensions[0]); \
+  }
+#define TERNARY_IS_CONTIG(arg_type1, arg_type2, arg_type3)              \
+  (steps[0] == sizeof(arg_type1) && steps[1] == sizeof(arg_type2) &&    \
+   steps[2] == sizeof(arg_type3) && steps[3] == sizeof(interval))
+#define TERNARY_GEN_UFUNC(ufunc_name, func_name, arg_type1, arg_type2, arg_type3, grain) \
+  TERNARY_GEN_RUN(ufunc_name, func_name, arg_type1, arg_type2, arg_type3) \
+  static void                                                           \
+  interval_##ufunc_name##_loop(char** args, npy_intp* dimensions,      \
+                                npy_intp* steps, void* data) {          \
+    if (TERNARY_IS_CONTIG(arg_type1, arg_type2, arg_type3)) {           \
+      interval_##ufunc_name##_contig_loop(args, dimensions, steps, data); \
+      return;                                                           \
+    }                                                                   \
+    interval_##ufunc_name##_run(args, steps[0], steps[1], steps[2],    \
+                                steps[3], dimensions[0]);              \
+  }                                                                     \
+  THREADED_UFUNC(ufunc_name, 4, grain)
+TERNARY_GEN_UFUNC(fma, fma, interval, interval, interval, INTERVAL_GRAIN_MULTIPLY)
+TERNARY_GEN_UFUNC(fma_scalar, fma_scalar, interval, interval, npy_double, INTERVAL_GRAIN_MULTIPLY)
+
+// s*b + c over n elements, with lo/hi the endpoints of b that go to the
+// lower/upper bound for the sign of s.
+#define SCALAR_FMA_LOOP(lo, hi)                                         \
+  if (is2 == sizeof(interval) && is3 == sizeof(interval) && os1 == sizeof(interval)) { \
+    const interval *b = (const interval *)ip2, *c = (const interval *)ip3; \
+    interval *out = (interval *)op1;                                    \
+    for(i = 0; i < n; i++) {                                            \
+      out[i] = (interval) { INTERVAL_FMA(s, b[i].lo, c[i].l), INTERVAL_FMA(s, b[i].hi, c[i].u) }; \
+    }                                                                   \
+  } else {                                                              \
+    for(i = 0; i < n; i++, ip2 += is2, ip3 += is3, op1 += os1) {        \
+      const interval b = *(interval *)ip2, c = *(interval *)ip3;        \
+      *((interval *)op1) = (interval) { INTERVAL_FMA(s, b.lo, c.l), INTERVAL_FMA(s, b.hi, c.u) }; \
+    }                                                                   \
+  }
+static void
+interval_scalar_fma_const(char *ip2, char *ip3, char *op1, npy_intp is2, npy_intp is3,
+                          npy_intp os1, npy_intp n, double s)
+{
+  npy_intp i;
+  if (s >= 0) {
+    SCALAR_FMA_LOOP(l, u)
+  } else {
+    SCALAR_FMA_LOOP(u, l)
+  }
+}
+
+// fma(a, s, c) for a double s.
+static inline interval interval_fma_scalar_mul(interval a, double s, interval c) {
+  return interval_scalar_fma(s, a, c);
+}
+
+// The loop for a double multiplier in argument position s (0 or 1) and
+// an interval one in position 1 - s; func_name takes them in that order.
+#define SCALAR_FMA_UFUNC(ufunc_name, func_name, arg_type1, arg_type2, s, grain) \
+  TERNARY_GEN_RUN(ufunc_name, func_name, arg_type1, arg_type2, interval) \
+  static void                                                           \
+  interval_##ufunc_name##_loop(char** args, npy_intp* dimensions,      \
+                                npy_intp* steps, void* data) {          \
+    if (steps[s] == 0) {                                                \
+      if (dimensions[0] > 0) {                                          \
+        interval_scalar_fma_const(args[1 - (s)], args[2], args[3], steps[1 - (s)], \
+                                  steps[2], steps[3], dimensions[0], *(npy_double *)args[s]); \
+      }                                                                 \
+      return;                                                           \
+    }                                                                   \
+    if (TERNARY_IS_CONTIG(arg_type1, arg_type2, interval)) {            \
+      interval_##ufunc_name##_contig_loop(args, dimensions, steps, data); \
+      return;                                                           \
+    }                                                                   \
+    interval_##ufunc_name##_run(args, steps[0], steps[1], steps[2],    \
+                                steps[3], dimensions[0]);              \
+  }                                                                     \
+  THREADED_UFUNC(ufunc_name, 4, grain)
+SCALAR_FMA_UFUNC(scalar_fma, scalar_fma, npy_double, interval, 0, INTERVAL_GRAIN_MULTIPLY)
+SCALAR_FMA_UFUNC(fma_scalar_mul, fma_scalar_mul, interval, npy_double, 1, INTERVAL_GRAIN_MULTIPLY)
+
+// Power loops.  When the exponent is a broadcast constant (stride 0) and
+// an integer, it is read once and the kernel and the parity of the
+// exponent are fixed outside the loop; otherwise every element goes
+// through interval_power_scalar.
+static void
+interval_power_int_loop(char *ip1, char *op1, npy_intp is1, npy_intp os1, npy_intp n, long p)
+{
+  npy_intp i;
+  unsigned long q = p < 0 ? -(unsigned long)p : (unsigned long)p;
+  switch (p) {
+    case 0:
+      for(i = 0; i < n; i++, op1 += os1) {
+        *((interval *)op1) = (interval) { 1, 1 };
+      }
+      return;
+    case 1: INTERVAL_CONST_LOOP(in1); return;
+    case 2: INTERVAL_CONST_LOOP(interval_square(in1)); return;
+    case 3: INTERVAL_CONST_LOOP(interval_cube(in1)); return;
+    case 4: INTERVAL_CONST_LOOP(interval_fourth(in1)); return;
+    case -1: INTERVAL_CONST_LOOP(interval_inverse(in1)); return;
+    case -2: INTERVAL_CONST_LOOP(interval_inverse(interval_square(in1))); return;
+  }
+  if (p > 0) {
+    if (q & 1) {
+      INTERVAL_CONST_LOOP(interval_power_odd(in1, q));
+    } else {
+      INTERVAL_CONST_LOOP(interval_power_even(in1, q));
+    }
+  } else {
+    if (q & 1) {
+      INTERVAL_CONST_LOOP(interval_inverse(interval_power_odd(in1, q)));
+    } else {
+      INTERVAL_CONST_LOOP(interval_inverse(interval_power_even(in1, q)));
+    }
+  }
+}
+static void
+interval_power_scalar_loop(char** args, npy_intp* dimensions,
+                           npy_intp* steps, void* NPY_UNUSED(data)) {
+  char *ip1 = args[0], *ip2 = args[1], *op1 = args[2];
+  npy_intp is1 = steps[0], is2 = steps[1], os1 = steps[2];
+  npy_intp n = dimensions[0];
+  npy_intp i;
+  if (is2 == 0 && n > 0 && interval_is_int_exponent(*(npy_double *)ip2)) {
+    interval_power_int_loop(ip1, op1, is1, os1, n, (long)*(npy_double *)ip2);
+    return;
+  }
+  for(i = 0; i < n; i++, ip1 += is1, ip2 += is2, op1 += os1) {
+    const interval in1 = *(interval *)ip1;
+    const npy_double in2 = *(npy_double *)ip2;
+    *((interval *)op1) = interval_power_scalar(in1, in2);
+  }
+}
+// long may be 32 bits (LLP64): int64 exponents outside
+// +-INTERVAL_POWER_INT_MAX take the float power path instead.
+#define INTERVAL_INT64_EXPONENT(e) ((e) > -INTERVAL_POWER_INT_MAX && (e) < INTERVAL_POWER_INT_MAX)
+
+static void
+interval_power_int64_loop(char** args, npy_intp* dimensions,
+                          npy_intp* steps, void* NPY_UNUSED(data)) {
+  char *ip1 = args[0], *ip2 = args[1], *op1 = args[2];
+  npy_intp is1 = steps[0], is2 = steps[1], os1 = steps[2];
+  npy_intp n = dimensions[0];
+  npy_intp i;
+  if (is2 == 0 && n > 0 && INTERVAL_INT64_EXPONENT(*(npy_int64 *)ip2)) {
+    interval_power_int_loop(ip1, op1, is1, os1, n, (long)*(npy_int64 *)ip2);
+    return;
+  }
+  for(i = 0; i < n; i++, ip1 += is1, ip2 += is2, op1 += os1) {
+    const interval in1 = *(interval *)ip1;
+    const npy_int64 in2 = *(npy_int64 *)ip2;
+    *((interval *)op1) = INTERVAL_INT64_EXPONENT(in2) ? interval_power_int(in1, (long)in2)
+                                                      : interval_power_scalar(in1, (double)in2);
+  }
+}
+#define interval_power_scalar_contig_loop interval_power_scalar_loop
+#define interval_power_int64_contig_loop interval_power_int64_loop
+THREADED_UFUNC(power_scalar, 3, INTERVAL_GRAIN_TRANSCENDENTAL)
+THREADED_UFUNC(power_int64, 3, INTERVAL_GRAIN_TRANSCENDENTAL)
 
 static NPY_INLINE void
 interval_matmul(char **args, npy_intp *dimensions, npy_intp *steps)
@@ -1105,10 +1763,19 @@ interval_matmul(char **args, npy_intp *dimensions, npy_intp *steps)
     /* core dimensions counters */
     npy_intp m, p;
 
+    /* pick the dot kernel once for the whole product */
+    int point1 = 0, point2 = 0;
+    interval_dot_kernel *dot;
+    if (interval_dot_choice == INTERVAL_DOT_AUTO) {
+        point1 = interval_strided_is_point_2d(ip1, is1_m, is1_n, dm, dn);
+        point2 = !point1 && interval_strided_is_point_2d(ip2, is2_p, is2_n, dp, dn);
+    }
+    dot = interval_dot_select(point1, point2);
+
     /* calculate dot product for each row/column vector pair */
     for (m = 0; m < dm; m++) {
         for (p = 0; p < dp; p++) {
-            INTERVAL_dot(ip1, is1_n, ip2, is2_n, op, dn, NULL);
+            dot(ip1, is1_n, ip2, is2_n, (interval *)op, dn);
 
             /* advance to next column of 2nd input array and output array */
             ip2 += is2_p;
@@ -1125,6 +1792,54 @@ interval_matmul(char **args, npy_intp *dimensions, npy_intp *steps)
     }
 }
 
+// Stacks of n x n products (or matrix-vector products) with 2 <= n <= 8
+// go to the unrolled kernels of interval_small.h, split across threads.
+// They use the sign kernel's products, so they stand in for the 'auto'
+// and 'sign' dot kernels but not for 'four'.
+typedef struct {
+  char *args[3];
+  npy_intp steps[9];
+  interval_small_matmul_fn *matmul;
+  interval_small_matvec_fn *matvec;
+} interval_matmul_small_ctx;
+
+static void
+interval_matmul_small_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+  const interval_matmul_small_ctx *ctx = (const interval_matmul_small_ctx *)ctx_;
+  const npy_intp *st = ctx->steps, *cs = ctx->steps + 3;
+  npy_intp N_;
+  for (N_ = start; N_ < stop; N_++) {
+    const char *a = ctx->args[0] + N_*st[0], *b = ctx->args[1] + N_*st[1];
+    char *c = ctx->args[2] + N_*st[2];
+    if (ctx->matmul != NULL) {
+      ctx->matmul(a, cs[0], cs[1], b, cs[2], cs[3], c, cs[4], cs[5]);
+    } else {
+      ctx->matvec(a, cs[0], cs[1], b, cs[2], c, cs[4]);
+    }
+  }
+}
+
+static int
+interval_matmul_small(char **args, npy_intp *dimensions, npy_intp *steps)
+{
+  npy_intp dm = dimensions[1], dn = dimensions[2], dp = dimensions[3];
+  interval_matmul_small_ctx ctx;
+  if (interval_dot_choice == INTERVAL_DOT_FOUR || dm != dn) {
+    return 0;
+  }
+  ctx.matmul = dp == dm ? interval_small_matmul(dm) : NULL;
+  ctx.matvec = dp == 1 ? interval_small_matvec(dm) : NULL;
+  if (ctx.matmul == NULL && ctx.matvec == NULL) {
+    return 0;
+  }
+  memcpy(ctx.args, args, sizeof(ctx.args));
+  memcpy(ctx.steps, steps, sizeof(ctx.steps));
+  interval_parallel_for(dimensions[0], INTERVAL_GRAIN_MULTIPLY/(dm*dn*dp) + 1,
+                        interval_matmul_small_range, &ctx);
+  return 1;
+}
+
 static void
 interval_matmul_ufunc(char **args, npy_intp *dimensions, npy_intp *steps, void *NPY_UNUSED(func))
 {
@@ -1139,23 +1854,2301 @@ interval_matmul_ufunc(char **args, npy_intp *dimensions, npy_intp *steps, void *
     npy_intp s1 = steps[1];
     npy_intp s2 = steps[2];
 
+    if (interval_matmul_small(args, dimensions, steps)) {
+        return;
+    }
+
     /* loop through outer dimensions, performing matrix multiply on core dimensions for each loop */
     for (N_ = 0; N_ < dN; N_++, args[0] += s0, args[1] += s1, args[2] += s2) {
         interval_matmul(args, dimensions+1, steps+3);
     }
 }
+GUFUNC_METHOD(interval_matmul, 3)
+
+// exp(A h) of interval matrices by scaling and squaring: with B = A h/2^s
+// for the least s that brings ||B||_inf to at most EXPM_THETA, the Taylor
+// polynomial T = I + B(I + B/2(... (I + B/K))) is summed by Horner's rule
+// through interval_matmul, widened entrywise by the bound
+//
+//     ||B||^(K+1)/(K+1)! / (1 - ||B||/(K+2))
+//
+// on the norm of the remainder, and squared s times.  K is the least order
+// whose remainder bound is below DBL_EPSILON/2^s, so squaring does not
+// amplify it past rounding.  Interval arithmetic here rounds to nearest,
+// so every step is also widened outward by a bound on its own rounding
+// error: one ulp per scalar operation, and (n+2) DBL_EPSILON |A| |B| plus
+// the underflow of n products per entry of a product A @ B.  T then
+// contains exp(A h) for every point matrix A in the interval one.
+#define EXPM_THETA 0.5
+#define EXPM_MAX_ORDER 30
+// Matrix products of n^3 terms per thread below which a stack of
+// matrices is not split up.
+#define EXPM_GRAIN_TERMS 65536
+
+// C = A @ B for contiguous n x n interval matrices.
+static void
+interval_matmul_square(interval *A, interval *B, interval *C, npy_intp n)
+{
+  char *args[3] = { (char *)A, (char *)B, (char *)C };
+  npy_intp dims[3] = { n, n, n };
+  npy_intp s = sizeof(interval);
+  npy_intp steps[6] = { n*s, s, n*s, s, n*s, s };
+  interval_matmul(args, dims, steps);
+}
+
+// x widened outward by one ulp on each side.
+static interval
+interval_expm_outward(interval x)
+{
+  return (interval) { nextafter(x.l, -INFINITY), nextafter(x.u, INFINITY) };
+}
+
+// C = A @ B for contiguous n x n interval matrices, widened outward by a
+// bound on the rounding error of the sums of products.
+static void
+interval_expm_matmul(interval *A, interval *B, interval *C, npy_intp n)
+{
+  double gamma = (n + 2)*DBL_EPSILON, tiny = n*ldexp(1, -1074);
+  npy_intp i, j, k;
+  interval_matmul_square(A, B, C, n);
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      double m = 0, r;
+      for (k = 0; k < n; k++) {
+        m += fmax(fabs(A[i*n + k].l), fabs(A[i*n + k].u))
+           * fmax(fabs(B[k*n + j].l), fabs(B[k*n + j].u));
+      }
+      r = gamma*m + tiny;
+      if (r != r) {
+        r = INFINITY;
+      }
+      C[i*n + j] = interval_expm_outward((interval) { C[i*n + j].l - r, C[i*n + j].u + r });
+    }
+  }
+}
+
+// exp(A h) into X, with 2 n^2 intervals of scratch in work.
+static void
+interval_expm_one(const interval *A, double h, interval *X, interval *work, npy_intp n)
+{
+  interval *B = work, *T = work + n*n, *P = X;
+  double norm = 0, term = 1, rho = 0, tol;
+  npy_intp i, j, k, s = 0, K;
+
+  for (i = 0; i < n; i++) {
+    double row = 0;
+    for (j = 0; j < n; j++) {
+      B[i*n + j] = interval_expm_outward(interval_multiply_scalar(A[i*n + j], h));
+      row += fmax(fabs(B[i*n + j].l), fabs(B[i*n + j].u));
+    }
+    row *= 1 + (n + 1)*DBL_EPSILON;
+    if (row != row) {
+      norm = row;
+      break;
+    }
+    norm = fmax(norm, row);
+  }
+  if (!isfinite(norm)) {
+    for (i = 0; i < n*n; i++) {
+      X[i] = (interval) { -INFINITY, INFINITY };
+    }
+    return;
+  }
+  while (norm > EXPM_THETA) {
+    norm *= 0.5;
+    s++;
+  }
+  for (i = 0; i < n*n; i++) {
+    // Exact but for underflow.
+    B[i] = interval_expm_outward(interval_multiply_scalar(B[i], ldexp(1, -(int)s)));
+  }
+  tol = ldexp(DBL_EPSILON, -(int)s);
+  for (K = 0; ; K++) {
+    term *= norm/(K + 1);
+    rho = term/(1 - norm/(K + 2));
+    if (rho <= tol || K == EXPM_MAX_ORDER) {
+      break;
+    }
+  }
+  rho *= 1 + 4*(K + 2)*DBL_EPSILON;
+
+  // Horner's rule, T = I + B T/k for k = K, ..., 1 starting from T = I.
+  for (i = 0; i < n*n; i++) {
+    T[i] = K > 0 ? interval_expm_outward(interval_divide_scalar(B[i], (double)K))
+                 : (interval) { 0, 0 };
+  }
+  for (i = 0; i < n; i++) {
+    T[i*n + i] = interval_expm_outward(interval_add_scalar(T[i*n + i], 1));
+  }
+  for (k = K - 1; k >= 1; k--) {
+    interval_expm_matmul(B, T, P, n);
+    for (i = 0; i < n*n; i++) {
+      T[i] = interval_expm_outward(interval_divide_scalar(P[i], (double)k));
+    }
+    for (i = 0; i < n; i++) {
+      T[i*n + i] = interval_expm_outward(interval_add_scalar(T[i*n + i], 1));
+    }
+  }
+  for (i = 0; i < n*n; i++) {
+    T[i] = interval_expm_outward(interval_add(T[i], (interval) { -rho, rho }));
+  }
+
+  // Squaring, alternating between T and the spare buffer.
+  for (k = 0; k < s; k++) {
+    interval *spare = T == X ? B : X;
+    interval_expm_matmul(T, T, spare, n);
+    T = spare;
+  }
+  if (T != X) {
+    memcpy(X, T, n*n*sizeof(interval));
+  }
+}
+
+typedef struct {
+  const interval *A;
+  const double *h;
+  interval *X;
+  npy_intp n;
+  int failed;
+} interval_expm_ctx;
+
+static void
+interval_expm_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+  interval_expm_ctx *ctx = (interval_expm_ctx *)ctx_;
+  npy_intp n = ctx->n, k;
+  // Scratch for the whole range, reused by every matrix in it.
+  interval *work = malloc((2*n*n + 1)*sizeof(interval));
+  if (work == NULL) {
+    ctx->failed = 1;
+    return;
+  }
+  for (k = start; k < stop; k++) {
+    interval_expm_one(ctx->A + k*n*n, ctx->h[k], ctx->X + k*n*n, work, n);
+  }
+  free(work);
+}
+
+// C[b] = A[b] @ B[b] for contiguous stacks A (batch, m, k), B (batch, k, n)
+// and C (batch, m, n), split across threads by rows of C.  A range covers
+// consecutive rows, so each matrix of the stack it touches takes a single
+// interval_matmul call over its rows in the range.
+typedef struct {
+  interval *A, *B, *C;
+  npy_intp m, k, n;
+} interval_matmul_stack_ctx;
+
+static void
+interval_matmul_stack_range(void *ctx_, intptr_t start, intptr_t stop)
+{
+  const interval_matmul_stack_ctx *ctx = (const interval_matmul_stack_ctx *)ctx_;
+  npy_intp m = ctx->m, k = ctx->k, n = ctx->n, s = sizeof(interval);
+  npy_intp steps[6] = { k*s, s, n*s, s, n*s, s };
+  npy_intp row = start;
+  while (row < stop) {
+    npy_intp b = row/m, i = row%m, rows = m - i < stop - row ? m - i : stop - row;
+    char *args[3] = { (char *)(ctx->A + (b*m + i)*k), (char *)(ctx->B + b*k*n),
+                      (char *)(ctx->C + (b*m + i)*n) };
+    npy_intp dims[3] = { rows, k, n };
+    interval_matmul(args, dims, steps);
+    row += rows;
+  }
+}
+
+/////////////////////////////////////////////////////////////////
+// The midpoint-radius dtype, `midrad`, storing (m, r) as in midrad.h.
+// It casts to and from interval, has its own elementwise loops, and its
+// matmul works on the float64 midpoint and radius matrices, through
+// numpy's BLAS-backed float64 matmul once a product is large enough.
+
+typedef struct {
+  PyObject_HEAD
+  midrad obval;
+} PyMidrad;
+
+static PyTypeObject PyMidrad_Type;
+
+static PyArray_DescrProto midrad_descr_proto;
+PyArray_Descr* midrad_descr;
+
+static inline int
+PyMidrad_Check(PyObject* object) {
+  return PyObject_IsInstance(object,(PyObject*)&PyMidrad_Type);
+}
+
+static PyObject*
+PyMidrad_FromMidrad(midrad a) {
+  PyMidrad* p = (PyMidrad*)PyMidrad_Type.tp_alloc(&PyMidrad_Type,0);
+  if (p) { p->obval = a; }
+  return (PyObject*)p;
+}
+
+static PyObject *
+pymidrad_new(PyTypeObject *type, PyObject *NPY_UNUSED(args), PyObject *NPY_UNUSED(kwds))
+{
+  return type->tp_alloc(type, 0);
+}
+
+// midrad(), midrad(m), midrad(m, r), midrad(interval) or midrad(midrad)
+static int
+pymidrad_init(PyObject *self, PyObject *args, PyObject *kwds)
+{
+  midrad *a = &((PyMidrad *)self)->obval;
+  PyObject *o = NULL;
+  Py_ssize_t size = PyTuple_Size(args);
+
+  if (kwds && PyDict_Size(kwds)) {
+    PyErr_SetString(PyExc_TypeError, "midrad constructor takes no keyword arguments");
+    return -1;
+  }
+  a->m = 0.0;
+  a->r = 0.0;
+  if (size == 0) {
+    return 0;
+  }
+  if (size == 1 && PyArg_ParseTuple(args, "O", &o)) {
+    if (PyMidrad_Check(o)) {
+      *a = ((PyMidrad *)o)->obval;
+      return 0;
+    }
+    if (PyInterval_Check(o)) {
+      *a = midrad_from_interval(((PyInterval *)o)->obval);
+      return 0;
+    }
+    a->m = PyFloat_AsDouble(o);
+    if (!PyErr_Occurred()) {
+      return 0;
+    }
+  } else if (size == 2 && PyArg_ParseTuple(args, "dd", &a->m, &a->r)) {
+    if (a->r < 0) {
+      PyErr_SetString(PyExc_ValueError, "midrad radius must be nonnegative");
+      return -1;
+    }
+    return 0;
+  }
+  PyErr_Clear();
+  PyErr_SetString(PyExc_TypeError,
+                  "midrad constructor takes zero, one, or two arguments, or an interval");
+  return -1;
+}
+
+PyMemberDef pymidrad_members[] = {
+  {"m", T_DOUBLE, offsetof(PyMidrad, obval.m), 0,
+   "The midpoint of the interval"},
+  {"r", T_DOUBLE, offsetof(PyMidrad, obval.r), 0,
+   "The radius of the interval"},
+  {NULL, 0, 0, 0, NULL}
+};
+
+static PyObject *
+pymidrad_to_interval(PyObject *self, PyObject *NPY_UNUSED(args))
+{
+  return PyInterval_FromInterval(midrad_to_interval(((PyMidrad *)self)->obval));
+}
+
+static PyMethodDef pymidrad_methods[] = {
+  {"to_interval", pymidrad_to_interval, METH_NOARGS,
+   "The interval [m - r, m + r]"},
+  {NULL, NULL, 0, NULL}
+};
+
+static PyObject *
+pymidrad_repr(PyObject *o)
+{
+  char str[128];
+  midrad a = ((PyMidrad *)o)->obval;
+  sprintf(str, "(%.4g +/- %.4g)", a.m, a.r);
+  return PyUString_FromString(str);
+}
+
+static PyTypeObject PyMidrad_Type = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "interval.midrad",                          // tp_name
+  sizeof(PyMidrad),                           // tp_basicsize
+  0,                                          // tp_itemsize
+  0,                                          // tp_dealloc
+  0,                                          // tp_print
+  0,                                          // tp_getattr
+  0,                                          // tp_setattr
+  0,                                          // tp_reserved
+  pymidrad_repr,                              // tp_repr
+  0,                                          // tp_as_number
+  0,                                          // tp_as_sequence
+  0,                                          // tp_as_mapping
+  0,                                          // tp_hash
+  0,                                          // tp_call
+  pymidrad_repr,                              // tp_str
+  0,                                          // tp_getattro
+  0,                                          // tp_setattro
+  0,                                          // tp_as_buffer
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,   // tp_flags
+  "Floating-point intervals in midpoint-radius form",  // tp_doc
+  0,                                          // tp_traverse
+  0,                                          // tp_clear
+  0,                                          // tp_richcompare
+  0,                                          // tp_weaklistoffset
+  0,                                          // tp_iter
+  0,                                          // tp_iternext
+  pymidrad_methods,                           // tp_methods
+  pymidrad_members,                           // tp_members
+  0,                                          // tp_getset
+  0,                                          // tp_base; will be reset to &PyGenericArrType_Type after numpy import
+  0,                                          // tp_dict
+  0,                                          // tp_descr_get
+  0,                                          // tp_descr_set
+  0,                                          // tp_dictoffset
+  pymidrad_init,                              // tp_init
+  0,                                          // tp_alloc
+  pymidrad_new,                               // tp_new
+};
+
+static PyArray_ArrFuncs _PyMidrad_ArrFuncs;
+
+static npy_bool
+MIDRAD_nonzero (char *ip, PyArrayObject *ap)
+{
+  midrad a;
+  memcpy(&a, ip, sizeof(midrad));
+  if (ap != NULL && !PyArray_ISNOTSWAPPED(ap)) {
+    interval_byteswap8((char *)&a.m);
+    interval_byteswap8((char *)&a.r);
+  }
+  return (npy_bool) midrad_nonzero(a);
+}
+
+static int MIDRAD_setitem(PyObject* item, midrad* ap, void* NPY_UNUSED(arr))
+{
+  midrad a;
+  if (PyMidrad_Check(item)) {
+    a = ((PyMidrad *)item)->obval;
+  } else if (PyInterval_Check(item)) {
+    a = midrad_from_interval(((PyInterval *)item)->obval);
+  } else if (PySequence_Check(item) && PySequence_Length(item) == 2) {
+    PyObject *element = PySequence_GetItem(item, 0);
+    if (element == NULL) { return -1; }
+    a.m = PyFloat_AsDouble(element);
+    Py_DECREF(element);
+    element = PySequence_GetItem(item, 1);
+    if (element == NULL) { return -1; }
+    a.r = PyFloat_AsDouble(element);
+    Py_DECREF(element);
+  } else if (PyFloat_Check(item) || PyLong_Check(item)) {
+    a.m = PyFloat_AsDouble(item);
+    a.r = 0.0;
+  } else {
+    PyErr_SetString(PyExc_TypeError, "Unknown input to MIDRAD_setitem");
+    return -1;
+  }
+  if (PyErr_Occurred()) {
+    return -1;
+  }
+  memcpy(ap, &a, sizeof(midrad));
+  return 0;
+}
+
+static PyObject *
+MIDRAD_getitem(void* data, void* NPY_UNUSED(arr))
+{
+  midrad a;
+  memcpy(&a, data, sizeof(midrad));
+  return PyMidrad_FromMidrad(a);
+}
+
+static void
+MIDRAD_dot(void* ip0_, npy_intp is0, void* ip1_, npy_intp is1,
+           void* op, npy_intp n, void* NPY_UNUSED(arr)) {
+  midrad r = {0, 0};
+  const char *ip0 = (char*)ip0_, *ip1 = (char*)ip1_;
+  npy_intp i;
+  for (i = 0; i < n; i++, ip0 += is0, ip1 += is1) {
+    r = midrad_add(r, midrad_multiply(*(midrad*)ip0, *(midrad*)ip1));
+  }
+  *(midrad*)op = r;
+}
+
+// Casts between midrad, interval and the real types.
+static void
+MIDRAD_to_interval(midrad *ip, interval *op, npy_intp n,
+                   PyArrayObject *NPY_UNUSED(aip), PyArrayObject *NPY_UNUSED(aop))
+{
+  npy_intp i;
+  for (i = 0; i < n; i++) {
+    op[i] = midrad_to_interval(ip[i]);
+  }
+}
+static void
+INTERVAL_to_midrad(interval *ip, midrad *op, npy_intp n,
+                   PyArrayObject *NPY_UNUSED(aip), PyArrayObject *NPY_UNUSED(aop))
+{
+  npy_intp i;
+  for (i = 0; i < n; i++) {
+    op[i] = midrad_from_interval(ip[i]);
+  }
+}
+#define MAKE_T_TO_MIDRAD(TYPE, type)                                    \
+  static void                                                           \
+  TYPE ## _to_midrad(type *ip, midrad *op, npy_intp n,                  \
+                     PyArrayObject *NPY_UNUSED(aip), PyArrayObject *NPY_UNUSED(aop)) \
+  {                                                                     \
+    while (n--) {                                                       \
+      op->m = (double) *ip++;                                           \
+      op->r = 0.0;                                                      \
+      op++;                                                             \
+    }                                                                   \
+  }
+MAKE_T_TO_MIDRAD(FLOAT, npy_float);
+MAKE_T_TO_MIDRAD(DOUBLE, npy_double);
+MAKE_T_TO_MIDRAD(BOOL, npy_bool);
+MAKE_T_TO_MIDRAD(INT, npy_int);
+MAKE_T_TO_MIDRAD(LONG, npy_long);
+MAKE_T_TO_MIDRAD(LONGLONG, npy_longlong);
+
+// Elementwise loops, threaded like the interval ones.
+#define MIDRAD_UNARY_UFUNC(name, grain)                                 \
+  NPY_FINLINE void                                                      \
+  interval_midrad_##name##_run(char *ip1, char *op1, npy_intp is1,     \
+                               npy_intp os1, npy_intp n) {             \
+    npy_intp i;                                                         \
+    for(i = 0; i < n; i++) {                                            \
+      *((midrad *)(op1 + i*os1)) = midrad_##name(*(midrad *)(ip1 + i*is1)); \
+    }                                                                   \
+  }                                                                     \
+  static void                                                           \
+  interval_midrad_##name##_contig_loop(char** args, npy_intp* dimensions, \
+                                       npy_intp* NPY_UNUSED(steps), void* NPY_UNUSED(data)) { \
+    interval_midrad_##name##_run(args[0], args[1], sizeof(midrad),     \
+                                 sizeof(midrad), dimensions[0]);       \
+  }                                                                     \
+  static void                                                           \
+  interval_midrad_##name##_loop(char** args, npy_intp* dimensions,      \
+                                npy_intp* steps, void* data) {          \
+    if (steps[0] == sizeof(midrad) && steps[1] == sizeof(midrad)) {     \
+      interval_midrad_##name##_contig_loop(args, dimensions, steps, data); \
+      return;                                                           \
+    }                                                                   \
+    interval_midrad_##name##_run(args[0], args[1], steps[0], steps[1], dimensions[0]); \
+  }                                                                     \
+  THREADED_UFUNC(midrad_##name, 2, grain)
+#define MIDRAD_BINARY_UFUNC(ufunc_name, func_name, arg_type1, arg_type2, grain) \
+  NPY_FINLINE void                                                      \
+  interval_midrad_##ufunc_name##_run(char *ip1, char *ip2, char *op1, npy_intp is1, \
+                                     npy_intp is2, npy_intp os1, npy_intp n) { \
+    npy_intp i;                                                         \
+    for(i = 0; i < n; i++) {                                            \
+      const arg_type1 in1 = *(arg_type1 *)(ip1 + i*is1);                \
+      const arg_type2 in2 = *(arg_type2 *)(ip2 + i*is2);                \
+      *((midrad *)(op1 + i*os1)) = midrad_##func_name(in1, in2);        \
+    }                                                                   \
+  }                                                                     \
+  static void                                                           \
+  interval_midrad_##ufunc_name##_contig_loop(char** args, npy_intp* dimensions, \
+                                             npy_intp* NPY_UNUSED(steps), void* NPY_UNUSED(data)) { \
+    interval_midrad_##ufunc_name##_run(args[0], args[1], args[2], sizeof(arg_type1), \
+                                       sizeof(arg_type2), sizeof(midrad), dimensions[0]); \
+  }                                                                     \
+  static void                                                           \
+  interval_midrad_##ufunc_name##_loop(char** args, npy_intp* dimensions, \
+                                      npy_intp* steps, void* data) {    \
+    if (steps[0] == sizeof(arg_type1) && steps[1] == sizeof(arg_type2) && \
+        steps[2] == sizeof(midrad)) {                                   \
+      interval_midrad_##ufunc_name##_contig_loop(args, dimensions, steps, data); \
+      return;                                                           \
+    }                                                                   \
+    interval_midrad_##ufunc_name##_run(args[0], args[1], args[2], steps[0], \
+                                       steps[1], steps[2], dimensions[0]); \
+  }                                                                     \
+  THREADED_UFUNC(midrad_##ufunc_name, 3, grain)
+MIDRAD_UNARY_UFUNC(negative, INTERVAL_GRAIN_CHEAP)
+MIDRAD_BINARY_UFUNC(add, add, midrad, midrad, INTERVAL_GRAIN_CHEAP)
+MIDRAD_BINARY_UFUNC(add_scalar, add_scalar, midrad, npy_double, INTERVAL_GRAIN_CHEAP)
+MIDRAD_BINARY_UFUNC(scalar_add, scalar_add, npy_double, midrad, INTERVAL_GRAIN_CHEAP)
+MIDRAD_BINARY_UFUNC(subtract, subtract, midrad, midrad, INTERVAL_GRAIN_CHEAP)
+MIDRAD_BINARY_UFUNC(subtract_scalar, subtract_scalar, midrad, npy_double, INTERVAL_GRAIN_CHEAP)
+MIDRAD_BINARY_UFUNC(scalar_subtract, scalar_subtract, npy_double, midrad, INTERVAL_GRAIN_CHEAP)
+MIDRAD_BINARY_UFUNC(multiply, multiply, midrad, midrad, INTERVAL_GRAIN_MULTIPLY)
+MIDRAD_BINARY_UFUNC(multiply_scalar, multiply_scalar, midrad, npy_double, INTERVAL_GRAIN_MULTIPLY)
+MIDRAD_BINARY_UFUNC(scalar_multiply, scalar_multiply, npy_double, midrad, INTERVAL_GRAIN_MULTIPLY)
+MIDRAD_BINARY_UFUNC(true_divide_scalar, divide_scalar, midrad, npy_double, INTERVAL_GRAIN_MULTIPLY)
+
+// Products with fewer multiply-adds than this are computed here; larger
+// ones go through numpy's float64 matmul, and so BLAS.
+#define MIDRAD_BLAS_MIN_FLOPS 32768
+
+// C = A @ B for one (m,n) @ (n,p) product with the given strides:
+//   mid(C) = mid(A) @ mid(B)
+//   rad(C) = |mid(A)| @ rad(B) + rad(A) @ (|mid(B)| + rad(B))
+static void
+midrad_matmul_native(char *ip1, char *ip2, char *op, npy_intp dm, npy_intp dn, npy_intp dp,
+                     npy_intp is1_m, npy_intp is1_n, npy_intp is2_n, npy_intp is2_p,
+                     npy_intp os_m, npy_intp os_p)
+{
+  npy_intp i, j, k;
+  for (i = 0; i < dm; i++) {
+    for (j = 0; j < dp; j++) {
+      double m = 0, r = 0;
+      for (k = 0; k < dn; k++) {
+        const midrad a = *(midrad *)(ip1 + i*is1_m + k*is1_n);
+        const midrad b = *(midrad *)(ip2 + k*is2_n + j*is2_p);
+        m += a.m*b.m;
+        r += fabs(a.m)*b.r + a.r*(fabs(b.m) + b.r);
+      }
+      *(midrad *)(op + i*os_m + j*os_p) = (midrad) { m, r };
+    }
+  }
+}
+
+// The same product as two float64 matmuls, with the two radius terms
+// stacked into one: rad(C) = [|mid(A)|  rad(A)] @ [rad(B); |mid(B)| + rad(B)].
+// Runs with the GIL held; returns -1, with no Python error left set, if
+// an array could not be allocated.
+static int
+midrad_matmul_blas(char *ip1, char *ip2, char *op, npy_intp dm, npy_intp dn, npy_intp dp,
+                   npy_intp is1_m, npy_intp is1_n, npy_intp is2_n, npy_intp is2_p,
+                   npy_intp os_m, npy_intp os_p)
+{
+  npy_intp da[2] = { dm, dn }, dar[2] = { dm, 2*dn }, db[2] = { dn, dp }, dbr[2] = { 2*dn, dp };
+  PyArrayObject *Am = NULL, *Ar = NULL, *Bm = NULL, *Br = NULL, *Cm = NULL, *Cr = NULL;
+  double *am, *ar, *bm, *br, *cm, *cr;
+  npy_intp i, j, k;
+  int ret = -1;
+
+  Am = (PyArrayObject *)PyArray_SimpleNew(2, da, NPY_DOUBLE);
+  Ar = (PyArrayObject *)PyArray_SimpleNew(2, dar, NPY_DOUBLE);
+  Bm = (PyArrayObject *)PyArray_SimpleNew(2, db, NPY_DOUBLE);
+  Br = (PyArrayObject *)PyArray_SimpleNew(2, dbr, NPY_DOUBLE);
+  if (Am == NULL || Ar == NULL || Bm == NULL || Br == NULL) {
+    goto done;
+  }
+  am = (double *)PyArray_DATA(Am);
+  ar = (double *)PyArray_DATA(Ar);
+  bm = (double *)PyArray_DATA(Bm);
+  br = (double *)PyArray_DATA(Br);
+  for (i = 0; i < dm; i++) {
+    for (k = 0; k < dn; k++) {
+      const midrad a = *(midrad *)(ip1 + i*is1_m + k*is1_n);
+      am[i*dn + k] = a.m;
+      ar[i*2*dn + k] = fabs(a.m);
+      ar[i*2*dn + dn + k] = a.r;
+    }
+  }
+  for (k = 0; k < dn; k++) {
+    for (j = 0; j < dp; j++) {
+      const midrad b = *(midrad *)(ip2 + k*is2_n + j*is2_p);
+      bm[k*dp + j] = b.m;
+      br[k*dp + j] = b.r;
+      br[(dn + k)*dp + j] = fabs(b.m) + b.r;
+    }
+  }
+  Cm = (PyArrayObject *)PyArray_MatrixProduct2((PyObject *)Am, (PyObject *)Bm, NULL);
+  Cr = Cm == NULL ? NULL : (PyArrayObject *)PyArray_MatrixProduct2((PyObject *)Ar, (PyObject *)Br, NULL);
+  if (Cr == NULL) {
+    goto done;
+  }
+  cm = (double *)PyArray_DATA(Cm);
+  cr = (double *)PyArray_DATA(Cr);
+  for (i = 0; i < dm; i++) {
+    for (j = 0; j < dp; j++) {
+      *(midrad *)(op + i*os_m + j*os_p) = (midrad) { cm[i*dp + j], cr[i*dp + j] };
+    }
+  }
+  ret = 0;
+
+done:
+  Py_XDECREF(Am);
+  Py_XDECREF(Ar);
+  Py_XDECREF(Bm);
+  Py_XDECREF(Br);
+  Py_XDECREF(Cm);
+  Py_XDECREF(Cr);
+  if (ret < 0) {
+    PyErr_Clear();
+  }
+  return ret;
+}
+
+static void
+midrad_matmul_ufunc(char **args, npy_intp *dimensions, npy_intp *steps, void *NPY_UNUSED(func))
+{
+  npy_intp N_, dN = dimensions[0];
+  npy_intp dm = dimensions[1], dn = dimensions[2], dp = dimensions[3];
+  npy_intp s0 = steps[0], s1 = steps[1], s2 = steps[2];
+  npy_intp *cs = steps + 3;
+  int blas = dm*dn*dp >= MIDRAD_BLAS_MIN_FLOPS;
+  PyGILState_STATE gil;
+
+  if (blas) {
+    gil = PyGILState_Ensure();
+  }
+  for (N_ = 0; N_ < dN; N_++, args[0] += s0, args[1] += s1, args[2] += s2) {
+    if (!blas || midrad_matmul_blas(args[0], args[1], args[2], dm, dn, dp,
+                                    cs[0], cs[1], cs[2], cs[3], cs[4], cs[5]) < 0) {
+      midrad_matmul_native(args[0], args[1], args[2], dm, dn, dp,
+                           cs[0], cs[1], cs[2], cs[3], cs[4], cs[5]);
+    }
+  }
+  if (blas) {
+    PyGILState_Release(gil);
+  }
+}
+GUFUNC_METHOD(midrad_matmul, 3)
+
+// Stable argsort of an interval array along its last axis by one of the
+// INTERVAL_KEY_* keys from interval_sort.h.
+static PyObject *
+interval_argsort_by_key(PyObject *a, int key)
+{
+  PyArrayObject *arr, *ret;
+  npy_intp n, rows, r;
+  int err = 0;
+  const interval *src;
+  npy_intp *dst;
+
+  Py_INCREF(interval_descr);
+  arr = (PyArrayObject *)PyArray_FromAny(a, interval_descr, 1, 0, NPY_ARRAY_CARRAY_RO, NULL);
+  if (arr == NULL) {
+    return NULL;
+  }
+  ret = (PyArrayObject *)PyArray_SimpleNew(PyArray_NDIM(arr), PyArray_DIMS(arr), NPY_INTP);
+  if (ret == NULL) {
+    Py_DECREF(arr);
+    return NULL;
+  }
+  n = PyArray_DIM(arr, PyArray_NDIM(arr) - 1);
+  rows = (n == 0) ? 0 : PyArray_SIZE(arr) / n;
+  src = (const interval *)PyArray_DATA(arr);
+  dst = (npy_intp *)PyArray_DATA(ret);
+
+  Py_BEGIN_ALLOW_THREADS
+  for (r = 0; r < rows && !err; r++, src += n, dst += n) {
+    err = interval_argsort_key(src, dst, n, key);
+  }
+  Py_END_ALLOW_THREADS
+
+  Py_DECREF(arr);
+  if (err) {
+    Py_DECREF(ret);
+    return PyErr_NoMemory();
+  }
+  return (PyObject *)ret;
+}
+
+static PyObject *
+interval_argsort_midpoint(PyObject *NPY_UNUSED(self), PyObject *a)
+{
+  return interval_argsort_by_key(a, INTERVAL_KEY_MIDPOINT);
+}
+
+static PyObject *
+interval_argsort_width(PyObject *NPY_UNUSED(self), PyObject *a)
+{
+  return interval_argsort_by_key(a, INTERVAL_KEY_WIDTH);
+}
+
+// csr_matmul(indptr, indices, data, b, m): the product of the m-row CSR
+// matrix (indptr, indices, data) with the 2-D array b, as an m x k
+// interval array.  data and b are interval or float64 arrays, not both
+// float64; interval/sparse.py does the conversions.
+static PyObject *
+interval_csr_matmul_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *oindptr, *oindices, *odata, *ob;
+  PyArrayObject *indptr = NULL, *indices = NULL, *data = NULL, *b = NULL, *ret = NULL;
+  npy_intp m, n, k, i, nnz, dims[2];
+  const npy_intp *ip, *ix;
+  int data_iv, b_iv;
+
+  if (!PyArg_ParseTuple(args, "OOOOn", &oindptr, &oindices, &odata, &ob, &m)) {
+    return NULL;
+  }
+  indptr = (PyArrayObject *)PyArray_FROM_OTF(oindptr, NPY_INTP, NPY_ARRAY_CARRAY_RO);
+  indices = (PyArrayObject *)PyArray_FROM_OTF(oindices, NPY_INTP, NPY_ARRAY_CARRAY_RO);
+  if (indptr == NULL || indices == NULL) {
+    goto fail;
+  }
+  data_iv = PyArray_Check(odata) && PyArray_TYPE((PyArrayObject *)odata) == interval_descr->type_num;
+  b_iv = PyArray_Check(ob) && PyArray_TYPE((PyArrayObject *)ob) == interval_descr->type_num;
+  if (!data_iv && !b_iv) {
+    PyErr_SetString(PyExc_TypeError, "csr_matmul needs interval data or an interval operand");
+    goto fail;
+  }
+  if (data_iv) {
+    Py_INCREF(interval_descr);
+    data = (PyArrayObject *)PyArray_FromAny(odata, interval_descr, 1, 1, NPY_ARRAY_CARRAY_RO, NULL);
+  } else {
+    data = (PyArrayObject *)PyArray_FROM_OTF(odata, NPY_DOUBLE, NPY_ARRAY_CARRAY_RO);
+  }
+  if (b_iv) {
+    Py_INCREF(interval_descr);
+    b = (PyArrayObject *)PyArray_FromAny(ob, interval_descr, 2, 2, NPY_ARRAY_CARRAY_RO, NULL);
+  } else {
+    b = (PyArrayObject *)PyArray_FROM_OTF(ob, NPY_DOUBLE, NPY_ARRAY_CARRAY_RO);
+  }
+  if (data == NULL || b == NULL) {
+    goto fail;
+  }
+  if (PyArray_NDIM(indptr) != 1 || PyArray_NDIM(indices) != 1 || PyArray_NDIM(data) != 1 ||
+      PyArray_NDIM(b) != 2 || m < 0 || PyArray_DIM(indptr, 0) != m + 1) {
+    PyErr_SetString(PyExc_ValueError, "csr_matmul: inconsistent CSR arrays or operand shape");
+    goto fail;
+  }
+  n = PyArray_DIM(b, 0);
+  k = PyArray_DIM(b, 1);
+  ip = (const npy_intp *)PyArray_DATA(indptr);
+  ix = (const npy_intp *)PyArray_DATA(indices);
+  nnz = ip[m];
+  if (ip[0] < 0 || nnz > PyArray_DIM(indices, 0) || nnz > PyArray_DIM(data, 0)) {
+    PyErr_SetString(PyExc_ValueError, "csr_matmul: indptr out of range");
+    goto fail;
+  }
+  for (i = 0; i < m; i++) {
+    if (ip[i] > ip[i+1]) {
+      PyErr_SetString(PyExc_ValueError, "csr_matmul: indptr must be non-decreasing");
+      goto fail;
+    }
+  }
+  for (i = ip[0]; i < nnz; i++) {
+    if (ix[i] < 0 || ix[i] >= n) {
+      PyErr_SetString(PyExc_ValueError, "csr_matmul: column index out of range");
+      goto fail;
+    }
+  }
+
+  dims[0] = m;
+  dims[1] = k;
+  Py_INCREF(interval_descr);
+  ret = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 2, dims,
+                                              NULL, NULL, 0, NULL);
+  if (ret == NULL) {
+    goto fail;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  if (data_iv && b_iv) {
+    interval_csr_matmul_ii(m, k, ip, ix, (const interval *)PyArray_DATA(data),
+                           (const interval *)PyArray_DATA(b), (interval *)PyArray_DATA(ret));
+  } else if (b_iv) {
+    interval_csr_matmul_di(m, k, ip, ix, (const double *)PyArray_DATA(data),
+                           (const interval *)PyArray_DATA(b), (interval *)PyArray_DATA(ret));
+  } else {
+    interval_csr_matmul_id(m, k, ip, ix, (const interval *)PyArray_DATA(data),
+                           (const double *)PyArray_DATA(b), (interval *)PyArray_DATA(ret));
+  }
+  Py_END_ALLOW_THREADS
+
+  Py_DECREF(indptr);
+  Py_DECREF(indices);
+  Py_DECREF(data);
+  Py_DECREF(b);
+  return (PyObject *)ret;
+
+ fail:
+  Py_XDECREF(indptr);
+  Py_XDECREF(indices);
+  Py_XDECREF(data);
+  Py_XDECREF(b);
+  return NULL;
+}
+
+// C-contiguous interval array with exactly ndim dimensions, or NULL.
+static PyArrayObject *
+interval_carray(PyObject *o, int ndim)
+{
+  Py_INCREF(interval_descr);
+  return (PyArrayObject *)PyArray_FromAny(o, interval_descr, ndim, ndim, NPY_ARRAY_CARRAY_RO, NULL);
+}
+
+// matmul_stack(A, B): A[b] @ B[b] for interval stacks A (batch, m, k) and
+// B (batch, k, n), threaded over the rows of the whole stack.
+static PyObject *
+interval_matmul_stack_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *oA, *oB;
+  PyArrayObject *A = NULL, *B = NULL, *C = NULL;
+  interval_matmul_stack_ctx ctx;
+  npy_intp dims[3];
+
+  if (!PyArg_ParseTuple(args, "OO", &oA, &oB)) {
+    return NULL;
+  }
+  A = interval_carray(oA, 3);
+  B = interval_carray(oB, 3);
+  if (A == NULL || B == NULL) {
+    goto done;
+  }
+  if (PyArray_DIM(B, 0) != PyArray_DIM(A, 0) || PyArray_DIM(B, 1) != PyArray_DIM(A, 2)) {
+    PyErr_SetString(PyExc_ValueError, "matmul_stack: expected A (batch, m, k) and B (batch, k, n)");
+    goto done;
+  }
+  dims[0] = PyArray_DIM(A, 0);
+  dims[1] = PyArray_DIM(A, 1);
+  dims[2] = PyArray_DIM(B, 2);
+  Py_INCREF(interval_descr);
+  C = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 3, dims,
+                                            NULL, NULL, 0, NULL);
+  if (C == NULL) {
+    goto done;
+  }
+  ctx = (interval_matmul_stack_ctx) { (interval *)PyArray_DATA(A), (interval *)PyArray_DATA(B),
+                                      (interval *)PyArray_DATA(C), dims[1], PyArray_DIM(A, 2),
+                                      dims[2] };
+  Py_BEGIN_ALLOW_THREADS
+  interval_parallel_for(dims[0]*dims[1], INTERVAL_GRAIN_MULTIPLY/(ctx.k*ctx.n + 1) + 1,
+                        interval_matmul_stack_range, &ctx);
+  Py_END_ALLOW_THREADS
+
+ done:
+  Py_XDECREF(A);
+  Py_XDECREF(B);
+  return (PyObject *)C;
+}
+
+// det_stack(A) and inv_stack(A): determinants (count,) and inverses
+// (count, n, n) of a stack A (count, n, n) of interval matrices.
+static PyObject *
+interval_det_inv_stack(PyObject *oA, int inverse)
+{
+  PyArrayObject *A, *out;
+  npy_intp count, n;
+  int err;
+
+  A = interval_carray(oA, 3);
+  if (A == NULL) {
+    return NULL;
+  }
+  count = PyArray_DIM(A, 0);
+  n = PyArray_DIM(A, 1);
+  if (PyArray_DIM(A, 2) != n) {
+    PyErr_SetString(PyExc_ValueError, "expected a stack of square matrices (count, n, n)");
+    Py_DECREF(A);
+    return NULL;
+  }
+  Py_INCREF(interval_descr);
+  out = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, inverse ? 3 : 1,
+                                              PyArray_DIMS(A), NULL, NULL, 0, NULL);
+  if (out == NULL) {
+    Py_DECREF(A);
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  if (inverse) {
+    err = interval_inv(n, (const interval *)PyArray_DATA(A), (interval *)PyArray_DATA(out), count);
+  } else {
+    err = interval_det(n, (const interval *)PyArray_DATA(A), (interval *)PyArray_DATA(out), count);
+  }
+  Py_END_ALLOW_THREADS
+  Py_DECREF(A);
+  if (err) {
+    Py_DECREF(out);
+    return PyErr_NoMemory();
+  }
+  return (PyObject *)out;
+}
+
+static PyObject *
+interval_det_stack_py(PyObject *NPY_UNUSED(self), PyObject *A)
+{
+  return interval_det_inv_stack(A, 0);
+}
+
+static PyObject *
+interval_inv_stack_py(PyObject *NPY_UNUSED(self), PyObject *A)
+{
+  return interval_det_inv_stack(A, 1);
+}
+
+// expm_stack(A, h): exp(A[k] h[k]) for a stack A (count, n, n) of
+// interval matrices and steps h (count,), by scaling and squaring.
+static PyObject *
+interval_expm_stack_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *oA, *oh;
+  PyArrayObject *A = NULL, *h = NULL, *X = NULL;
+  interval_expm_ctx ctx;
+  npy_intp count, n;
+
+  if (!PyArg_ParseTuple(args, "OO", &oA, &oh)) {
+    return NULL;
+  }
+  A = interval_carray(oA, 3);
+  h = (PyArrayObject *)PyArray_FROM_OTF(oh, NPY_DOUBLE, NPY_ARRAY_CARRAY_RO);
+  if (A == NULL || h == NULL) {
+    goto done;
+  }
+  count = PyArray_DIM(A, 0);
+  n = PyArray_DIM(A, 1);
+  if (PyArray_DIM(A, 2) != n || PyArray_NDIM(h) != 1 || PyArray_DIM(h, 0) != count) {
+    PyErr_SetString(PyExc_ValueError, "expm_stack: expected A (count, n, n) and h (count,)");
+    goto done;
+  }
+  Py_INCREF(interval_descr);
+  X = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 3, PyArray_DIMS(A),
+                                            NULL, NULL, 0, NULL);
+  if (X == NULL) {
+    goto done;
+  }
+  ctx = (interval_expm_ctx) { (const interval *)PyArray_DATA(A), (const double *)PyArray_DATA(h),
+                              (interval *)PyArray_DATA(X), n, 0 };
+  Py_BEGIN_ALLOW_THREADS
+  interval_parallel_for(count, EXPM_GRAIN_TERMS/(n*n*n + 1) + 1, interval_expm_range, &ctx);
+  Py_END_ALLOW_THREADS
+  if (ctx.failed) {
+    Py_CLEAR(X);
+    PyErr_NoMemory();
+  }
+
+ done:
+  Py_XDECREF(A);
+  Py_XDECREF(h);
+  return (PyObject *)X;
+}
+
+// precondition(A, b, C): (C A, C b) for stacks A (batch, n, n) and
+// b (batch, n) of intervals and C (batch, n, n) of doubles.
+static PyObject *
+interval_precondition_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *oA, *ob, *oC, *res = NULL;
+  PyArrayObject *A = NULL, *b = NULL, *C = NULL, *Ap = NULL, *bp = NULL;
+  npy_intp batch, n;
+
+  if (!PyArg_ParseTuple(args, "OOO", &oA, &ob, &oC)) {
+    return NULL;
+  }
+  A = interval_carray(oA, 3);
+  b = interval_carray(ob, 2);
+  C = (PyArrayObject *)PyArray_FROM_OTF(oC, NPY_DOUBLE, NPY_ARRAY_CARRAY_RO);
+  if (A == NULL || b == NULL || C == NULL) {
+    goto done;
+  }
+  batch = PyArray_DIM(A, 0);
+  n = PyArray_DIM(A, 1);
+  if (PyArray_DIM(A, 2) != n || PyArray_DIM(b, 0) != batch || PyArray_DIM(b, 1) != n ||
+      PyArray_NDIM(C) != 3 || PyArray_DIM(C, 0) != batch || PyArray_DIM(C, 1) != n ||
+      PyArray_DIM(C, 2) != n) {
+    PyErr_SetString(PyExc_ValueError, "precondition: expected A (batch, n, n), b (batch, n), C (batch, n, n)");
+    goto done;
+  }
+  Py_INCREF(interval_descr);
+  Ap = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 3, PyArray_DIMS(A),
+                                             NULL, NULL, 0, NULL);
+  Py_INCREF(interval_descr);
+  bp = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 2, PyArray_DIMS(b),
+                                             NULL, NULL, 0, NULL);
+  if (Ap == NULL || bp == NULL) {
+    goto done;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  interval_precondition(batch, n, (const double *)PyArray_DATA(C),
+                        (const interval *)PyArray_DATA(A), (const interval *)PyArray_DATA(b),
+                        (interval *)PyArray_DATA(Ap), (interval *)PyArray_DATA(bp));
+  Py_END_ALLOW_THREADS
+  res = Py_BuildValue("OO", Ap, bp);
+
+ done:
+  Py_XDECREF(A);
+  Py_XDECREF(b);
+  Py_XDECREF(C);
+  Py_XDECREF(Ap);
+  Py_XDECREF(bp);
+  return res;
+}
+
+// linsolve(Ap, bp, x0, method, maxiter, tol, M): solve preconditioned
+// systems with method 0 (Gauss-Seidel), 1 (Krawczyk) or 2 (Hansen-Bliek,
+// which needs M).  x0 may be None.  Returns (x, status).
+static PyObject *
+interval_linsolve_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *oA, *ob, *ox, *oM, *res = NULL;
+  PyArrayObject *Ap = NULL, *bp = NULL, *M = NULL, *x = NULL, *status = NULL;
+  npy_intp batch, n;
+  int method, maxiter, have_x0 = 0;
+  double tol;
+
+  if (!PyArg_ParseTuple(args, "OOOiidO", &oA, &ob, &ox, &method, &maxiter, &tol, &oM)) {
+    return NULL;
+  }
+  Ap = interval_carray(oA, 3);
+  bp = interval_carray(ob, 2);
+  if (Ap == NULL || bp == NULL) {
+    goto done;
+  }
+  batch = PyArray_DIM(Ap, 0);
+  n = PyArray_DIM(Ap, 1);
+  if (PyArray_DIM(Ap, 2) != n || PyArray_DIM(bp, 0) != batch || PyArray_DIM(bp, 1) != n) {
+    PyErr_SetString(PyExc_ValueError, "linsolve: expected Ap (batch, n, n) and bp (batch, n)");
+    goto done;
+  }
+  if (method < 0 || method > 2) {
+    PyErr_SetString(PyExc_ValueError, "linsolve: unknown method");
+    goto done;
+  }
+  if (method == 2) {
+    M = (PyArrayObject *)PyArray_FROM_OTF(oM, NPY_DOUBLE, NPY_ARRAY_CARRAY_RO);
+    if (M == NULL) {
+      goto done;
+    }
+    if (PyArray_NDIM(M) != 3 || PyArray_DIM(M, 0) != batch || PyArray_DIM(M, 1) != n ||
+        PyArray_DIM(M, 2) != n) {
+      PyErr_SetString(PyExc_ValueError, "linsolve: expected M (batch, n, n)");
+      goto done;
+    }
+  }
+  if (ox != Py_None) {
+    Py_INCREF(interval_descr);
+    x = (PyArrayObject *)PyArray_FromAny(ox, interval_descr, 2, 2,
+                                         NPY_ARRAY_CARRAY | NPY_ARRAY_ENSURECOPY, NULL);
+    if (x == NULL) {
+      goto done;
+    }
+    if (PyArray_DIM(x, 0) != batch || PyArray_DIM(x, 1) != n) {
+      PyErr_SetString(PyExc_ValueError, "linsolve: expected x0 (batch, n)");
+      goto done;
+    }
+    have_x0 = 1;
+  } else {
+    Py_INCREF(interval_descr);
+    x = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 2, PyArray_DIMS(bp),
+                                              NULL, NULL, 0, NULL);
+    if (x == NULL) {
+      goto done;
+    }
+  }
+  status = (PyArrayObject *)PyArray_SimpleNew(1, &batch, NPY_INT);
+  if (status == NULL) {
+    goto done;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  if (method == 2) {
+    interval_hansen_bliek(batch, n, (const interval *)PyArray_DATA(Ap),
+                          (const interval *)PyArray_DATA(bp), (const double *)PyArray_DATA(M),
+                          (interval *)PyArray_DATA(x), (int *)PyArray_DATA(status), have_x0);
+  } else {
+    interval_linsolve_iterate(batch, n, (const interval *)PyArray_DATA(Ap),
+                              (const interval *)PyArray_DATA(bp), (interval *)PyArray_DATA(x),
+                              (int *)PyArray_DATA(status), method, have_x0, maxiter, tol);
+  }
+  Py_END_ALLOW_THREADS
+  res = Py_BuildValue("OO", x, status);
+
+ done:
+  Py_XDECREF(Ap);
+  Py_XDECREF(bp);
+  Py_XDECREF(M);
+  Py_XDECREF(x);
+  Py_XDECREF(status);
+  return res;
+}
+
+// krawczyk(X, c, fc, J, C): the Krawczyk operator over a stack of boxes
+// X (batch, n), see interval_newton.h.  Returns (K(X) & X, verdict).
+static PyObject *
+interval_krawczyk_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *oX, *oc, *ofc, *oJ, *oC, *res = NULL;
+  PyArrayObject *X = NULL, *c = NULL, *fc = NULL, *J = NULL, *C = NULL, *Y = NULL, *verdict = NULL;
+  npy_intp batch, n;
+
+  if (!PyArg_ParseTuple(args, "OOOOO", &oX, &oc, &ofc, &oJ, &oC)) {
+    return NULL;
+  }
+  X = interval_carray(oX, 2);
+  fc = interval_carray(ofc, 2);
+  J = interval_carray(oJ, 3);
+  c = (PyArrayObject *)PyArray_FROM_OTF(oc, NPY_DOUBLE, NPY_ARRAY_CARRAY_RO);
+  C = (PyArrayObject *)PyArray_FROM_OTF(oC, NPY_DOUBLE, NPY_ARRAY_CARRAY_RO);
+  if (X == NULL || fc == NULL || J == NULL || c == NULL || C == NULL) {
+    goto done;
+  }
+  batch = PyArray_DIM(X, 0);
+  n = PyArray_DIM(X, 1);
+  if (PyArray_NDIM(c) != 2 || PyArray_DIM(c, 0) != batch || PyArray_DIM(c, 1) != n ||
+      PyArray_DIM(fc, 0) != batch || PyArray_DIM(fc, 1) != n ||
+      PyArray_DIM(J, 0) != batch || PyArray_DIM(J, 1) != n || PyArray_DIM(J, 2) != n ||
+      PyArray_NDIM(C) != 3 || PyArray_DIM(C, 0) != batch || PyArray_DIM(C, 1) != n ||
+      PyArray_DIM(C, 2) != n) {
+    PyErr_SetString(PyExc_ValueError,
+                    "krawczyk: expected X, c, fc (batch, n) and J, C (batch, n, n)");
+    goto done;
+  }
+  Py_INCREF(interval_descr);
+  Y = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 2, PyArray_DIMS(X),
+                                            NULL, NULL, 0, NULL);
+  verdict = (PyArrayObject *)PyArray_SimpleNew(1, &batch, NPY_INT8);
+  if (Y == NULL || verdict == NULL) {
+    goto done;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  interval_krawczyk(batch, n, (const interval *)PyArray_DATA(X), (const double *)PyArray_DATA(c),
+                    (const interval *)PyArray_DATA(fc), (const interval *)PyArray_DATA(J),
+                    (const double *)PyArray_DATA(C), (interval *)PyArray_DATA(Y),
+                    (int8_t *)PyArray_DATA(verdict));
+  Py_END_ALLOW_THREADS
+  res = Py_BuildValue("OO", Y, verdict);
+
+ done:
+  Py_XDECREF(X);
+  Py_XDECREF(c);
+  Py_XDECREF(fc);
+  Py_XDECREF(J);
+  Py_XDECREF(C);
+  Py_XDECREF(Y);
+  Py_XDECREF(verdict);
+  return res;
+}
+
+// hc4_contract(ops, args, consts, roots, bounds, boxes, maxiter, ratio):
+// HC4 contraction of an (m, n) interval array of boxes under the
+// constraints of an expression DAG (interval_contract.h) given as int32
+// ops (N,), int32 operands args (N, 2) and interval consts (N,), with
+// int32 roots (R,) and interval bounds (R,).  Returns (boxes, verdict).
+static PyObject *
+interval_hc4_contract_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *oops, *oargs, *oconsts, *oroots, *obounds, *oboxes, *res = NULL;
+  PyArrayObject *ops = NULL, *operands = NULL, *consts = NULL, *roots = NULL, *bounds = NULL;
+  PyArrayObject *boxes = NULL, *verdict = NULL;
+  interval_hc4_node *nodes = NULL;
+  npy_intp num_nodes, num_roots, count, n, k;
+  int maxiter, err;
+  double ratio;
+
+  if (!PyArg_ParseTuple(args, "OOOOOOid", &oops, &oargs, &oconsts, &oroots, &obounds, &oboxes,
+                        &maxiter, &ratio)) {
+    return NULL;
+  }
+  ops = (PyArrayObject *)PyArray_FROM_OTF(oops, NPY_INT32, NPY_ARRAY_CARRAY_RO);
+  operands = (PyArrayObject *)PyArray_FROM_OTF(oargs, NPY_INT32, NPY_ARRAY_CARRAY_RO);
+  roots = (PyArrayObject *)PyArray_FROM_OTF(oroots, NPY_INT32, NPY_ARRAY_CARRAY_RO);
+  consts = interval_carray(oconsts, 1);
+  bounds = interval_carray(obounds, 1);
+  Py_INCREF(interval_descr);
+  boxes = (PyArrayObject *)PyArray_FromAny(oboxes, interval_descr, 2, 2,
+                                           NPY_ARRAY_CARRAY | NPY_ARRAY_ENSURECOPY, NULL);
+  if (ops == NULL || operands == NULL || roots == NULL || consts == NULL || bounds == NULL ||
+      boxes == NULL) {
+    goto done;
+  }
+  num_nodes = PyArray_SIZE(ops);
+  num_roots = PyArray_SIZE(roots);
+  count = PyArray_DIM(boxes, 0);
+  n = PyArray_DIM(boxes, 1);
+  if (PyArray_NDIM(ops) != 1 || PyArray_NDIM(operands) != 2 || PyArray_DIM(operands, 0) != num_nodes ||
+      PyArray_DIM(operands, 1) != 2 || PyArray_DIM(consts, 0) != num_nodes ||
+      PyArray_NDIM(roots) != 1 || PyArray_DIM(bounds, 0) != num_roots) {
+    PyErr_SetString(PyExc_ValueError,
+                    "hc4_contract: expected ops, consts (N,), args (N, 2) and roots, bounds (R,)");
+    goto done;
+  }
+  nodes = malloc((num_nodes + 1)*sizeof(interval_hc4_node));
+  if (nodes == NULL) {
+    PyErr_NoMemory();
+    goto done;
+  }
+  for (k = 0; k < num_nodes; k++) {
+    const int32_t *ab = (const int32_t *)PyArray_DATA(operands) + 2*k;
+    int32_t op = ((const int32_t *)PyArray_DATA(ops))[k];
+    int unary = op >= INTERVAL_HC4_NEG;
+    nodes[k].op = op;
+    nodes[k].a = op == INTERVAL_HC4_CONST ? 0 : ab[0];
+    nodes[k].b = op < INTERVAL_HC4_ADD || unary ? nodes[k].a : ab[1];
+    nodes[k].value = ((const interval *)PyArray_DATA(consts))[k];
+    if (op < 0 || op >= INTERVAL_HC4_NUM_OPS ||
+        (op == INTERVAL_HC4_VAR && (nodes[k].a < 0 || nodes[k].a >= n)) ||
+        (op > INTERVAL_HC4_VAR && (nodes[k].a < 0 || nodes[k].a >= k || nodes[k].b < 0 || nodes[k].b >= k))) {
+      PyErr_Format(PyExc_ValueError, "hc4_contract: invalid node %zd", (Py_ssize_t)k);
+      goto done;
+    }
+  }
+  for (k = 0; k < num_roots; k++) {
+    int32_t r = ((const int32_t *)PyArray_DATA(roots))[k];
+    if (r < 0 || r >= num_nodes) {
+      PyErr_Format(PyExc_ValueError, "hc4_contract: invalid root %d", (int)r);
+      goto done;
+    }
+  }
+  verdict = (PyArrayObject *)PyArray_SimpleNew(1, &count, NPY_INT8);
+  if (verdict == NULL) {
+    goto done;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  err = interval_hc4_contract(nodes, num_nodes, (const int32_t *)PyArray_DATA(roots),
+                              (const interval *)PyArray_DATA(bounds), num_roots, n,
+                              (interval *)PyArray_DATA(boxes), count, maxiter, ratio,
+                              (int8_t *)PyArray_DATA(verdict));
+  Py_END_ALLOW_THREADS
+  if (err) {
+    PyErr_NoMemory();
+    goto done;
+  }
+  res = Py_BuildValue("OO", boxes, verdict);
+
+ done:
+  free(nodes);
+  Py_XDECREF(ops);
+  Py_XDECREF(operands);
+  Py_XDECREF(consts);
+  Py_XDECREF(roots);
+  Py_XDECREF(bounds);
+  Py_XDECREF(boxes);
+  Py_XDECREF(verdict);
+  return res;
+}
+
+// One dense layer (interval_nn.h) over the boxes X (count, n), given the
+// sign split S (2n, m) of its weights, the bias b (m,) and an
+// INTERVAL_ACT_* code.  The product goes to BLAS through numpy.
+static PyArrayObject *
+interval_ibp_layer(PyArrayObject *X, PyObject *oS, PyObject *ob, int act)
+{
+  PyArrayObject *S = NULL, *b = NULL, *P = NULL, *G = NULL, *Y = NULL;
+  npy_intp count = PyArray_DIM(X, 0), n = PyArray_DIM(X, 1), m, dims[2];
+
+  S = (PyArrayObject *)PyArray_FROM_OTF(oS, NPY_DOUBLE, NPY_ARRAY_CARRAY_RO);
+  b = (PyArrayObject *)PyArray_FROM_OTF(ob, NPY_DOUBLE, NPY_ARRAY_CARRAY_RO);
+  if (S == NULL || b == NULL) {
+    goto done;
+  }
+  if (PyArray_NDIM(S) != 2 || PyArray_DIM(S, 0) != 2*n || PyArray_NDIM(b) != 1 ||
+      PyArray_DIM(b, 0) != PyArray_DIM(S, 1)) {
+    PyErr_Format(PyExc_ValueError,
+                 "ibp: expected weights S (%zd, m) and bias (m,) for %zd inputs",
+                 (Py_ssize_t)(2*n), (Py_ssize_t)n);
+    goto done;
+  }
+  if (act < 0 || act >= INTERVAL_NUM_ACTS) {
+    PyErr_Format(PyExc_ValueError, "ibp: invalid activation %d", act);
+    goto done;
+  }
+  m = PyArray_DIM(S, 1);
+  dims[0] = 2*count;
+  dims[1] = 2*n;
+  P = (PyArrayObject *)PyArray_SimpleNew(2, dims, NPY_DOUBLE);
+  if (P == NULL) {
+    goto done;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  interval_ibp_planes(count, n, (const interval *)PyArray_DATA(X), (double *)PyArray_DATA(P));
+  Py_END_ALLOW_THREADS
+  G = (PyArrayObject *)PyArray_MatrixProduct2((PyObject *)P, (PyObject *)S, NULL);
+  if (G == NULL) {
+    goto done;
+  }
+  dims[0] = count;
+  dims[1] = m;
+  Py_INCREF(interval_descr);
+  Y = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 2, dims,
+                                            NULL, NULL, 0, NULL);
+  if (Y == NULL) {
+    goto done;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  interval_ibp_activate(count, n, m, (const interval *)PyArray_DATA(X),
+                        (const double *)PyArray_DATA(S), (const double *)PyArray_DATA(G),
+                        (const double *)PyArray_DATA(b), act, (interval *)PyArray_DATA(Y));
+  Py_END_ALLOW_THREADS
+
+ done:
+  Py_XDECREF(S);
+  Py_XDECREF(b);
+  Py_XDECREF(P);
+  Py_XDECREF(G);
+  return Y;
+}
+
+// ibp_dense(X, S, b, act): bounds of act(W x + b) over the boxes X
+// (count, n), with S (2n, m) the sign split [W+^T; W-^T] of W.
+static PyObject *
+interval_ibp_dense_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *oX, *oS, *ob;
+  PyArrayObject *X, *Y;
+  int act;
+
+  if (!PyArg_ParseTuple(args, "OOOi", &oX, &oS, &ob, &act)) {
+    return NULL;
+  }
+  X = interval_carray(oX, 2);
+  if (X == NULL) {
+    return NULL;
+  }
+  Y = interval_ibp_layer(X, oS, ob, act);
+  Py_DECREF(X);
+  return (PyObject *)Y;
+}
+
+// ibp_network(X, layers): ibp_dense through a sequence of (S, b, act)
+// layers in turn.
+static PyObject *
+interval_ibp_network_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *oX, *olayers, *layers;
+  PyArrayObject *X;
+  Py_ssize_t k;
+
+  if (!PyArg_ParseTuple(args, "OO", &oX, &olayers)) {
+    return NULL;
+  }
+  layers = PySequence_Fast(olayers, "ibp_network: layers must be a sequence");
+  if (layers == NULL) {
+    return NULL;
+  }
+  X = interval_carray(oX, 2);
+  for (k = 0; X != NULL && k < PySequence_Fast_GET_SIZE(layers); k++) {
+    PyObject *oS, *ob;
+    PyArrayObject *Y = NULL;
+    int act;
+    if (PyArg_ParseTuple(PySequence_Fast_GET_ITEM(layers, k), "OOi", &oS, &ob, &act)) {
+      Y = interval_ibp_layer(X, oS, ob, act);
+    }
+    Py_DECREF(X);
+    X = Y;
+  }
+  Py_DECREF(layers);
+  return (PyObject *)X;
+}
+
+
+// Box trees (interval_bvh.h) are handed to Python as capsules; the
+// BoxTree class in interval/spatial.py wraps them.  A tree is shared by
+// every thread holding the capsule and bvh_insert reallocates its arrays,
+// so inserts and queries keep the GIL to serialize them.
+#define INTERVAL_BVH_CAPSULE "npinterval.interval_bvh"
+
+static void
+interval_bvh_capsule_free(PyObject *capsule)
+{
+  interval_bvh_free((interval_bvh *)PyCapsule_GetPointer(capsule, INTERVAL_BVH_CAPSULE));
+}
+
+// bvh_build(boxes): a tree over the (N, n) interval array boxes.
+static PyObject *
+interval_bvh_build_py(PyObject *NPY_UNUSED(self), PyObject *oboxes)
+{
+  PyArrayObject *boxes = interval_carray(oboxes, 2);
+  interval_bvh *t;
+  PyObject *capsule;
+  if (boxes == NULL) {
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  t = interval_bvh_build(PyArray_DIM(boxes, 1), (const interval *)PyArray_DATA(boxes),
+                         PyArray_DIM(boxes, 0));
+  Py_END_ALLOW_THREADS
+  Py_DECREF(boxes);
+  if (t == NULL) {
+    return PyErr_NoMemory();
+  }
+  capsule = PyCapsule_New(t, INTERVAL_BVH_CAPSULE, interval_bvh_capsule_free);
+  if (capsule == NULL) {
+    interval_bvh_free(t);
+  }
+  return capsule;
+}
+
+// Tree in a capsule and a C-contiguous (m, n) interval array matching it.
+static int
+interval_bvh_args(PyObject *capsule, PyObject *oboxes, interval_bvh **t, PyArrayObject **boxes)
+{
+  *t = (interval_bvh *)PyCapsule_GetPointer(capsule, INTERVAL_BVH_CAPSULE);
+  if (*t == NULL) {
+    return -1;
+  }
+  *boxes = interval_carray(oboxes, 2);
+  if (*boxes == NULL) {
+    return -1;
+  }
+  if (PyArray_DIM(*boxes, 1) != (*t)->n) {
+    PyErr_Format(PyExc_ValueError, "expected boxes of dimension %zd, got %zd",
+                 (Py_ssize_t)(*t)->n, (Py_ssize_t)PyArray_DIM(*boxes, 1));
+    Py_DECREF(*boxes);
+    return -1;
+  }
+  return 0;
+}
+
+// bvh_insert(tree, boxes): append the (m, n) interval array boxes.
+static PyObject *
+interval_bvh_insert_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *capsule, *oboxes;
+  PyArrayObject *boxes;
+  interval_bvh *t;
+  int err;
+  if (!PyArg_ParseTuple(args, "OO", &capsule, &oboxes) ||
+      interval_bvh_args(capsule, oboxes, &t, &boxes) < 0) {
+    return NULL;
+  }
+  err = interval_bvh_insert(t, (const interval *)PyArray_DATA(boxes), PyArray_DIM(boxes, 0));
+  Py_DECREF(boxes);
+  if (err) {
+    return PyErr_NoMemory();
+  }
+  Py_RETURN_NONE;
+}
+
+// bvh_query(tree, queries, predicate): (K, 2) array of (query, box) pairs.
+static PyObject *
+interval_bvh_query_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *capsule, *oqueries;
+  PyArrayObject *queries, *ret;
+  interval_bvh *t;
+  intptr_t *pairs, npairs;
+  npy_intp dims[2];
+  int predicate, err;
+  if (!PyArg_ParseTuple(args, "OOi", &capsule, &oqueries, &predicate) ||
+      interval_bvh_args(capsule, oqueries, &t, &queries) < 0) {
+    return NULL;
+  }
+  err = interval_bvh_query(t, (const interval *)PyArray_DATA(queries), PyArray_DIM(queries, 0),
+                           predicate, &pairs, &npairs);
+  Py_DECREF(queries);
+  if (err) {
+    return PyErr_NoMemory();
+  }
+  dims[0] = npairs;
+  dims[1] = 2;
+  ret = (PyArrayObject *)PyArray_SimpleNew(2, dims, NPY_INTP);
+  if (ret != NULL && npairs) {
+    memcpy(PyArray_DATA(ret), pairs, 2*npairs*sizeof(intptr_t));
+  }
+  free(pairs);
+  return (PyObject *)ret;
+}
+
+// Subpavings (interval_paving.h) are also passed around as capsules, for
+// the Paving class in interval/paving.py.  As with box trees, inserting
+// and compacting reallocate the node pool, so every call keeps the GIL.
+#define INTERVAL_PAVING_CAPSULE "npinterval.interval_paving"
+
+static void
+interval_paving_capsule_free(PyObject *capsule)
+{
+  interval_paving_free((interval_paving *)PyCapsule_GetPointer(capsule, INTERVAL_PAVING_CAPSULE));
+}
+
+static PyObject *
+interval_paving_wrap(interval_paving *p)
+{
+  PyObject *capsule;
+  if (p == NULL) {
+    return PyErr_NoMemory();
+  }
+  capsule = PyCapsule_New(p, INTERVAL_PAVING_CAPSULE, interval_paving_capsule_free);
+  if (capsule == NULL) {
+    interval_paving_free(p);
+  }
+  return capsule;
+}
+
+static interval_paving *
+interval_paving_unwrap(PyObject *capsule)
+{
+  return (interval_paving *)PyCapsule_GetPointer(capsule, INTERVAL_PAVING_CAPSULE);
+}
+
+// paving_new(root): an empty paving over the (n,) interval array root.
+static PyObject *
+interval_paving_new_py(PyObject *NPY_UNUSED(self), PyObject *oroot)
+{
+  PyArrayObject *root = interval_carray(oroot, 1);
+  interval_paving *p;
+  if (root == NULL) {
+    return NULL;
+  }
+  p = interval_paving_new(PyArray_DIM(root, 0), (const interval *)PyArray_DATA(root));
+  Py_DECREF(root);
+  return interval_paving_wrap(p);
+}
+
+// paving_insert(paving, boxes, eps, outer): add an (m, n) interval array.
+static PyObject *
+interval_paving_insert_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *capsule, *oboxes;
+  PyArrayObject *boxes;
+  interval_paving *p;
+  double eps;
+  int outer, err;
+  if (!PyArg_ParseTuple(args, "OOdp", &capsule, &oboxes, &eps, &outer) ||
+      (p = interval_paving_unwrap(capsule)) == NULL ||
+      (boxes = interval_carray(oboxes, 2)) == NULL) {
+    return NULL;
+  }
+  if (PyArray_DIM(boxes, 1) != p->n) {
+    PyErr_Format(PyExc_ValueError, "expected boxes of dimension %zd, got %zd",
+                 (Py_ssize_t)p->n, (Py_ssize_t)PyArray_DIM(boxes, 1));
+    Py_DECREF(boxes);
+    return NULL;
+  }
+  err = interval_paving_insert(p, (const interval *)PyArray_DATA(boxes), PyArray_DIM(boxes, 0),
+                               eps, outer);
+  Py_DECREF(boxes);
+  if (err == -2) {
+    PyErr_SetString(PyExc_ValueError, "paving: eps must be positive and finite");
+    return NULL;
+  }
+  if (err) {
+    return PyErr_NoMemory();
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *
+interval_paving_combine_py(PyObject *args, int intersect)
+{
+  PyObject *ca, *cb;
+  interval_paving *a, *b, *r;
+  if (!PyArg_ParseTuple(args, "OO", &ca, &cb) ||
+      (a = interval_paving_unwrap(ca)) == NULL || (b = interval_paving_unwrap(cb)) == NULL) {
+    return NULL;
+  }
+  if (a->n != b->n || memcmp(a->root, b->root, a->n*sizeof(interval))) {
+    PyErr_SetString(PyExc_ValueError, "pavings must share the same root box");
+    return NULL;
+  }
+  r = intersect ? interval_paving_intersection(a, b) : interval_paving_union(a, b);
+  return interval_paving_wrap(r);
+}
+
+static PyObject *
+interval_paving_union_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  return interval_paving_combine_py(args, 0);
+}
+
+static PyObject *
+interval_paving_intersection_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  return interval_paving_combine_py(args, 1);
+}
+
+static PyObject *
+interval_paving_volume_py(PyObject *NPY_UNUSED(self), PyObject *capsule)
+{
+  interval_paving *p = interval_paving_unwrap(capsule);
+  if (p == NULL) {
+    return NULL;
+  }
+  return PyFloat_FromDouble(interval_paving_volume(p));
+}
+
+// paving_count(paving): the number of boxes of the set.
+static PyObject *
+interval_paving_count_py(PyObject *NPY_UNUSED(self), PyObject *capsule)
+{
+  interval_paving *p = interval_paving_unwrap(capsule);
+  intptr_t count;
+  if (p == NULL) {
+    return NULL;
+  }
+  count = interval_paving_count(p);
+  if (count < 0) {
+    return PyErr_NoMemory();
+  }
+  return PyLong_FromSsize_t(count);
+}
+
+// paving_boxes(paving): the boxes of the set as a (K, n) interval array.
+static PyObject *
+interval_paving_boxes_py(PyObject *NPY_UNUSED(self), PyObject *capsule)
+{
+  interval_paving *p = interval_paving_unwrap(capsule);
+  PyArrayObject *ret;
+  npy_intp dims[2];
+  if (p == NULL) {
+    return NULL;
+  }
+  dims[0] = interval_paving_count(p);
+  dims[1] = p->n;
+  if (dims[0] < 0) {
+    return PyErr_NoMemory();
+  }
+  Py_INCREF(interval_descr);
+  ret = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 2, dims,
+                                              NULL, NULL, 0, NULL);
+  if (ret != NULL) {
+    interval_paving_export(p, (interval *)PyArray_DATA(ret));
+  }
+  return (PyObject *)ret;
+}
+
+// paving_compact(paving): repack the node pool; returns its new size.
+static PyObject *
+interval_paving_compact_py(PyObject *NPY_UNUSED(self), PyObject *capsule)
+{
+  interval_paving *p = interval_paving_unwrap(capsule);
+  if (p == NULL) {
+    return NULL;
+  }
+  if (interval_paving_compact(p) < 0) {
+    return PyErr_NoMemory();
+  }
+  return PyLong_FromSsize_t(p->num_nodes);
+}
+
+// Moore-Skelboe work lists (interval_optimize.h) are capsules too; the
+// minimize driver in interval/optimize.py owns them.
+#define INTERVAL_MINIMIZER_CAPSULE "npinterval.interval_minimizer"
+
+static void
+interval_minimizer_capsule_free(PyObject *capsule)
+{
+  interval_minimizer_free((interval_minimizer *)PyCapsule_GetPointer(capsule, INTERVAL_MINIMIZER_CAPSULE));
+}
+
+static interval_minimizer *
+interval_minimizer_unwrap(PyObject *capsule)
+{
+  return (interval_minimizer *)PyCapsule_GetPointer(capsule, INTERVAL_MINIMIZER_CAPSULE);
+}
+
+// minimizer_new(n): an empty work list over boxes of dimension n.
+static PyObject *
+interval_minimizer_new_py(PyObject *NPY_UNUSED(self), PyObject *arg)
+{
+  Py_ssize_t n = PyLong_AsSsize_t(arg);
+  interval_minimizer *m;
+  PyObject *capsule;
+  if (n == -1 && PyErr_Occurred()) {
+    return NULL;
+  }
+  if (n < 1) {
+    PyErr_SetString(PyExc_ValueError, "dimension must be positive");
+    return NULL;
+  }
+  m = interval_minimizer_new(n);
+  if (m == NULL) {
+    return PyErr_NoMemory();
+  }
+  capsule = PyCapsule_New(m, INTERVAL_MINIMIZER_CAPSULE, interval_minimizer_capsule_free);
+  if (capsule == NULL) {
+    interval_minimizer_free(m);
+  }
+  return capsule;
+}
+
+// minimizer_push(m, boxes, F): queue the (k, n) interval array boxes with
+// the (k,) enclosures F of the objective over them.
+static PyObject *
+interval_minimizer_push_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *capsule, *oboxes, *oF;
+  PyArrayObject *boxes = NULL, *F = NULL;
+  interval_minimizer *m;
+  int err = 0;
+  if (!PyArg_ParseTuple(args, "OOO", &capsule, &oboxes, &oF) ||
+      (m = interval_minimizer_unwrap(capsule)) == NULL ||
+      (boxes = interval_carray(oboxes, 2)) == NULL ||
+      (F = interval_carray(oF, 1)) == NULL) {
+    Py_XDECREF(boxes);
+    return NULL;
+  }
+  if (PyArray_DIM(boxes, 1) != m->n || PyArray_DIM(F, 0) != PyArray_DIM(boxes, 0)) {
+    PyErr_Format(PyExc_ValueError, "expected (k, %zd) boxes and (k,) bounds, got shapes (%zd, %zd) and (%zd,)",
+                 (Py_ssize_t)m->n, (Py_ssize_t)PyArray_DIM(boxes, 0), (Py_ssize_t)PyArray_DIM(boxes, 1),
+                 (Py_ssize_t)PyArray_DIM(F, 0));
+    Py_DECREF(boxes);
+    Py_DECREF(F);
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  err = interval_minimizer_push(m, (const interval *)PyArray_DATA(boxes), (const interval *)PyArray_DATA(F),
+                                PyArray_DIM(boxes, 0));
+  Py_END_ALLOW_THREADS
+  Py_DECREF(boxes);
+  Py_DECREF(F);
+  if (err) {
+    return PyErr_NoMemory();
+  }
+  Py_RETURN_NONE;
+}
+
+// minimizer_bound(m, values): lower the upper bound of the minimum to the
+// least upper endpoint of the interval array values.
+static PyObject *
+interval_minimizer_bound_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *capsule, *ovalues;
+  PyArrayObject *values;
+  interval_minimizer *m;
+  if (!PyArg_ParseTuple(args, "OO", &capsule, &ovalues) ||
+      (m = interval_minimizer_unwrap(capsule)) == NULL) {
+    return NULL;
+  }
+  Py_INCREF(interval_descr);
+  values = (PyArrayObject *)PyArray_FromAny(ovalues, interval_descr, 0, 0, NPY_ARRAY_CARRAY_RO, NULL);
+  if (values == NULL) {
+    return NULL;
+  }
+  interval_minimizer_bound(m, (const interval *)PyArray_DATA(values), PyArray_SIZE(values));
+  Py_DECREF(values);
+  Py_RETURN_NONE;
+}
+
+// minimizer_split(m, count, tol): pop and bisect up to count boxes;
+// returns the halves as a (k, n) interval array.
+static PyObject *
+interval_minimizer_split_py(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *capsule;
+  PyArrayObject *ret;
+  interval_minimizer *m;
+  Py_ssize_t count;
+  intptr_t written;
+  double tol;
+  npy_intp dims[2];
+  if (!PyArg_ParseTuple(args, "Ond", &capsule, &count, &tol) ||
+      (m = interval_minimizer_unwrap(capsule)) == NULL) {
+    return NULL;
+  }
+  if (count < 0) {
+    count = 0;
+  }
+  dims[0] = 2*(count < m->size ? count : m->size);
+  dims[1] = m->n;
+  Py_INCREF(interval_descr);
+  ret = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 2, dims,
+                                              NULL, NULL, 0, NULL);
+  if (ret == NULL) {
+    return NULL;
+  }
+  Py_BEGIN_ALLOW_THREADS
+  written = interval_minimizer_split(m, count, tol, (interval *)PyArray_DATA(ret));
+  Py_END_ALLOW_THREADS
+  if (written < 0) {
+    Py_DECREF(ret);
+    return PyErr_NoMemory();
+  }
+  if (written < dims[0]) {
+    PyObject *part = PySequence_GetSlice((PyObject *)ret, 0, written);
+    Py_DECREF(ret);
+    return part;
+  }
+  return (PyObject *)ret;
+}
+
+// minimizer_state(m): (least lower bound, upper bound, queued boxes).
+static PyObject *
+interval_minimizer_state_py(PyObject *NPY_UNUSED(self), PyObject *capsule)
+{
+  interval_minimizer *m = interval_minimizer_unwrap(capsule);
+  if (m == NULL) {
+    return NULL;
+  }
+  interval_minimizer_prune(m);
+  return Py_BuildValue("ddn", interval_minimizer_lower(m), m->best, (Py_ssize_t)m->size);
+}
+
+// minimizer_result(m): the candidate minimizers as a (K, n) interval
+// array, and their lower bounds as a (K,) float array.
+static PyObject *
+interval_minimizer_result_py(PyObject *NPY_UNUSED(self), PyObject *capsule)
+{
+  interval_minimizer *m = interval_minimizer_unwrap(capsule);
+  PyArrayObject *boxes, *lower;
+  npy_intp dims[2];
+  if (m == NULL) {
+    return NULL;
+  }
+  dims[0] = interval_minimizer_count(m);
+  dims[1] = m->n;
+  Py_INCREF(interval_descr);
+  boxes = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, interval_descr, 2, dims,
+                                                NULL, NULL, 0, NULL);
+  lower = (PyArrayObject *)PyArray_SimpleNew(1, dims, NPY_DOUBLE);
+  if (boxes == NULL || lower == NULL) {
+    Py_XDECREF(boxes);
+    Py_XDECREF(lower);
+    return NULL;
+  }
+  interval_minimizer_export(m, (interval *)PyArray_DATA(boxes), (double *)PyArray_DATA(lower));
+  return Py_BuildValue("NN", boxes, lower);
+}
+
+// set_num_threads(n): threads used by ufunc loops and the native engines;
+// n < 1 restores the default.  Returns the previous number.
+static PyObject *
+interval_set_num_threads_py(PyObject *NPY_UNUSED(self), PyObject *arg)
+{
+  int previous = interval_get_num_threads();
+  long n = PyLong_AsLong(arg);
+  if (n == -1 && PyErr_Occurred()) {
+    return NULL;
+  }
+  interval_set_num_threads(n > INT_MAX ? INT_MAX : n < 0 ? 0 : (int)n);
+  return PyLong_FromLong(previous);
+}
+
+static PyObject *
+interval_get_num_threads_py(PyObject *NPY_UNUSED(self), PyObject *NPY_UNUSED(args))
+{
+  return PyLong_FromLong(interval_get_num_threads());
+}
+
+// set_dot_kernel(name): select the kernel of np.dot/matmul; returns the
+// previous choice.
+static PyObject *
+interval_set_dot_kernel_py(PyObject *NPY_UNUSED(self), PyObject *name)
+{
+  const char *s = PyUnicode_AsUTF8(name);
+  int k, previous = interval_dot_choice;
+  if (s == NULL) {
+    return NULL;
+  }
+  for (k = 0; k < (int)(sizeof(interval_dot_names)/sizeof(*interval_dot_names)); k++) {
+    if (strcmp(s, interval_dot_names[k]) == 0) {
+      interval_dot_choice = k;
+      return PyUnicode_FromString(interval_dot_names[previous]);
+    }
+  }
+  PyErr_Format(PyExc_ValueError, "unknown dot kernel '%s'; expected 'auto', 'four' or 'sign'", s);
+  return NULL;
+}
+
+static PyObject *
+interval_get_dot_kernel_py(PyObject *NPY_UNUSED(self), PyObject *NPY_UNUSED(args))
+{
+  return PyUnicode_FromString(interval_dot_names[interval_dot_choice]);
+}
 
 // This contains assorted other top-level methods for the module
 static PyMethodDef IntervalMethods[] = {
+  {"argsort_midpoint", interval_argsort_midpoint, METH_O,
+   "Stable argsort of an interval array along its last axis by midpoint"},
+  {"argsort_width", interval_argsort_width, METH_O,
+   "Stable argsort of an interval array along its last axis by width"},
+  {"csr_matmul", interval_csr_matmul_py, METH_VARARGS,
+   "csr_matmul(indptr, indices, data, b, m): product of an m-row CSR matrix with a 2-D array"},
+  {"matmul_stack", interval_matmul_stack_py, METH_VARARGS,
+   "matmul_stack(A, B): A[b] @ B[b] for stacks of interval matrices, threaded over the stack"},
+  {"det_stack", interval_det_stack_py, METH_O,
+   "det_stack(A): enclosures of the determinants of a stack of interval matrices"},
+  {"inv_stack", interval_inv_stack_py, METH_O,
+   "inv_stack(A): enclosures of the inverses of a stack of interval matrices"},
+  {"expm_stack", interval_expm_stack_py, METH_VARARGS,
+   "expm_stack(A, h): enclosures of exp(A[k] h[k]) for a stack of interval matrices"},
+  {"precondition", interval_precondition_py, METH_VARARGS,
+   "precondition(A, b, C): (C A, C b) for stacks of interval systems"},
+  {"linsolve", interval_linsolve_py, METH_VARARGS,
+   "linsolve(Ap, bp, x0, method, maxiter, tol, M): solve stacks of preconditioned interval systems"},
+  {"krawczyk", interval_krawczyk_py, METH_VARARGS,
+   "krawczyk(X, c, fc, J, C): Krawczyk operator over a stack of boxes; returns (K & X, verdict)"},
+  {"hc4_contract", interval_hc4_contract_py, METH_VARARGS,
+   "hc4_contract(ops, args, consts, roots, bounds, boxes, maxiter, ratio): HC4 contraction of boxes; returns (boxes, verdict)"},
+  {"ibp_dense", interval_ibp_dense_py, METH_VARARGS,
+   "ibp_dense(X, S, b, act): interval bounds of a dense layer over a batch of boxes"},
+  {"ibp_network", interval_ibp_network_py, METH_VARARGS,
+   "ibp_network(X, layers): ibp_dense through a sequence of (S, b, act) layers"},
+  {"bvh_build", interval_bvh_build_py, METH_O,
+   "bvh_build(boxes): bounding volume hierarchy over an (N, n) interval array"},
+  {"bvh_insert", interval_bvh_insert_py, METH_VARARGS,
+   "bvh_insert(tree, boxes): append (m, n) interval boxes to a tree"},
+  {"bvh_query", interval_bvh_query_py, METH_VARARGS,
+   "bvh_query(tree, queries, predicate): (K, 2) array of matching (query, box) index pairs"},
+  {"paving_new", interval_paving_new_py, METH_O,
+   "paving_new(root): empty subpaving over an (n,) interval root box"},
+  {"paving_insert", interval_paving_insert_py, METH_VARARGS,
+   "paving_insert(paving, boxes, eps, outer): add (m, n) interval boxes to a subpaving"},
+  {"paving_union", interval_paving_union_py, METH_VARARGS,
+   "paving_union(a, b): union of two subpavings over the same root"},
+  {"paving_intersection", interval_paving_intersection_py, METH_VARARGS,
+   "paving_intersection(a, b): intersection of two subpavings over the same root"},
+  {"paving_volume", interval_paving_volume_py, METH_O,
+   "paving_volume(paving): total volume of a subpaving"},
+  {"paving_count", interval_paving_count_py, METH_O,
+   "paving_count(paving): number of boxes of a subpaving"},
+  {"paving_boxes", interval_paving_boxes_py, METH_O,
+   "paving_boxes(paving): the boxes of a subpaving as a (K, n) interval array"},
+  {"paving_compact", interval_paving_compact_py, METH_O,
+   "paving_compact(paving): repack the nodes of a subpaving; returns the node count"},
+  {"minimizer_new", interval_minimizer_new_py, METH_O,
+   "minimizer_new(n): empty Moore-Skelboe work list over boxes of dimension n"},
+  {"minimizer_push", interval_minimizer_push_py, METH_VARARGS,
+   "minimizer_push(m, boxes, F): queue (k, n) boxes with the (k,) enclosures F of the objective"},
+  {"minimizer_bound", interval_minimizer_bound_py, METH_VARARGS,
+   "minimizer_bound(m, values): lower the upper bound of the minimum to min(values.u)"},
+  {"minimizer_split", interval_minimizer_split_py, METH_VARARGS,
+   "minimizer_split(m, count, tol): pop and bisect up to count boxes of least lower bound"},
+  {"minimizer_state", interval_minimizer_state_py, METH_O,
+   "minimizer_state(m): (least lower bound, upper bound, number of queued boxes)"},
+  {"minimizer_result", interval_minimizer_result_py, METH_O,
+   "minimizer_result(m): candidate minimizer boxes and their lower bounds"},
+  {"set_num_threads", interval_set_num_threads_py, METH_O,
+   "set_num_threads(n): number of threads for large ufunc loops and native engines (n < 1: default); returns the previous one"},
+  {"get_num_threads", interval_get_num_threads_py, METH_NOARGS,
+   "get_num_threads(): number of threads for large ufunc loops and native engines"},
+  {"set_dot_kernel", interval_set_dot_kernel_py, METH_O,
+   "set_dot_kernel(name): use the 'auto', 'four' or 'sign' kernel for dot/matmul; returns the previous one"},
+  {"get_dot_kernel", interval_get_dot_kernel_py, METH_NOARGS,
+   "get_dot_kernel(): name of the kernel used for dot/matmul"},
   {NULL, NULL, 0, NULL}
 };
 
 
+// The function table exported through the _C_API capsule; see
+// numpy_interval_api.h.  interval_type_num is filled in at registration.
+static NpInterval_CAPI interval_capi = {
+  NPINTERVAL_CAPI_VERSION,
+  -1,
+  &PyInterval_Type,
+  PyInterval_FromInterval,
+  interval_add,
+  interval_add_scalar,
+  interval_scalar_add,
+  interval_subtract,
+  interval_subtract_scalar,
+  interval_scalar_subtract,
+  interval_multiply,
+  interval_multiply_scalar,
+  interval_scalar_multiply,
+  interval_inverse,
+  interval_divide,
+  interval_divide_scalar,
+  interval_scalar_divide,
+  interval_square,
+  interval_power_scalar,
+  interval_negative,
+  interval_sin,
+  interval_cos,
+  interval_tan,
+  interval_arctan,
+  interval_tanh,
+  interval_exp,
+  interval_sqrt,
+  interval_norm,
+  interval_union,
+  interval_intersection,
+  interval_minimum,
+  interval_maximum,
+  interval_nonzero,
+  interval_equal,
+  interval_not_equal,
+  interval_subseteq,
+  interval_supseteq,
+  interval_subset,
+  interval_supset,
+  interval_power_int,
+  interval_fma,
+  interval_fma_scalar,
+  interval_scalar_fma,
+  interval_certainly_lt,
+  interval_certainly_le,
+  interval_certainly_gt,
+  interval_certainly_ge,
+  interval_possibly_lt,
+  interval_possibly_le,
+  interval_possibly_gt,
+  interval_possibly_ge,
+  interval_compare_lt,
+  interval_compare_le,
+  interval_compare_gt,
+  interval_compare_ge,
+  interval_contains,
+  interval_overlaps,
+  interval_relu,
+  interval_sigmoid,
+};
+
 int interval_elsize = sizeof(interval);
 
 typedef struct { char c; interval q; } align_test;
 int interval_alignment = offsetof(align_test, q);
 
+typedef struct { char c; midrad q; } midrad_align_test;
+
+#ifdef INTERVAL_ARRAYMETHOD
+// The signatures registered for each ufunc, in the order the legacy
+// type resolver tried them: a loop comes before another if, at the first
+// argument where they differ, its type casts safely to the other's.  The
+// promoters below pick the first loop the operands cast to safely, as
+// the legacy resolver did.
+#define INTERVAL_MAX_METHOD_UFUNCS 64
+#define INTERVAL_MAX_UFUNC_LOOPS 16
+
+typedef struct {
+  PyUFuncObject *ufunc;
+  int nloops;
+  int types[INTERVAL_MAX_UFUNC_LOOPS][4];
+} interval_ufunc_signatures;
+
+static interval_ufunc_signatures interval_signatures[INTERVAL_MAX_METHOD_UFUNCS];
+static int interval_nsignatures = 0;
+
+static PyArray_DTypeMeta *
+interval_dtype_from_type_num(int type_num)
+{
+  PyArray_Descr *descr = PyArray_DescrFromType(type_num);
+  PyArray_DTypeMeta *dtype = (PyArray_DTypeMeta *)Py_TYPE(descr);
+  Py_INCREF(dtype);
+  Py_DECREF(descr);
+  return dtype;
+}
+
+static interval_ufunc_signatures *
+interval_find_signatures(PyUFuncObject *ufunc)
+{
+  int k;
+  for (k = 0; k < interval_nsignatures; k++) {
+    if (interval_signatures[k].ufunc == ufunc) {
+      return &interval_signatures[k];
+    }
+  }
+  return NULL;
+}
+
+// Returns 1 if the signature was already there.
+static int
+interval_record_signature(PyUFuncObject *ufunc, const int *types)
+{
+  interval_ufunc_signatures *sigs = interval_find_signatures(ufunc);
+  int nargs = ufunc->nargs, pos, k, j;
+  if (sigs == NULL) {
+    if (interval_nsignatures == INTERVAL_MAX_METHOD_UFUNCS) {
+      PyErr_SetString(PyExc_RuntimeError, "too many interval ufuncs");
+      return -1;
+    }
+    sigs = &interval_signatures[interval_nsignatures++];
+    sigs->ufunc = ufunc;
+    sigs->nloops = 0;
+  }
+  for (pos = 0; pos < sigs->nloops; pos++) {
+    if (memcmp(sigs->types[pos], types, nargs*sizeof(int)) == 0) {
+      return 1;
+    }
+  }
+  if (sigs->nloops == INTERVAL_MAX_UFUNC_LOOPS) {
+    PyErr_Format(PyExc_RuntimeError, "too many interval loops for %s", ufunc->name);
+    return -1;
+  }
+  for (pos = 0; pos < sigs->nloops; pos++) {
+    for (k = 0; k < nargs && sigs->types[pos][k] == types[k]; k++) {
+    }
+    if (k == nargs || !PyArray_CanCastSafely(sigs->types[pos][k], types[k])) {
+      break;
+    }
+  }
+  for (j = sigs->nloops; j > pos; j--) {
+    memcpy(sigs->types[j], sigs->types[j - 1], sizeof(sigs->types[j]));
+  }
+  memcpy(sigs->types[pos], types, nargs*sizeof(int));
+  sigs->nloops++;
+  return 0;
+}
+
+static int
+interval_promoter(PyObject *ufunc, PyArray_DTypeMeta *const op_dtypes[],
+                  PyArray_DTypeMeta *const signature[], PyArray_DTypeMeta *new_op_dtypes[])
+{
+  interval_ufunc_signatures *sigs = interval_find_signatures((PyUFuncObject *)ufunc);
+  int nin = ((PyUFuncObject *)ufunc)->nin, nargs = ((PyUFuncObject *)ufunc)->nargs;
+  int l, k;
+  for (l = 0; sigs != NULL && l < sigs->nloops; l++) {
+    for (k = 0; k < nargs; k++) {
+      PyArray_DTypeMeta *dtype = interval_dtype_from_type_num(sigs->types[l][k]);
+      int match = signature[k] == NULL || signature[k] == dtype;
+      Py_DECREF(dtype);
+      if (match && k < nin && op_dtypes[k] != NULL) {
+        PyArray_Descr *from = PyArray_GetDefaultDescr(op_dtypes[k]);
+        PyArray_Descr *to = PyArray_DescrFromType(sigs->types[l][k]);
+        match = from != NULL && PyArray_CanCastTypeTo(from, to, NPY_SAFE_CASTING);
+        Py_XDECREF(from);
+        Py_DECREF(to);
+        PyErr_Clear();
+      }
+      if (!match) {
+        break;
+      }
+    }
+    if (k == nargs) {
+      for (k = 0; k < nargs; k++) {
+        new_op_dtypes[k] = interval_dtype_from_type_num(sigs->types[l][k]);
+      }
+      return 0;
+    }
+  }
+  PyErr_Format(PyExc_TypeError, "no loop of ufunc %s matches the operand types",
+               ((PyUFuncObject *)ufunc)->name);
+  return -1;
+}
+
+// Adds promoters for every input pattern of the interval-like dtypes in
+// the registered loops of ufunc and "any dtype", so that the most
+// specific one, handed to interval_promoter, is never ambiguous.
+// Patterns that are a loop themselves, or all "any", are left out.
+static int
+interval_add_promoters(interval_ufunc_signatures *sigs)
+{
+  PyUFuncObject *ufunc = sigs->ufunc;
+  int nin = ufunc->nin, nargs = ufunc->nargs;
+  int choices[3], nchoices = 1, pattern[4], npatterns = 1;
+  int l, k, p, q, r;
+  PyObject *capsule;
+
+  if (nin < 2) {
+    return 0;
+  }
+  choices[0] = NPY_NOTYPE;
+  for (l = 0; l < sigs->nloops; l++) {
+    for (k = 0; k < nin; k++) {
+      int t = sigs->types[l][k];
+      if (PyTypeNum_ISUSERDEF(t)) {
+        for (q = 0; q < nchoices && choices[q] != t; q++) {
+        }
+        if (q == nchoices) {
+          choices[nchoices++] = t;
+        }
+      }
+    }
+  }
+  for (k = 0; k < nin; k++) {
+    npatterns *= nchoices;
+  }
+  capsule = PyCapsule_New((void *)&interval_promoter, "numpy._ufunc_promoter", NULL);
+  if (capsule == NULL) {
+    return -1;
+  }
+  // Most specific patterns first: NumPy gives up on an operand that two
+  // equally specific promoters match before it sees a more specific one.
+  for (p = 0; p < npatterns*nin; p++) {
+    PyObject *dtypes;
+    int exists = 0, nany = 0;
+    for (k = 0, q = p % npatterns; k < nin; k++, q /= nchoices) {
+      pattern[k] = choices[q % nchoices];
+      nany += pattern[k] == NPY_NOTYPE;
+    }
+    if (nany != p/npatterns) {
+      continue;
+    }
+    for (l = 0; l < sigs->nloops && !exists; l++) {
+      for (k = 0; k < nin && sigs->types[l][k] == pattern[k]; k++) {
+      }
+      exists = k == nin;
+    }
+    if (exists) {
+      continue;
+    }
+    dtypes = PyTuple_New(nargs);
+    if (dtypes == NULL) {
+      Py_DECREF(capsule);
+      return -1;
+    }
+    for (k = 0; k < nargs; k++) {
+      PyObject *item = k >= nin ? Py_None :
+          pattern[k] == NPY_NOTYPE ? (PyObject *)&PyArrayDescr_Type :
+          (PyObject *)interval_dtype_from_type_num(pattern[k]);
+      if (k >= nin || pattern[k] == NPY_NOTYPE) {
+        Py_INCREF(item);
+      }
+      PyTuple_SET_ITEM(dtypes, k, item);
+    }
+    r = PyUFunc_AddPromoter((PyObject *)ufunc, dtypes, capsule);
+    Py_DECREF(dtypes);
+    if (r < 0) {
+      Py_DECREF(capsule);
+      return -1;
+    }
+  }
+  Py_DECREF(capsule);
+  return 0;
+}
+
+// The initial value of reductions over intervals and midrads: the
+// identity of the ufunc as a degenerate interval, so that sum([]) is
+// [0, 0] and prod([]) is [1, 1].
+static int
+interval_reduction_initial(PyArrayMethod_Context *context, npy_bool NPY_UNUSED(reduction_is_empty),
+                           void *initial)
+{
+  PyObject *identity;
+  double v;
+  if (context->caller == NULL) {
+    return 0;
+  }
+  identity = PyObject_GetAttrString(context->caller, "identity");
+  if (identity == NULL) {
+    return -1;
+  }
+  if (identity == Py_None) {
+    Py_DECREF(identity);
+    return 0;
+  }
+  v = PyFloat_AsDouble(identity);
+  Py_DECREF(identity);
+  if (v == -1 && PyErr_Occurred()) {
+    PyErr_Clear();
+    return 0;
+  }
+  if (context->descriptors[0]->type_num == midrad_descr->type_num) {
+    *(midrad *)initial = (midrad) { v, 0 };
+  } else {
+    *(interval *)initial = (interval) { v, v };
+  }
+  return 1;
+}
+
+// Registers the ArrayMethod for the loop with the given types; contig and
+// unaligned may be NULL, as for the gufuncs.
+static int
+interval_register_method(PyObject *ufunc, const char *name, const int *types,
+                  PyArrayMethod_StridedLoop *strided, PyArrayMethod_StridedLoop *contig,
+                  PyArrayMethod_StridedLoop *unaligned)
+{
+  PyUFuncObject *uf = (PyUFuncObject *)ufunc;
+  PyArray_DTypeMeta *dtypes[4];
+  PyType_Slot slots[6];
+  PyArrayMethod_Spec spec;
+  int nslots = 0, same = 1, k, ret;
+
+  if (ufunc == NULL) {
+    return -1;
+  }
+  // divide and true_divide are the same ufunc; the first loop stays.
+  ret = interval_record_signature(uf, types);
+  if (ret != 0) {
+    return ret < 0 ? -1 : 0;
+  }
+  for (k = 0; k < uf->nargs; k++) {
+    dtypes[k] = interval_dtype_from_type_num(types[k]);
+    same = same && types[k] == types[0];
+  }
+  slots[nslots++] = (PyType_Slot) { NPY_METH_strided_loop, (void *)strided };
+  if (contig != NULL) {
+    slots[nslots++] = (PyType_Slot) { NPY_METH_contiguous_loop, (void *)contig };
+  }
+  if (unaligned != NULL) {
+    slots[nslots++] = (PyType_Slot) { NPY_METH_unaligned_strided_loop, (void *)unaligned };
+    slots[nslots++] = (PyType_Slot) { NPY_METH_unaligned_contiguous_loop, (void *)unaligned };
+  }
+  if (same && uf->nin == 2 && uf->nout == 1 && uf->core_enabled == 0) {
+    slots[nslots++] = (PyType_Slot) { NPY_METH_get_reduction_initial,
+                                      (void *)interval_reduction_initial };
+  }
+  slots[nslots] = (PyType_Slot) { 0, NULL };
+
+  spec.name = name;
+  spec.nin = uf->nin;
+  spec.nout = uf->nout;
+  spec.casting = NPY_NO_CASTING;
+  spec.flags = unaligned != NULL ? NPY_METH_SUPPORTS_UNALIGNED : 0;
+  // As for legacy loops, reductions over several axes at once need the
+  // ufunc to have an identity (or to be reorderable without one).
+  if (same && uf->nin == 2 && uf->nout == 1 && uf->core_enabled == 0 &&
+      uf->identity != PyUFunc_None) {
+    spec.flags |= NPY_METH_IS_REORDERABLE;
+  }
+  spec.dtypes = dtypes;
+  spec.slots = slots;
+  ret = PyUFunc_AddLoopFromSpec(ufunc, &spec);
+  for (k = 0; k < uf->nargs; k++) {
+    Py_DECREF(dtypes[k]);
+  }
+  return ret;
+}
+#endif
+
 
 /////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////
@@ -1198,7 +4191,8 @@ PyMODINIT_FUNC initnumpy_interval(void) {
   PyObject *module;
   PyObject *tmp_ufunc;
   int intervalNum;
-  int arg_types[3];
+  int midradNum;
+  int arg_types[4];
   PyArray_Descr* arg_dtypes[6];
   PyObject* numpy;
   PyObject* numpy_dict;
@@ -1252,34 +4246,47 @@ PyMODINIT_FUNC initnumpy_interval(void) {
   _PyInterval_ArrFuncs.getitem = (PyArray_GetItemFunc*)INTERVAL_getitem;
   _PyInterval_ArrFuncs.dotfunc = (PyArray_GetItemFunc*)INTERVAL_dot;
   // _PyInterval_ArrFuncs.matmul = (PyArray_GetItemFunc*);
-  // _PyInterval_ArrFuncs.compare = (PyArray_CompareFunc*)INTERVAL_compare;
-  // _PyInterval_ArrFuncs.argmax = (PyArray_ArgFunc*)INTERVAL_argmax;
+  _PyInterval_ArrFuncs.compare = (PyArray_CompareFunc*)INTERVAL_compare;
+  _PyInterval_ArrFuncs.argmax = (PyArray_ArgFunc*)INTERVAL_argmax;
+  _PyInterval_ArrFuncs.argmin = (PyArray_ArgFunc*)INTERVAL_argmin;
+  _PyInterval_ArrFuncs.sort[NPY_QUICKSORT] = (PyArray_SortFunc*)INTERVAL_quicksort;
+  _PyInterval_ArrFuncs.sort[NPY_HEAPSORT] = (PyArray_SortFunc*)INTERVAL_heapsort;
+  _PyInterval_ArrFuncs.sort[NPY_MERGESORT] = (PyArray_SortFunc*)INTERVAL_radixsort;
+  _PyInterval_ArrFuncs.argsort[NPY_QUICKSORT] = (PyArray_ArgSortFunc*)INTERVAL_aquicksort;
+  _PyInterval_ArrFuncs.argsort[NPY_HEAPSORT] = (PyArray_ArgSortFunc*)INTERVAL_aheapsort;
+  _PyInterval_ArrFuncs.argsort[NPY_MERGESORT] = (PyArray_ArgSortFunc*)INTERVAL_aradixsort;
   _PyInterval_ArrFuncs.fillwithscalar = (PyArray_FillWithScalarFunc*)INTERVAL_fillwithscalar;
 
-  // The interval array descr
-  interval_descr = PyObject_New(PyArray_Descr, &PyArrayDescr_Type);
-  interval_descr->typeobj = &PyInterval_Type;
-  interval_descr->kind = 'V';
-  // interval_descr->type = 'q';
-  interval_descr->type = 'i';
-  interval_descr->byteorder = '=';
-  interval_descr->flags = NPY_NEEDS_PYAPI | NPY_USE_GETITEM | NPY_USE_SETITEM;
-  interval_descr->type_num = 0; // assigned at registration
-  interval_descr->elsize = interval_elsize;
-  interval_descr->alignment = interval_alignment;
-  interval_descr->subarray = NULL;
-  interval_descr->fields = NULL;
-  interval_descr->names = NULL;
-  interval_descr->f = &_PyInterval_ArrFuncs;
-  interval_descr->metadata = NULL;
-  interval_descr->c_metadata = NULL;
+  // The interval array descr.  It is registered from a prototype in the
+  // NumPy 1.x layout, and the descriptor numpy creates from it is looked
+  // up afterwards.
+  Py_SET_TYPE(&interval_descr_proto, &PyArrayDescr_Type);
+  Py_SET_REFCNT(&interval_descr_proto, 1);
+  interval_descr_proto.typeobj = &PyInterval_Type;
+  interval_descr_proto.kind = 'V';
+  // interval_descr_proto.type = 'q';
+  interval_descr_proto.type = 'i';
+  interval_descr_proto.byteorder = '=';
+  // None of the array functions or loops touch the Python API outside of
+  // getitem/setitem, so numpy may release the GIL around them.
+  interval_descr_proto.flags = NPY_USE_GETITEM | NPY_USE_SETITEM;
+  interval_descr_proto.type_num = 0; // assigned at registration
+  interval_descr_proto.elsize = interval_elsize;
+  interval_descr_proto.alignment = interval_alignment;
+  interval_descr_proto.subarray = NULL;
+  interval_descr_proto.fields = NULL;
+  interval_descr_proto.names = NULL;
+  interval_descr_proto.f = &_PyInterval_ArrFuncs;
+  interval_descr_proto.metadata = NULL;
+  interval_descr_proto.c_metadata = NULL;
 
   Py_INCREF(&PyInterval_Type);
-  intervalNum = PyArray_RegisterDataType(interval_descr);
+  intervalNum = PyArray_RegisterDataType(&interval_descr_proto);
 
   if (intervalNum < 0) {
     INITERROR;
   }
+  interval_descr = PyArray_DescrFromType(intervalNum);
 
   register_cast_function(NPY_BOOL, intervalNum, (PyArray_VectorUnaryFunc*)BOOL_to_interval);
   register_cast_function(NPY_BYTE, intervalNum, (PyArray_VectorUnaryFunc*)BYTE_to_interval);
@@ -1296,21 +4303,32 @@ PyMODINIT_FUNC initnumpy_interval(void) {
   register_cast_function(NPY_DOUBLE, intervalNum, (PyArray_VectorUnaryFunc*)DOUBLE_to_interval);
   register_cast_function(NPY_LONGDOUBLE, intervalNum, (PyArray_VectorUnaryFunc*)LONGDOUBLE_to_interval);
 
-  // These macros will be used below
+  // These macros will be used below.  REGISTER_LOOP registers the loop
+  // interval_<cname> for the types in arg_types, with user type key.
+#ifdef INTERVAL_ARRAYMETHOD
+  #define REGISTER_LOOP(ufunc, key, cname)                              \
+    interval_register_method(ufunc, #cname, arg_types, interval_##cname##_strided, \
+                      interval_##cname##_contig, interval_##cname##_unaligned)
+  #define REGISTER_GUFUNC_LOOP(ufunc, key, name)                        \
+    interval_register_method(ufunc, #name, arg_types, name##_strided, NULL, NULL)
+#else
+  #define REGISTER_LOOP(ufunc, key, cname)                              \
+    PyUFunc_RegisterLoopForType((PyUFuncObject *)(ufunc), key,          \
+                                interval_##cname##_ufunc, arg_types, NULL)
+  #define REGISTER_GUFUNC_LOOP(ufunc, key, name)                        \
+    PyUFunc_RegisterLoopForType((PyUFuncObject *)(ufunc), key, name##_ufunc, arg_types, NULL)
+#endif
+  #define NUMPY_UFUNC(name) PyDict_GetItemString(numpy_dict, #name)
   #define REGISTER_UFUNC(name)                                          \
-    PyUFunc_RegisterLoopForType((PyUFuncObject *)PyDict_GetItemString(numpy_dict, #name), \
-                                interval_descr->type_num, interval_##name##_ufunc, arg_types, NULL)
+    REGISTER_LOOP(NUMPY_UFUNC(name), interval_descr->type_num, name)
   #define REGISTER_SCALAR_UFUNC(name)                                   \
-    PyUFunc_RegisterLoopForType((PyUFuncObject *)PyDict_GetItemString(numpy_dict, #name), \
-                                interval_descr->type_num, interval_scalar_##name##_ufunc, arg_types, NULL)
+    REGISTER_LOOP(NUMPY_UFUNC(name), interval_descr->type_num, scalar_##name)
   #define REGISTER_UFUNC_SCALAR(name)                                   \
-    PyUFunc_RegisterLoopForType((PyUFuncObject *)PyDict_GetItemString(numpy_dict, #name), \
-                                interval_descr->type_num, interval_##name##_scalar_ufunc, arg_types, NULL)
+    REGISTER_LOOP(NUMPY_UFUNC(name), interval_descr->type_num, name##_scalar)
   #define REGISTER_NEW_UFUNC_GENERAL(pyname, cname, nargin, nargout, doc) \
     tmp_ufunc = PyUFunc_FromFuncAndData(NULL, NULL, NULL, 0, nargin, nargout, \
                                         PyUFunc_None, #pyname, doc, 0); \
-    PyUFunc_RegisterLoopForType((PyUFuncObject *)tmp_ufunc,             \
-                                interval_descr->type_num, interval_##cname##_ufunc, arg_types, NULL); \
+    REGISTER_LOOP(tmp_ufunc, interval_descr->type_num, cname);         \
     PyDict_SetItemString(numpy_dict, #pyname, tmp_ufunc);               \
     Py_DECREF(tmp_ufunc)
   #define REGISTER_NEW_UFUNC(name, nargin, nargout, doc)                \
@@ -1340,6 +4358,10 @@ PyMODINIT_FUNC initnumpy_interval(void) {
   REGISTER_UFUNC(square);
   REGISTER_UFUNC(negative);
   REGISTER_UFUNC(positive);
+  REGISTER_NEW_UFUNC(relu, 1, 1,
+                     "Return max(x, 0) of each interval.\n");
+  REGISTER_NEW_UFUNC(sigmoid, 1, 1,
+                     "Return the logistic function 1/(1 + exp(-x)) of each interval.\n");
 
   // interval, interval -> bool
   arg_types[0] = interval_descr->type_num;
@@ -1355,6 +4377,48 @@ PyMODINIT_FUNC initnumpy_interval(void) {
                      'Return true if i1 is a subset (strict) of i2');
   REGISTER_NEW_UFUNC(supset, 2, 1,
                      'Return true if i1 is a superset (strict) of i2');
+  REGISTER_NEW_UFUNC(overlaps, 2, 1,
+                     "Return true if i1 and i2 have a point in common.\n");
+  REGISTER_NEW_UFUNC(certainly_lt, 2, 1,
+                     "Return true if every point of i1 is less than every point of i2.\n");
+  REGISTER_NEW_UFUNC(certainly_le, 2, 1,
+                     "Return true if every point of i1 is less than or equal to every point of i2.\n");
+  REGISTER_NEW_UFUNC(certainly_gt, 2, 1,
+                     "Return true if every point of i1 is greater than every point of i2.\n");
+  REGISTER_NEW_UFUNC(certainly_ge, 2, 1,
+                     "Return true if every point of i1 is greater than or equal to every point of i2.\n");
+  REGISTER_NEW_UFUNC(possibly_lt, 2, 1,
+                     "Return true if some point of i1 is less than some point of i2.\n");
+  REGISTER_NEW_UFUNC(possibly_le, 2, 1,
+                     "Return true if some point of i1 is less than or equal to some point of i2.\n");
+  REGISTER_NEW_UFUNC(possibly_gt, 2, 1,
+                     "Return true if some point of i1 is greater than some point of i2.\n");
+  REGISTER_NEW_UFUNC(possibly_ge, 2, 1,
+                     "Return true if some point of i1 is greater than or equal to some point of i2.\n");
+
+  // interval, interval -> int8
+  arg_types[0] = interval_descr->type_num;
+  arg_types[1] = interval_descr->type_num;
+  arg_types[2] = NPY_BYTE;
+  REGISTER_NEW_UFUNC(compare_lt, 2, 1,
+                     "Return 1 if i1 is certainly less than i2, 0 if certainly not, -1 if unknown\n"
+                     "(including when an endpoint is NaN).\n");
+  REGISTER_NEW_UFUNC(compare_le, 2, 1,
+                     "Return 1 if i1 is certainly less than or equal to i2, 0 if certainly not, -1 if unknown\n"
+                     "(including when an endpoint is NaN).\n");
+  REGISTER_NEW_UFUNC(compare_gt, 2, 1,
+                     "Return 1 if i1 is certainly greater than i2, 0 if certainly not, -1 if unknown\n"
+                     "(including when an endpoint is NaN).\n");
+  REGISTER_NEW_UFUNC(compare_ge, 2, 1,
+                     "Return 1 if i1 is certainly greater than or equal to i2, 0 if certainly not, -1 if unknown\n"
+                     "(including when an endpoint is NaN).\n");
+
+  // interval, double -> bool
+  arg_types[0] = interval_descr->type_num;
+  arg_types[1] = NPY_DOUBLE;
+  arg_types[2] = NPY_BOOL;
+  REGISTER_NEW_UFUNC(contains, 2, 1,
+                     "Return true if the point x is in the interval i.\n");
 
   // interval, interval -> interval
   arg_types[0] = interval_descr->type_num;
@@ -1366,7 +4430,7 @@ PyMODINIT_FUNC initnumpy_interval(void) {
   REGISTER_UFUNC(divide);
   REGISTER_UFUNC(true_divide);
   REGISTER_UFUNC(floor_divide);
-  REGISTER_UFUNC(matmul);
+  REGISTER_GUFUNC_LOOP(NUMPY_UFUNC(matmul), interval_descr->type_num, interval_matmul);
   REGISTER_UFUNC(maximum);
   REGISTER_UFUNC(minimum);
   REGISTER_NEW_UFUNC(union, 2, 1, 
@@ -1374,6 +4438,25 @@ PyMODINIT_FUNC initnumpy_interval(void) {
   REGISTER_NEW_UFUNC(intersection, 2, 1, 
                      "Return the intersection of intervals");
 
+  // interval, interval, interval -> interval
+  arg_types[3] = interval_descr->type_num;
+  REGISTER_NEW_UFUNC(fma, 3, 1,
+                     "fma(a, b, c): a*b + c in one pass, fused where the hardware has an fma");
+  arg_types[0] = NPY_DOUBLE;
+  REGISTER_NEW_UFUNC_GENERAL(axpy, scalar_fma, 3, 1,
+                             "axpy(alpha, x, y): alpha*x + y for a double or interval alpha");
+  arg_types[0] = interval_descr->type_num;
+  REGISTER_LOOP(NUMPY_UFUNC(axpy), interval_descr->type_num, fma);
+  // and fma with one double operand
+  arg_types[0] = NPY_DOUBLE;
+  REGISTER_SCALAR_UFUNC(fma);
+  arg_types[0] = interval_descr->type_num;
+  arg_types[1] = NPY_DOUBLE;
+  REGISTER_LOOP(NUMPY_UFUNC(fma), interval_descr->type_num, fma_scalar_mul);
+  arg_types[1] = interval_descr->type_num;
+  arg_types[2] = NPY_DOUBLE;
+  REGISTER_UFUNC_SCALAR(fma);
+
   // double, interval -> interval
   arg_types[0] = NPY_DOUBLE;
   arg_types[1] = interval_descr->type_num;
@@ -1397,15 +4480,118 @@ PyMODINIT_FUNC initnumpy_interval(void) {
   REGISTER_UFUNC_SCALAR(true_divide);
   REGISTER_UFUNC_SCALAR(floor_divide);
 
+  // interval, int64 -> interval
+  arg_types[0] = interval_descr->type_num;
+  arg_types[1] = NPY_INT64;
+  arg_types[2] = interval_descr->type_num;
+  REGISTER_LOOP(NUMPY_UFUNC(power), interval_descr->type_num, power_int64);
+
   // interval, interval -> double
   arg_types[0] = interval_descr->type_num;
   arg_types[1] = interval_descr->type_num;
   arg_types[2] = NPY_DOUBLE;
 
 
+  // The midpoint-radius dtype; its copyswap and fill functions are the
+  // interval ones, since both are a pair of doubles.
+  PyMidrad_Type.tp_base = &PyGenericArrType_Type;
+  if (PyType_Ready(&PyMidrad_Type) < 0) {
+    PyErr_Print();
+    PyErr_SetString(PyExc_SystemError, "Could not initialize PyMidrad_Type.");
+    INITERROR;
+  }
+  PyArray_InitArrFuncs(&_PyMidrad_ArrFuncs);
+  _PyMidrad_ArrFuncs.nonzero = (PyArray_NonzeroFunc*)MIDRAD_nonzero;
+  _PyMidrad_ArrFuncs.copyswap = (PyArray_CopySwapFunc*)INTERVAL_copyswap;
+  _PyMidrad_ArrFuncs.copyswapn = (PyArray_CopySwapNFunc*)INTERVAL_copyswapn;
+  _PyMidrad_ArrFuncs.setitem = (PyArray_SetItemFunc*)MIDRAD_setitem;
+  _PyMidrad_ArrFuncs.getitem = (PyArray_GetItemFunc*)MIDRAD_getitem;
+  _PyMidrad_ArrFuncs.dotfunc = (PyArray_DotFunc*)MIDRAD_dot;
+  _PyMidrad_ArrFuncs.fillwithscalar = (PyArray_FillWithScalarFunc*)INTERVAL_fillwithscalar;
+
+  Py_SET_TYPE(&midrad_descr_proto, &PyArrayDescr_Type);
+  Py_SET_REFCNT(&midrad_descr_proto, 1);
+  midrad_descr_proto.typeobj = &PyMidrad_Type;
+  // A kind of its own: numpy treats casts between two 'V' user types of
+  // the same size as safe, which would let interval operands promote to
+  // midrad.  Only midrad -> interval is safe.
+  midrad_descr_proto.kind = 'r';
+  midrad_descr_proto.type = 'r';
+  midrad_descr_proto.byteorder = '=';
+  midrad_descr_proto.flags = NPY_USE_GETITEM | NPY_USE_SETITEM;
+  midrad_descr_proto.type_num = 0;
+  midrad_descr_proto.elsize = sizeof(midrad);
+  midrad_descr_proto.alignment = offsetof(midrad_align_test, q);
+  midrad_descr_proto.subarray = NULL;
+  midrad_descr_proto.fields = NULL;
+  midrad_descr_proto.names = NULL;
+  midrad_descr_proto.f = &_PyMidrad_ArrFuncs;
+  midrad_descr_proto.metadata = NULL;
+  midrad_descr_proto.c_metadata = NULL;
+
+  Py_INCREF(&PyMidrad_Type);
+  midradNum = PyArray_RegisterDataType(&midrad_descr_proto);
+  if (midradNum < 0) {
+    INITERROR;
+  }
+  midrad_descr = PyArray_DescrFromType(midradNum);
+
+  // Reals and midrad convert to interval implicitly; interval to midrad
+  // only with astype.
+  register_cast_function(midradNum, intervalNum, (PyArray_VectorUnaryFunc*)MIDRAD_to_interval);
+  PyArray_RegisterCastFunc(interval_descr, midradNum, (PyArray_VectorUnaryFunc*)INTERVAL_to_midrad);
+  register_cast_function(NPY_BOOL, midradNum, (PyArray_VectorUnaryFunc*)BOOL_to_midrad);
+  register_cast_function(NPY_INT, midradNum, (PyArray_VectorUnaryFunc*)INT_to_midrad);
+  register_cast_function(NPY_LONG, midradNum, (PyArray_VectorUnaryFunc*)LONG_to_midrad);
+  register_cast_function(NPY_LONGLONG, midradNum, (PyArray_VectorUnaryFunc*)LONGLONG_to_midrad);
+  register_cast_function(NPY_FLOAT, midradNum, (PyArray_VectorUnaryFunc*)FLOAT_to_midrad);
+  register_cast_function(NPY_DOUBLE, midradNum, (PyArray_VectorUnaryFunc*)DOUBLE_to_midrad);
+
+  #define REGISTER_MIDRAD_UFUNC(name, cname)                            \
+    REGISTER_LOOP(NUMPY_UFUNC(name), midradNum, midrad_##cname)
+  arg_types[0] = midradNum;
+  arg_types[1] = midradNum;
+  REGISTER_MIDRAD_UFUNC(negative, negative);
+  arg_types[2] = midradNum;
+  REGISTER_MIDRAD_UFUNC(add, add);
+  REGISTER_MIDRAD_UFUNC(subtract, subtract);
+  REGISTER_MIDRAD_UFUNC(multiply, multiply);
+  REGISTER_GUFUNC_LOOP(NUMPY_UFUNC(matmul), midradNum, midrad_matmul);
+  arg_types[1] = NPY_DOUBLE;
+  REGISTER_MIDRAD_UFUNC(add, add_scalar);
+  REGISTER_MIDRAD_UFUNC(subtract, subtract_scalar);
+  REGISTER_MIDRAD_UFUNC(multiply, multiply_scalar);
+  REGISTER_MIDRAD_UFUNC(true_divide, true_divide_scalar);
+  arg_types[0] = NPY_DOUBLE;
+  arg_types[1] = midradNum;
+  REGISTER_MIDRAD_UFUNC(add, scalar_add);
+  REGISTER_MIDRAD_UFUNC(subtract, scalar_subtract);
+  REGISTER_MIDRAD_UFUNC(multiply, scalar_multiply);
+
+#ifdef INTERVAL_ARRAYMETHOD
+  {
+    int k;
+    for (k = 0; k < interval_nsignatures; k++) {
+      if (interval_add_promoters(&interval_signatures[k]) < 0) {
+        INITERROR;
+      }
+    }
+  }
+#endif
+  if (PyErr_Occurred()) {
+    INITERROR;
+  }
+
+  PyModule_AddObject(module, "midrad", (PyObject *)&PyMidrad_Type);
+
   // Finally, add this interval object to the interval module itself
   PyModule_AddObject(module, "interval", (PyObject *)&PyInterval_Type);
 
+  // Export the C API for other extensions
+  interval_capi.interval_type_num = intervalNum;
+  PyModule_AddObject(module, "_C_API",
+                     PyCapsule_New(&interval_capi, NPINTERVAL_CAPSULE_NAME, NULL));
+
   // /* Create matrix multiply generalized ufunc */
   // PyObject* gufunc = PyUFunc_FromFuncAndDataAndSignature(0,0,0,0,2,1,PyUFunc_None,(char*)"matrix_multiply",(char*)"return result of multiplying two matrices of intervals",0,"(m,n),(n,p)->(m,p)");
   // if (!gufunc) {
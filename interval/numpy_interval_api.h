@@ -0,0 +1,132 @@
+#ifndef __NUMPY_INTERVAL_API_H__
+#define __NUMPY_INTERVAL_API_H__
+
+/**
+ * Public C API of the npinterval.interval.numpy_interval extension.
+ *
+ * Downstream extensions that only need interval arithmetic can include
+ * "interval.h" directly; its kernels are static inline and need no Python.
+ * To create or inspect interval scalars and arrays, include this header,
+ * call import_npinterval() once (e.g. in the module init function, after
+ * import_array()), and go through NpInterval_API:
+ *
+ *     if (import_npinterval() < 0) { return NULL; }
+ *     PyObject *o = NpInterval_API->PyInterval_FromInterval(i);
+ *     int type_num = NpInterval_API->interval_type_num;
+ *
+ * The function table is versioned: new entries are only ever appended, and
+ * NPINTERVAL_CAPI_VERSION is bumped when they are.  Use
+ * npinterval's get_include() for the include directory.
+*/
+
+#include <Python.h>
+#include "interval.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NPINTERVAL_CAPI_VERSION 2
+#define NPINTERVAL_CAPSULE_NAME "npinterval.interval.numpy_interval._C_API"
+
+typedef struct {
+    PyObject_HEAD
+    interval obval;
+} PyInterval;
+
+typedef struct {
+    int version;
+    // The numpy type number of the interval dtype.
+    int interval_type_num;
+    PyTypeObject *PyInterval_Type;
+    PyObject *(*PyInterval_FromInterval)(interval);
+
+    interval (*add)(interval, interval);
+    interval (*add_scalar)(interval, double);
+    interval (*scalar_add)(double, interval);
+    interval (*subtract)(interval, interval);
+    interval (*subtract_scalar)(interval, double);
+    interval (*scalar_subtract)(double, interval);
+    interval (*multiply)(interval, interval);
+    interval (*multiply_scalar)(interval, double);
+    interval (*scalar_multiply)(double, interval);
+    interval (*inverse)(interval);
+    interval (*divide)(interval, interval);
+    interval (*divide_scalar)(interval, double);
+    interval (*scalar_divide)(double, interval);
+    interval (*square)(interval);
+    interval (*power_scalar)(interval, double);
+    interval (*negative)(interval);
+    interval (*sin)(interval);
+    interval (*cos)(interval);
+    interval (*tan)(interval);
+    interval (*arctan)(interval);
+    interval (*tanh)(interval);
+    interval (*exp)(interval);
+    interval (*sqrt)(interval);
+    double (*norm)(interval);
+    interval (*union_)(interval, interval);
+    interval (*intersection)(interval, interval);
+    interval (*minimum)(interval, interval);
+    interval (*maximum)(interval, interval);
+    int (*nonzero)(interval);
+    int (*equal)(interval, interval);
+    int (*not_equal)(interval, interval);
+    int (*subseteq)(interval, interval);
+    int (*supseteq)(interval, interval);
+    int (*subset)(interval, interval);
+    int (*supset)(interval, interval);
+    // Version 2.
+    interval (*power_int)(interval, long);
+    interval (*fma)(interval, interval, interval);
+    interval (*fma_scalar)(interval, interval, double);
+    interval (*scalar_fma)(double, interval, interval);
+    int (*certainly_lt)(interval, interval);
+    int (*certainly_le)(interval, interval);
+    int (*certainly_gt)(interval, interval);
+    int (*certainly_ge)(interval, interval);
+    int (*possibly_lt)(interval, interval);
+    int (*possibly_le)(interval, interval);
+    int (*possibly_gt)(interval, interval);
+    int (*possibly_ge)(interval, interval);
+    int (*compare_lt)(interval, interval);
+    int (*compare_le)(interval, interval);
+    int (*compare_gt)(interval, interval);
+    int (*compare_ge)(interval, interval);
+    int (*contains)(interval, double);
+    int (*overlaps)(interval, interval);
+    interval (*relu)(interval);
+    interval (*sigmoid)(interval);
+} NpInterval_CAPI;
+
+#ifndef NPINTERVAL_BUILDING_MODULE
+
+static NpInterval_CAPI *NpInterval_API = NULL;
+
+#define PyInterval_Check(o) PyObject_TypeCheck((o), NpInterval_API->PyInterval_Type)
+#define PyInterval_AS_INTERVAL(o) (((PyInterval *)(o))->obval)
+
+static int
+import_npinterval(void)
+{
+    NpInterval_API = (NpInterval_CAPI *)PyCapsule_Import(NPINTERVAL_CAPSULE_NAME, 0);
+    if (NpInterval_API == NULL) {
+        return -1;
+    }
+    if (NpInterval_API->version < NPINTERVAL_CAPI_VERSION) {
+        PyErr_Format(PyExc_ImportError,
+                     "npinterval C API version %d is older than the version %d this module was built against",
+                     NpInterval_API->version, NPINTERVAL_CAPI_VERSION);
+        NpInterval_API = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
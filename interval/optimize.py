@@ -0,0 +1,110 @@
+"""Global minimization of f : R^n -> R over a box.
+
+`minimize` is Moore-Skelboe branch and bound.  f is a vectorized
+callable mapping an (m, n) interval array of boxes to the (m,) interval
+enclosures of f over them, and it must also accept boxes of degenerate
+intervals (points); compositions of the interval ufuncs qualify.  The
+work list lives natively (a min-heap of boxes keyed on the lower bound
+of f, see interval_optimize.h).  Per iteration the engine
+
+  1. pops the `batch` boxes of least lower bound and bisects each across
+     its widest side,
+  2. evaluates f over all the halves, and over their midpoints, in a
+     single call,
+  3. lowers the upper bound `best` of the minimum to the least f(mid).u
+     (or F.u), and
+  4. queues the halves whose lower bound does not exceed best, dropping
+     queued boxes that best has overtaken.
+
+Large batches make the interval ufuncs inside f run threaded, so the
+evaluation of a batch is spread over the threads of set_num_threads.
+"""
+
+import numpy
+
+from npinterval.interval.numpy_interval import (interval, minimizer_new, minimizer_push,
+                                                minimizer_bound, minimizer_split,
+                                                minimizer_state, minimizer_result)
+
+__all__ = ['minimize']
+
+_lu_dtype = numpy.dtype([('l','=f8'),('u','=f8')])
+
+def _evaluate (f, X) :
+    F = numpy.asarray(f(X))
+    if F.dtype != interval :
+        raise TypeError("f must return an interval array, got dtype %s" % F.dtype)
+    F = F.reshape(-1)
+    if len(F) != len(X) :
+        raise ValueError("f returned %d values for %d boxes" % (len(F), len(X)))
+    return F
+
+def _midpoints (X) :
+    lu = numpy.ascontiguousarray(X).view(_lu_dtype)
+    c = numpy.empty(X.shape, dtype=_lu_dtype)
+    c['l'] = c['u'] = 0.5*lu['l'] + 0.5*lu['u']
+    return c.view(interval)
+
+def minimize (f, X0, tol=1e-6, ftol=0., batch=512, midpoint=True, max_boxes=1000000) :
+    """Enclose the global minimum of f over the box (or boxes) X0.
+
+    Parameters
+    ----------
+    f : callable
+        (m, n) interval array -> (m,) interval array.
+    X0 : array_like of interval, shape (n,) or (m, n)
+        Search region(s); must be bounded.
+    tol : float
+        Boxes narrower than tol in every component are not split further.
+    ftol : float
+        Stop once the enclosure of the minimum is at most ftol wide.
+    batch : int
+        Boxes popped (and split in two) per iteration.
+    midpoint : bool
+        Also evaluate f at the midpoint of every new box for upper
+        bounds; otherwise only the upper bounds of F are used.
+    max_boxes : int
+        Budget of box evaluations.
+
+    Returns
+    -------
+    fmin : interval
+        Enclosure of the global minimum of f over X0.
+    boxes : ndarray of interval, shape (k, n)
+        Candidate minimizers, least lower bound first: every global
+        minimizer in X0 lies in one of them.
+    """
+    X0 = numpy.asarray(X0)
+    if X0.dtype != interval :
+        raise TypeError("X0 must be an interval array")
+    X0 = numpy.ascontiguousarray(numpy.atleast_2d(X0))
+    lu = X0.view(_lu_dtype)
+    if not numpy.all(numpy.isfinite(lu['l']) & numpy.isfinite(lu['u']) & (lu['l'] <= lu['u'])) :
+        raise ValueError("X0 must be bounded and nonempty")
+    n = X0.shape[1]
+
+    m = minimizer_new(n)
+    minimizer_push(m, X0, _evaluate(f, X0))
+    if midpoint :
+        minimizer_bound(m, _evaluate(f, _midpoints(X0)))
+    evaluated = len(X0)
+
+    while evaluated < max_boxes :
+        lower, best, queued = minimizer_state(m)
+        if not queued or best - lower <= ftol :
+            break
+        X = minimizer_split(m, batch, tol)
+        if not len(X) :
+            continue
+        if midpoint :
+            F = _evaluate(f, numpy.concatenate((X, _midpoints(X))))
+            minimizer_bound(m, F[len(X):])
+            F = F[:len(X)]
+        else :
+            F = _evaluate(f, X)
+        minimizer_push(m, X, F)
+        evaluated += len(X)
+
+    lower, best, _ = minimizer_state(m)
+    boxes, _ = minimizer_result(m)
+    return interval(lower, best), boxes
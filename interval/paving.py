@@ -0,0 +1,107 @@
+"""Compact unions of boxes as regular subpavings.
+
+A `Paving` stores a subset of a fixed root box as a binary k-d tree in
+which every node is bisected at the midpoint of its widest side.  Sibling
+leaves that are both in the set are merged on the spot, so inserting
+overlapping or adjacent boxes does not grow the representation, and two
+pavings over the same root combine node by node into their union or
+intersection.  Boxes come back out as one contiguous interval array.
+"""
+
+import numpy
+
+from npinterval.interval.numpy_interval import (interval, paving_new, paving_insert, paving_union,
+                                                paving_intersection, paving_volume, paving_count,
+                                                paving_boxes, paving_compact)
+
+__all__ = ['Paving']
+
+_lu_dtype = numpy.dtype([('l','=f8'),('u','=f8')])
+
+
+class Paving :
+    """A subset of the root box, built from boxes.
+
+    Parameters
+    ----------
+    root : array_like of interval, shape (n,)
+        Bounded box containing everything the paving can hold.
+    eps : float
+        Resolution, positive and finite: cells narrower than eps in every
+        side are not bisected further.  Defaults to 1e-3 of the widest
+        side of root.
+    outer : bool
+        Whether a cell at resolution eps that a box only partly covers is
+        put in the set (an outer approximation of the union of inserted
+        boxes) or left out (an inner one).
+    """
+
+    def __init__ (self, root, eps=None, outer=True) :
+        root = numpy.ascontiguousarray(root)
+        if root.dtype != interval or root.ndim != 1 :
+            raise TypeError("root must be a 1-D interval array")
+        lu = root.view(_lu_dtype)
+        if not numpy.all(numpy.isfinite(lu['l']) & numpy.isfinite(lu['u']) & (lu['l'] <= lu['u'])) :
+            raise ValueError("root must be a bounded, nonempty box")
+        self.root = root.copy()
+        if eps is None :
+            # Any resolution leaves a point root whole.
+            eps = 1e-3*float(numpy.max(lu['u'] - lu['l'], initial=0)) or 1.0
+        eps = float(eps)
+        if not (eps > 0 and numpy.isfinite(eps)) :
+            raise ValueError("eps must be positive and finite, got %r" % eps)
+        self.eps = eps
+        self.outer = bool(outer)
+        self._paving = paving_new(self.root)
+
+    @classmethod
+    def _wrap (cls, like, capsule) :
+        p = cls.__new__(cls)
+        p.root, p.eps, p.outer, p._paving = like.root, like.eps, like.outer, capsule
+        return p
+
+    @property
+    def n (self) :
+        return len(self.root)
+
+    def insert (self, boxes) :
+        """Add the boxes of an (m, n) (or (n,)) interval array to the set."""
+        boxes = numpy.ascontiguousarray(boxes)
+        if boxes.dtype != interval :
+            raise TypeError("expected an interval array, got dtype %s" % boxes.dtype)
+        paving_insert(self._paving, boxes.reshape(-1, self.n), self.eps, self.outer)
+        return self
+
+    def _check (self, other) :
+        if not isinstance(other, Paving) :
+            raise TypeError("expected a Paving, got %s" % type(other).__name__)
+        if not numpy.array_equal(self.root.view(_lu_dtype), other.root.view(_lu_dtype)) :
+            raise ValueError("pavings must share the same root box")
+
+    def union (self, other) :
+        self._check(other)
+        return Paving._wrap(self, paving_union(self._paving, other._paving))
+
+    def intersection (self, other) :
+        self._check(other)
+        return Paving._wrap(self, paving_intersection(self._paving, other._paving))
+
+    def __or__ (self, other) :
+        return self.union(other) if isinstance(other, Paving) else NotImplemented
+
+    def __and__ (self, other) :
+        return self.intersection(other) if isinstance(other, Paving) else NotImplemented
+
+    def volume (self) :
+        return paving_volume(self._paving)
+
+    def boxes (self) :
+        """The boxes of the set, as a contiguous (K, n) interval array."""
+        return paving_boxes(self._paving)
+
+    def __len__ (self) :
+        return paving_count(self._paving)
+
+    def compact (self) :
+        """Release the memory of nodes freed by merging; returns the node count."""
+        return paving_compact(self._paving)
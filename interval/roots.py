@@ -0,0 +1,188 @@
+"""Isolation of all zeros of f : R^n -> R^n in a box.
+
+`isolate` runs interval Newton (Krawczyk) contraction and bisection over a
+work queue of boxes, a batch at a time.  f and its interval Jacobian are
+vectorized callables: f maps an (m, n) interval array of boxes to their
+(m, n) interval images, and also accepts (m, n) interval arrays of
+degenerate intervals (points); jac maps (m, n) boxes to (m, n, n)
+interval Jacobian enclosures.  Compositions of the interval ufuncs
+qualify.  Per batch, the engine
+
+  1. drops boxes where some component of f(X) excludes 0,
+  2. applies the native Krawczyk operator (threaded over the batch),
+     K(X) = c - C f(c) + (I - C J(X))(X - c), with c the midpoints and C
+     the midpoint-Jacobian inverses from numpy.linalg.inv,
+  3. drops boxes with K(X) & X empty, certifies boxes with K(X) interior
+     to X (they contain exactly one zero, which Krawczyk iteration then
+     narrows down), and
+  4. keeps K(X) & X if that shrank the box enough, and otherwise
+     bisects it across its widest component.
+
+Boxes are split slightly off-center, so a zero sitting exactly on a
+midpoint does not end up on the boundary of both halves.
+"""
+
+import numpy
+
+from npinterval.interval.numpy_interval import interval, krawczyk
+
+__all__ = ['isolate']
+
+_lu_dtype = numpy.dtype([('l','=f8'),('u','=f8')])
+
+# Where boxes are split, as a fraction of the widest component.
+_SPLIT = 127/256
+
+def _bounds (iarray) :
+    lu = numpy.ascontiguousarray(iarray).view(_lu_dtype)
+    return lu['l'], lu['u']
+
+def _from_bounds (l, u) :
+    lu = numpy.empty(numpy.shape(l), dtype=_lu_dtype)
+    lu['l'] = l
+    lu['u'] = u
+    return lu.view(interval)
+
+def _inverse (mats) :
+    try :
+        with numpy.errstate(all='ignore') :
+            return numpy.linalg.inv(mats)
+    except numpy.linalg.LinAlgError :
+        out = numpy.zeros_like(mats)
+        for k in range(len(mats)) :
+            try :
+                out[k] = numpy.linalg.inv(mats[k])
+            except numpy.linalg.LinAlgError :
+                pass
+        return out
+
+
+class _BoxQueue :
+    """Growable LIFO stack of (n,) boxes stored in one interval array."""
+    def __init__ (self, n, capacity=1024) :
+        self.buf = numpy.empty((capacity, n), dtype=interval)
+        self.size = 0
+
+    def push (self, boxes) :
+        k = len(boxes)
+        if self.size + k > len(self.buf) :
+            grown = numpy.empty((max(2*len(self.buf), self.size + k), self.buf.shape[1]), dtype=interval)
+            grown[:self.size] = self.buf[:self.size]
+            self.buf = grown
+        self.buf[self.size:self.size+k] = boxes
+        self.size += k
+
+    def pop (self, k) :
+        k = min(k, self.size)
+        self.size -= k
+        return self.buf[self.size:self.size+k].copy()
+
+
+def _step (f, jac, X) :
+    """One Krawczyk step on a batch of boxes; returns (K(X) & X, verdict)."""
+    c = numpy.ascontiguousarray(sum(_bounds(X))/2)
+    fc = numpy.asarray(f(c.astype(interval)))
+    J = numpy.asarray(jac(X))
+    Jl, Ju = _bounds(J)
+    C = _inverse((Jl + Ju)/2)
+    return krawczyk(X, c, fc, J, C)
+
+def isolate (f, jac, X0, tol=1e-10, batch=256, max_boxes=1000000, maxiter=64) :
+    """Enclose all zeros of f in the box (or boxes) X0.
+
+    Parameters
+    ----------
+    f : callable
+        (m, n) interval array -> (m, n) interval array.
+    jac : callable
+        (m, n) interval array -> (m, n, n) interval Jacobians of f.
+    X0 : array_like of interval, shape (n,) or (m, n)
+        Search region(s); must be bounded.
+    tol : float
+        Boxes narrower than tol in every component are not split further.
+    batch : int
+        Boxes evaluated per call of f and jac.
+    max_boxes : int
+        Budget of box evaluations; whatever is still queued when it runs
+        out is returned as undecided.
+    maxiter : int
+        Krawczyk iterations used to narrow down a certified box.
+
+    Returns
+    -------
+    unique : ndarray of interval, shape (k, n)
+        Disjoint boxes, each containing exactly one zero of f.
+    undecided : ndarray of interval, shape (j, n)
+        Boxes narrower than tol (or left over) that may contain zeros.
+        Every zero in X0 lies in one of the returned boxes.
+    """
+    X0 = numpy.asarray(X0)
+    if X0.dtype != interval :
+        raise TypeError("X0 must be an interval array")
+    X0 = numpy.atleast_2d(X0)
+    n = X0.shape[1]
+    queue = _BoxQueue(n)
+    queue.push(X0)
+    unique, undecided = [], []
+    evaluated = 0
+
+    while queue.size and evaluated < max_boxes :
+        X = queue.pop(batch)
+        evaluated += len(X)
+
+        # Exclusion: 0 not in f(X).
+        Fl, Fu = _bounds(numpy.asarray(f(X)))
+        X = X[numpy.all((Fl <= 0) & (Fu >= 0), axis=1)]
+        if not len(X) :
+            continue
+
+        Y, verdict = _step(f, jac, X)
+
+        U = Y[verdict == 1]
+        for _ in range(maxiter) :
+            if not len(U) :
+                break
+            Ul, Uu = _bounds(U)
+            if numpy.all(Uu - Ul < tol) :
+                break
+            V, _verdict = _step(f, jac, U)
+            Vl, Vu = _bounds(V)
+            if numpy.array_equal(Vl, Ul) and numpy.array_equal(Vu, Uu) :
+                break
+            U = V
+        if len(U) :
+            unique.append(U)
+
+        keep = verdict == 2
+        X, Y = X[keep], Y[keep]
+        Xl, Xu = _bounds(X)
+        Yl, Yu = _bounds(Y)
+        wX = (Xu - Xl).max(axis=1)
+        W = Yu - Yl
+        wY = W.max(axis=1)
+        small = wY < tol
+        if numpy.any(small) :
+            undecided.append(Y[small])
+        # Boxes that Krawczyk shrank to at most half their size are tried
+        # again as they are; the rest are bisected.
+        shrunk = ~small & (wY <= wX/2)
+        queue.push(Y[shrunk])
+        split = ~small & ~shrunk
+        if numpy.any(split) :
+            Yl, Yu, W = Yl[split], Yu[split], W[split]
+            rows = numpy.arange(len(Yl))
+            k = numpy.argmax(W, axis=1)
+            m = Yl[rows, k] + _SPLIT*W[rows, k]
+            lo_u = Yu.copy()
+            lo_u[rows, k] = m
+            hi_l = Yl.copy()
+            hi_l[rows, k] = m
+            queue.push(_from_bounds(hi_l, Yu))
+            queue.push(_from_bounds(Yl, lo_u))
+
+    if queue.size :
+        undecided.append(queue.pop(queue.size))
+    empty = numpy.empty((0, n), dtype=interval)
+    unique = numpy.concatenate(unique) if unique else empty
+    undecided = numpy.concatenate(undecided) if undecided else empty
+    return unique, undecided
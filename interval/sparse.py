@@ -0,0 +1,184 @@
+"""Sparse interval matrices in CSR and CSC storage.
+
+`csr_matrix` and `csc_matrix` hold an interval (or float) value per
+stored entry, in the same (data, indices, indptr) layout as
+`scipy.sparse`, and multiply dense interval or float vectors and matrices
+with the native `csr_matmul` kernel.  Rows are computed independently
+across threads and each row is summed in storage order, so results do not
+depend on the number of threads.  A float matrix times an interval
+operand only needs two endpoint products per entry instead of four.
+
+CSC matrices are multiplied through their CSR form, built once and
+cached; its rows keep the entries in column order, which is the order a
+column-by-column product would add them in.
+"""
+
+import numpy
+
+from npinterval.interval.numpy_interval import interval, csr_matmul
+
+__all__ = ['csr_matrix', 'csc_matrix', 'issparse']
+
+
+def _as_data (data) :
+    data = numpy.asarray(data)
+    if data.dtype != interval :
+        data = data.astype(numpy.float64)
+    return numpy.ascontiguousarray(data.reshape(-1))
+
+def _transpose_storage (data, indices, indptr, n_minor) :
+    """Swap the major and minor axes of compressed storage."""
+    n_major = len(indptr) - 1
+    major = numpy.repeat(numpy.arange(n_major, dtype=numpy.intp), numpy.diff(indptr))
+    order = numpy.argsort(indices, kind='stable')
+    t_indptr = numpy.zeros(n_minor + 1, dtype=numpy.intp)
+    numpy.cumsum(numpy.bincount(indices, minlength=n_minor), out=t_indptr[1:])
+    return data[order], major[order], t_indptr
+
+
+class _compressed :
+    """Shared implementation of csr_matrix and csc_matrix.
+
+    Parameters
+    ----------
+    arg : tuple, sparse matrix, or array_like
+        ``(data, indices, indptr)`` with `shape` given; a matrix of either
+        class here or any `scipy.sparse` matrix/array; or a dense 2-D
+        interval or float array, whose nonzero entries are stored.
+    shape : tuple of int
+        (rows, columns); required for the tuple form.
+    data : array_like
+        With a scipy matrix, interval values to store in place of its
+        float data, in the order of its stored entries after conversion
+        to this format.
+    """
+    _major = 0
+    # Make numpy defer `ndarray @ matrix` to __rmatmul__.
+    __array_ufunc__ = None
+
+    def __init__ (self, arg, shape=None, data=None) :
+        if isinstance(arg, tuple) and len(arg) == 3 :
+            if shape is None :
+                raise ValueError("shape is required with (data, indices, indptr)")
+            d, indices, indptr = arg
+        elif isinstance(arg, _compressed) :
+            other = arg if type(arg) is type(self) else arg._convert()
+            d, indices, indptr, shape = other.data, other.indices, other.indptr, other.shape
+        elif hasattr(arg, 'tocsr') and hasattr(arg, 'tocsc') :
+            # A copy: sum_duplicates works in place.
+            other = arg.tocsr(copy=True) if self._major == 0 else arg.tocsc(copy=True)
+            other.sum_duplicates()
+            d, indices, indptr, shape = other.data, other.indices, other.indptr, other.shape
+        else :
+            dense = numpy.asarray(arg)
+            if dense.ndim != 2 :
+                raise ValueError("a dense matrix must be 2-D")
+            if self._major == 1 :
+                dense = dense.T
+            rows, cols = numpy.nonzero(dense)
+            d, indices = dense[rows, cols], cols
+            indptr = numpy.zeros(dense.shape[0] + 1, dtype=numpy.intp)
+            numpy.cumsum(numpy.bincount(rows, minlength=dense.shape[0]), out=indptr[1:])
+            shape = dense.shape[::-1] if self._major == 1 else dense.shape
+        if data is not None :
+            d = data
+        self.shape = (int(shape[0]), int(shape[1]))
+        self.data = _as_data(d)
+        self.indices = numpy.ascontiguousarray(indices, dtype=numpy.intp)
+        self.indptr = numpy.ascontiguousarray(indptr, dtype=numpy.intp)
+        n_major, n_minor = self.shape[self._major], self.shape[1 - self._major]
+        if self.indptr.shape != (n_major + 1,) or self.indptr[0] != 0 :
+            raise ValueError("indptr must have length %d and start at 0" % (n_major + 1))
+        if numpy.any(numpy.diff(self.indptr) < 0) or self.indptr[-1] > len(self.indices) :
+            raise ValueError("indptr must be non-decreasing and within indices")
+        if len(self.data) != len(self.indices) :
+            raise ValueError("data and indices must have the same length")
+        self.data = self.data[:self.indptr[-1]]
+        self.indices = self.indices[:self.indptr[-1]]
+        if len(self.indices) and (self.indices.min() < 0 or self.indices.max() >= n_minor) :
+            raise ValueError("index out of range for shape %r" % (self.shape,))
+        self._csr = None
+
+    @property
+    def nnz (self) :
+        return int(self.indptr[-1])
+
+    @property
+    def dtype (self) :
+        return self.data.dtype
+
+    def __repr__ (self) :
+        return '<%dx%d %s of %s with %d stored entries>' % (
+            self.shape[0], self.shape[1], type(self).__name__, self.dtype, self.nnz)
+
+    def _convert (self) :
+        """The same matrix in the other storage format."""
+        d, indices, indptr = _transpose_storage(self.data, self.indices, self.indptr,
+                                                self.shape[1 - self._major])
+        other = csc_matrix if self._major == 0 else csr_matrix
+        return other((d, indices, indptr), shape=self.shape)
+
+    def tocsr (self) :
+        return self if self._major == 0 else self._convert()
+
+    def tocsc (self) :
+        return self if self._major == 1 else self._convert()
+
+    @property
+    def T (self) :
+        other = csc_matrix if self._major == 0 else csr_matrix
+        return other((self.data, self.indices, self.indptr), shape=self.shape[::-1])
+
+    def transpose (self) :
+        return self.T
+
+    def toarray (self) :
+        csr = self._row_storage()
+        out = numpy.zeros(self.shape, dtype=self.dtype)
+        rows = numpy.repeat(numpy.arange(self.shape[0], dtype=numpy.intp), numpy.diff(csr.indptr))
+        numpy.add.at(out, (rows, csr.indices), csr.data)
+        return out
+
+    def _row_storage (self) :
+        if self._major == 0 :
+            return self
+        if self._csr is None :
+            self._csr = self._convert()
+        return self._csr
+
+    def dot (self, other) :
+        """The product with a dense interval or float vector or matrix."""
+        other = numpy.asarray(other)
+        if other.ndim not in (1, 2) or other.shape[0] != self.shape[1] :
+            raise ValueError("dimension mismatch: %r @ %r" % (self.shape, other.shape))
+        if other.dtype != interval :
+            other = other.astype(numpy.float64)
+            if self.dtype != interval :
+                other = other.astype(interval)
+        b = numpy.ascontiguousarray(other.reshape(other.shape[0], -1))
+        csr = self._row_storage()
+        res = csr_matmul(csr.indptr, csr.indices, csr.data, b, self.shape[0])
+        return res.reshape(-1) if other.ndim == 1 else res
+
+    def __matmul__ (self, other) :
+        if isinstance(other, _compressed) :
+            return NotImplemented
+        return self.dot(other)
+
+    def __rmatmul__ (self, other) :
+        other = numpy.asarray(other)
+        return self.T.dot(other.T).T
+
+
+class csr_matrix (_compressed) :
+    """Compressed sparse row interval matrix."""
+    _major = 0
+
+
+class csc_matrix (_compressed) :
+    """Compressed sparse column interval matrix."""
+    _major = 1
+
+
+def issparse (x) :
+    return isinstance(x, _compressed)
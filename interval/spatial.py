@@ -0,0 +1,77 @@
+"""Spatial index over interval boxes.
+
+`BoxTree` is a bounding volume hierarchy over the rows of an (N, n)
+interval array, each row being a box in R^n.  It answers batched overlap,
+containment and point-location queries in roughly O(log N) per query
+plus the size of the answer, instead of the O(N M) of broadcasting
+`intersection`/`subseteq` over all pairs.  Queries run natively and
+split the batch across threads; the pairs come back ordered by query,
+identically for any number of threads.
+"""
+
+import numpy
+
+from npinterval.interval.numpy_interval import interval, bvh_build, bvh_insert, bvh_query
+
+__all__ = ['BoxTree']
+
+_PREDICATES = {'overlaps' : 0, 'within' : 1, 'contains' : 2}
+
+_lu_dtype = numpy.dtype([('l','=f8'),('u','=f8')])
+
+def _boxes (boxes, n=None) :
+    boxes = numpy.asarray(boxes)
+    if boxes.dtype != interval :
+        raise TypeError("expected an interval array, got dtype %s" % boxes.dtype)
+    if boxes.ndim == 1 and n is not None :
+        boxes = boxes.reshape(-1, n)
+    if boxes.ndim != 2 :
+        raise ValueError("expected an (N, n) interval array, got shape %r" % (boxes.shape,))
+    return numpy.ascontiguousarray(boxes)
+
+
+class BoxTree :
+    """Bulk-loaded R-tree/BVH over the rows of an (N, n) interval array.
+
+    Boxes are numbered 0..N-1 in the order given, and boxes added with
+    `insert` continue the numbering.  Inserts and queries hold the GIL,
+    so a tree may be shared between Python threads.
+    """
+
+    def __init__ (self, boxes) :
+        boxes = _boxes(boxes)
+        self.n = boxes.shape[1]
+        self._size = boxes.shape[0]
+        self._tree = bvh_build(boxes)
+
+    def __len__ (self) :
+        return self._size
+
+    def insert (self, boxes) :
+        """Add boxes (an (m, n) interval array); returns their indices."""
+        boxes = _boxes(boxes, self.n)
+        bvh_insert(self._tree, boxes)
+        start = self._size
+        self._size += len(boxes)
+        return numpy.arange(start, self._size)
+
+    def query (self, boxes, predicate='overlaps') :
+        """Pairs (i, j) where stored box j relates to query box i.
+
+        predicate is 'overlaps' (box j & query i is nonempty), 'within'
+        (box j is a subset of query i) or 'contains' (query i is a subset
+        of box j).  Returns an (K, 2) intp array.
+        """
+        if predicate not in _PREDICATES :
+            raise ValueError("unknown predicate %r; expected one of %s" % (predicate, ', '.join(_PREDICATES)))
+        return bvh_query(self._tree, _boxes(boxes, self.n), _PREDICATES[predicate])
+
+    def query_points (self, points) :
+        """Pairs (i, j) where stored box j contains point i of an (m, n) float array."""
+        points = numpy.asarray(points, dtype=numpy.float64)
+        if points.ndim == 1 :
+            points = points.reshape(-1, self.n)
+        lu = numpy.empty(points.shape, dtype=_lu_dtype)
+        lu['l'] = points
+        lu['u'] = points
+        return bvh_query(self._tree, lu.view(interval), _PREDICATES['contains'])
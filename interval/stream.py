@@ -0,0 +1,216 @@
+"""Chunked, out-of-core evaluation of interval ufuncs.
+
+`stream` applies an interval ufunc (or a chain of them) to arrays that may
+be far larger than RAM, typically memory maps from `open_memmap`/`load`,
+and writes the result into a (memory-mapped) output block by block.
+
+Each RAM-sized block of the memory-mapped inputs is read ahead into one
+of two staging buffers by a reader thread while the previous block is
+being evaluated, so disk reads overlap with compute.  The block itself is
+split into cache-sized pieces evaluated on a thread pool; the interval
+ufunc loops release the GIL, and since every piece is independent the
+result does not depend on the number of threads.  Once a block is done
+its pages are written back and dropped from the page cache, so a pass
+over the data streams at disk speed instead of thrashing.
+"""
+
+import mmap
+import os
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy
+
+__all__ = ['stream']
+
+_PAGE = mmap.ALLOCATIONGRANULARITY
+
+
+def _find_memmap (arr) :
+    while arr is not None :
+        if isinstance(arr, numpy.memmap) and getattr(arr, '_mmap', None) is not None :
+            return arr
+        arr = getattr(arr, 'base', None)
+    return None
+
+class _Mapped :
+    """The file mapping behind a C-contiguous memory-mapped array."""
+    def __init__ (self, arr) :
+        self.arr = arr
+        self.m = None
+        m = _find_memmap(arr)
+        if m is None or not arr.flags.c_contiguous or m.filename is None :
+            return
+        try :
+            base = numpy.frombuffer(m._mmap, dtype=numpy.uint8).__array_interface__['data'][0]
+        except (TypeError, ValueError) :
+            return
+        self.m = m
+        self.delta = arr.__array_interface__['data'][0] - base
+        self.file_start = m.offset - m.offset % _PAGE
+        self.row_bytes = arr[0:1].nbytes if arr.shape[0] else 0
+
+    def _range (self, start, stop) :
+        lo = self.delta + start*self.row_bytes
+        hi = self.delta + stop*self.row_bytes
+        lo -= lo % _PAGE
+        return lo, min(hi, len(self.m._mmap)) - lo
+
+    def willneed (self, start, stop) :
+        if self.m is None or not hasattr(mmap, 'MADV_WILLNEED') :
+            return
+        off, size = self._range(start, stop)
+        if size > 0 :
+            self.m._mmap.madvise(mmap.MADV_WILLNEED, off, size)
+
+    def release (self, start, stop, dirty) :
+        """Write back (if dirty) and evict rows [start, stop) from the page cache."""
+        if self.m is None :
+            return
+        off, size = self._range(start, stop)
+        if size <= 0 :
+            return
+        if dirty :
+            self.m._mmap.flush(off, size)
+        if hasattr(mmap, 'MADV_DONTNEED') :
+            self.m._mmap.madvise(mmap.MADV_DONTNEED, off, size)
+        if hasattr(os, 'posix_fadvise') :
+            try :
+                fd = os.open(self.m.filename, os.O_RDONLY)
+            except OSError :
+                return
+            try :
+                os.posix_fadvise(fd, self.file_start + off, size, os.POSIX_FADV_DONTNEED)
+            finally :
+                os.close(fd)
+
+
+def _evaluate (func, args, out=None) :
+    if isinstance(func, numpy.ufunc) :
+        if out is not None and func.nout == 1 :
+            return func(*args, out=out)
+        res = func(*args)
+    elif isinstance(func, (list, tuple)) :
+        res = func[0](*args)
+        for f in func[1:] :
+            res = f(res)
+    else :
+        res = func(*args)
+    if out is not None :
+        out[...] = res
+    return res
+
+def _allocate_out (out, shape, dtype) :
+    if out is None :
+        return numpy.empty(shape, dtype)
+    if isinstance(out, (str, os.PathLike)) :
+        if dtype == numpy.interval :
+            from . import open_memmap
+            return open_memmap(out, 'w+', shape=shape)
+        return numpy.lib.format.open_memmap(out, 'w+', dtype=dtype, shape=shape)
+    return out
+
+
+def stream (func, *inputs, out=None, block_bytes=1<<26, cache_bytes=1<<18, num_threads=None,
+            drop_cache=True) :
+    """Evaluate ``func(*inputs)`` block by block along the first axis.
+
+    Parameters
+    ----------
+    func : ufunc, callable, or sequence of callables
+        A ufunc is called with ``out=`` pointing straight into the output.
+        A sequence ``[f, g, h]`` is evaluated as ``h(g(f(*inputs)))``.
+        Any other callable must map blocks of the inputs to a block of the
+        result.
+    inputs : array_like
+        Arrays whose first axis has the common length n are split into
+        blocks; anything else (scalars, small operands) is passed whole
+        and must broadcast against the blocks.
+    out : ndarray, path, or None
+        Destination of length n along the first axis.  A path creates a
+        .npy memory map (interval results go through `open_memmap`); None
+        allocates an array in memory.
+    block_bytes : int
+        Input bytes staged per block (the read-ahead granularity).
+    cache_bytes : int
+        Input bytes per task handed to a worker thread.
+    num_threads : int
+        Worker threads; defaults to os.cpu_count().
+    drop_cache : bool
+        Write back and evict finished blocks of memory-mapped inputs and
+        outputs from the page cache.
+
+    Returns
+    -------
+    out : ndarray
+    """
+    inputs = [numpy.asanyarray(x) for x in inputs]
+    lengths = {x.shape[0] for x in inputs if x.ndim > 0}
+    if not lengths :
+        raise ValueError("stream needs at least one input with a leading axis")
+    n = max(lengths)
+    chunked = [x.ndim > 0 and x.shape[0] == n for x in inputs]
+
+    row_bytes = max(1, sum(x[0:1].nbytes for x, c in zip(inputs, chunked) if c))
+    block_rows = max(1, block_bytes // row_bytes)
+    task_rows = max(1, min(block_rows, cache_bytes // row_bytes))
+    num_threads = num_threads or os.cpu_count() or 1
+
+    def rows (args, start, stop) :
+        return [x[start:stop] if c else x for x, c in zip(args, chunked)]
+
+    if not isinstance(out, numpy.ndarray) :
+        probe = numpy.asanyarray(_evaluate(func, rows(inputs, 0, min(n, 1))))
+        out = _allocate_out(out, (n,) + probe.shape[1:], probe.dtype)
+    if n == 0 :
+        return out
+    if out.shape[0] != n :
+        raise ValueError("out has length %d along the first axis, expected %d" % (out.shape[0], n))
+
+    mapped_in = [_Mapped(x) if c else None for x, c in zip(inputs, chunked)]
+    staged = [m is not None and m.m is not None for m in mapped_in]
+    mapped_out = _Mapped(out) if drop_cache else None
+
+    # Two staging buffers per memory-mapped input: one being read into,
+    # one being computed on.
+    buffers = [[numpy.empty((min(block_rows, n),) + x.shape[1:], x.dtype) if s else None
+                for x, s in zip(inputs, staged)] for _ in range(2)]
+
+    def read (k, start, stop) :
+        args = []
+        for x, s, buf in zip(inputs, staged, buffers[k % 2]) :
+            if s :
+                numpy.copyto(buf[:stop-start], x[start:stop])
+                args.append(buf[:stop-start])
+            else :
+                args.append(x)
+        return args
+
+    def task (args, start, stop, ostart) :
+        _evaluate(func, rows(args, start, stop), out[ostart+start:ostart+stop])
+
+    starts = list(range(0, n, block_rows))
+    with ThreadPoolExecutor(1) as reader, ThreadPoolExecutor(num_threads) as workers :
+        pending = reader.submit(read, 0, 0, min(n, block_rows))
+        for k, start in enumerate(starts) :
+            stop = min(n, start + block_rows)
+            args = pending.result()
+            if k + 1 < len(starts) :
+                nstart, nstop = stop, min(n, stop + block_rows)
+                for m in mapped_in :
+                    if m is not None :
+                        m.willneed(nstart, nstop)
+                pending = reader.submit(read, k + 1, nstart, nstop)
+            # Staged inputs are indexed relative to the block, the rest
+            # (in-memory arrays) absolutely.
+            block = [a if s else (x[start:stop] if c else x)
+                     for a, x, s, c in zip(args, inputs, staged, chunked)]
+            futures = [workers.submit(task, block, s, min(stop - start, s + task_rows), start)
+                       for s in range(0, stop - start, task_rows)]
+            for f in futures :
+                f.result()
+            if drop_cache :
+                for m in mapped_in :
+                    if m is not None :
+                        m.release(start, stop, False)
+                mapped_out.release(start, stop, True)
+    return out
@@ -0,0 +1,203 @@
+"""Tensor contractions of interval arrays.
+
+numpy.einsum has no loops for the interval dtype, and emulating a
+contraction with broadcasting, multiply and add materializes the full
+outer product of the operands.  `einsum` here plans the contraction
+instead: operands are contracted two at a time, smallest result first,
+and every pairwise contraction is rewritten as a stack of matrix
+products
+
+    A (batch, m, k) @ B (batch, k, n)
+
+by transposing each operand so that its labels shared with the other one
+and kept (batch), its own kept labels (m or n), and the labels summed
+over (k) are grouped.  The stack runs natively through the interval
+matmul kernel, split across threads by the rows of the whole stack.
+Only the operands and the partial results are ever copied.
+Labels that a single operand alone carries and no result needs are
+summed out of it first, and repeated labels within an operand take its
+diagonal.
+
+    Q = einsum('ijk,j,k->i', T, x, x)       # quadratic forms
+    y = einsum('bij,bj->bi', A, x)          # batched matvec
+    C = tensordot(A, B, axes=([1, 2], [0, 1]))
+"""
+
+import numpy
+
+from npinterval.interval.numpy_interval import interval, matmul_stack
+
+__all__ = ['einsum', 'tensordot']
+
+_letters = 'abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ'
+
+
+def _asinterval (a) :
+    a = numpy.asarray(a)
+    if a.dtype != interval :
+        a = a.astype(numpy.float64).astype(interval)
+    return a
+
+def _parse (subscripts, operands) :
+    """Input label strings (ellipses expanded) and the output labels."""
+    subscripts = subscripts.replace(' ', '')
+    if '->' in subscripts :
+        inputs, output = subscripts.split('->')
+    else :
+        inputs, output = subscripts, None
+    inputs = inputs.split(',')
+    if len(inputs) != len(operands) :
+        raise ValueError("einsum: %d operands for %d subscripts" % (len(operands), len(inputs)))
+    used = set(''.join(inputs) + (output or ''))
+    for c in used - set('.') :
+        if c not in _letters :
+            raise ValueError("einsum: invalid subscript %r" % c)
+    # An ellipsis stands for the leading dimensions not named by letters,
+    # right-aligned across operands as in broadcasting.
+    free = [c for c in _letters if c not in used]
+    nell = 0
+    for s, a in zip(inputs, operands) :
+        if '...' in s :
+            nell = max(nell, a.ndim - len(s.replace('...', '')))
+    if nell > len(free) :
+        raise ValueError("einsum: too many dimensions under the ellipsis")
+    ell = ''.join(free[:nell])
+    labels = []
+    for s, a in zip(inputs, operands) :
+        if '...' in s :
+            k = a.ndim - len(s.replace('...', ''))
+            if k < 0 :
+                raise ValueError("einsum: subscripts %r have more labels than dimensions" % s)
+            s = s.replace('...', ell[nell-k:])
+        if '.' in s or len(s) != a.ndim :
+            raise ValueError("einsum: subscripts %r do not match an operand of %d dimensions"
+                             % (s, a.ndim))
+        labels.append(s)
+    if output is None :
+        counts = {}
+        for s in labels :
+            for c in s :
+                counts[c] = counts.get(c, 0) + 1
+        output = ell + ''.join(sorted((c for c in counts if counts[c] == 1 and c not in ell),
+                                      key=_letters.index))
+    else :
+        output = output.replace('...', ell)
+        if '.' in output or len(set(output)) != len(output) :
+            raise ValueError("einsum: invalid output subscripts %r" % output)
+        for c in output :
+            if not any(c in s for s in labels) :
+                raise ValueError("einsum: output label %r is not in any input" % c)
+    return labels, output
+
+def _diagonal (a, s) :
+    """Take the diagonal over repeated labels of s; (array, unique labels)."""
+    while len(set(s)) != len(s) :
+        c = next(c for c in s if s.count(c) > 1)
+        i = s.index(c)
+        j = s.index(c, i + 1)
+        a = numpy.diagonal(a, axis1=i, axis2=j)
+        s = s[:i] + s[i+1:j] + s[j+1:] + c
+    return a, s
+
+def _sum_out (a, s, keep) :
+    """Sum a over the labels of s not in keep."""
+    axes = tuple(i for i, c in enumerate(s) if c not in keep)
+    if axes :
+        # keepdims keeps a full reduction an array, not an interval scalar.
+        a = numpy.add.reduce(a, axis=axes, keepdims=True)
+        a = a.reshape(tuple(d for c, d in zip(s, a.shape) if c in keep))
+        s = ''.join(c for c in s if c in keep)
+    return a, s
+
+def _contract (a, sa, b, sb, keep) :
+    """Contract two operands over their shared labels not in keep."""
+    a, sa = _sum_out(a, sa, keep + sb)
+    b, sb = _sum_out(b, sb, keep + sa)
+    batch = [c for c in sa if c in sb and c in keep]
+    inner = [c for c in sa if c in sb and c not in keep]
+    left = [c for c in sa if c not in sb]
+    right = [c for c in sb if c not in sa]
+    size = {}
+    for s, arr in ((sa, a), (sb, b)) :
+        for c, d in zip(s, arr.shape) :
+            if c in size and size[c] != d and 1 not in (size[c], d) :
+                raise ValueError("einsum: label %r has sizes %d and %d" % (c, size[c], d))
+            if c not in size or size[c] == 1 :
+                size[c] = d
+    def arrange (x, sx, order) :
+        x = numpy.transpose(x, [sx.index(c) for c in order])
+        return numpy.broadcast_to(x, tuple(size[c] for c in order))
+    prod = lambda labels : int(numpy.prod([size[c] for c in labels]))
+    A = arrange(a, sa, batch + left + inner).reshape(prod(batch), prod(left), prod(inner))
+    B = arrange(b, sb, batch + inner + right).reshape(prod(batch), prod(inner), prod(right))
+    C = matmul_stack(numpy.ascontiguousarray(A), numpy.ascontiguousarray(B))
+    labels = batch + left + right
+    return C.reshape(tuple(size[c] for c in labels)), ''.join(labels)
+
+def einsum (subscripts, *operands) :
+    """Evaluate an Einstein summation over interval (or float) operands.
+
+    Takes the subscripts of numpy.einsum, including ellipses and the
+    implicit output of subscripts without '->'.  Float operands are
+    taken as degenerate intervals.
+
+    Returns
+    -------
+    out : ndarray of interval
+    """
+    if not operands :
+        raise ValueError("einsum: expected at least one operand")
+    operands = [_asinterval(a) for a in operands]
+    labels, output = _parse(subscripts, operands)
+    terms = [_diagonal(a, s) for a, s in zip(operands, labels)]
+
+    while len(terms) > 1 :
+        # Contract the pair with the smallest result.
+        best = None
+        for i in range(len(terms)) :
+            for j in range(i + 1, len(terms)) :
+                keep = output + ''.join(s for k, (_, s) in enumerate(terms) if k != i and k != j)
+                sa, sb = terms[i][1], terms[j][1]
+                shape = dict(zip(sa, terms[i][0].shape))
+                for c, d in zip(sb, terms[j][0].shape) :
+                    shape[c] = max(shape.get(c, 1), d)
+                cost = numpy.prod([shape[c] for c in set(sa + sb) if c in keep], dtype=float)
+                if best is None or cost < best[0] :
+                    best = (cost, i, j, keep)
+        _, i, j, keep = best
+        (a, sa), (b, sb) = terms[i], terms[j]
+        terms = [t for k, t in enumerate(terms) if k != i and k != j]
+        terms.append(_contract(a, sa, b, sb, keep))
+
+    a, s = _sum_out(*terms[0], output)
+    a = numpy.transpose(a, [s.index(c) for c in output])
+    return a if a.flags.c_contiguous else a.copy()
+
+def tensordot (a, b, axes=2) :
+    """numpy.tensordot for interval (or float) operands, through einsum."""
+    a = _asinterval(a)
+    b = _asinterval(b)
+    try :
+        axes_a, axes_b = axes
+    except TypeError :
+        axes = int(axes)
+        axes_a, axes_b = list(range(a.ndim - axes, a.ndim)), list(range(axes))
+    axes_a = [axes_a] if numpy.ndim(axes_a) == 0 else list(axes_a)
+    axes_b = [axes_b] if numpy.ndim(axes_b) == 0 else list(axes_b)
+    if len(axes_a) != len(axes_b) :
+        raise ValueError("tensordot: axes lists must have the same length")
+    axes_a = [k % a.ndim for k in axes_a] if a.ndim else axes_a
+    axes_b = [k % b.ndim for k in axes_b] if b.ndim else axes_b
+    for ka, kb in zip(axes_a, axes_b) :
+        if a.shape[ka] != b.shape[kb] :
+            raise ValueError("tensordot: shape mismatch for sum")
+    if a.ndim + b.ndim > len(_letters) :
+        raise ValueError("tensordot: too many dimensions")
+    la = _letters[:a.ndim]
+    lb = list(_letters[a.ndim:a.ndim + b.ndim])
+    for ka, kb in zip(axes_a, axes_b) :
+        lb[kb] = la[ka]
+    lb = ''.join(lb)
+    out = ''.join(c for k, c in enumerate(la) if k not in axes_a) \
+        + ''.join(c for k, c in enumerate(lb) if k not in axes_b)
+    return einsum('%s,%s->%s' % (la, lb, out), a, b)
@@ -1,6 +1,13 @@
 from setuptools import setup, Extension
 import numpy as np
 
+# Against NumPy 2 the loops are built as ArrayMethods (numpy_interval.c),
+# which needs the NumPy 2.0 C API at runtime.
+if int(np.__version__.split('.')[0]) >= 2 :
+    define_macros = [('NPY_TARGET_VERSION', 'NPY_2_0_API_VERSION')]
+else :
+    define_macros = []
+
 if __name__ == '__main__' :
     setup(
         ext_modules=[
@@ -8,17 +15,53 @@ if __name__ == '__main__' :
                 name='npinterval.interval.numpy_interval',
                 sources=[
                     'interval/interval.c',
+                    'interval/interval_sort.c',
+                    'interval/interval_parallel.c',
+                    'interval/interval_sparse.c',
+                    'interval/interval_linsolve.c',
+                    'interval/interval_newton.c',
+                    'interval/interval_bvh.c',
+                    'interval/interval_paving.c',
+                    'interval/interval_optimize.c',
+                    'interval/interval_contract.c',
+                    'interval/interval_nn.c',
+                    'interval/interval_small.c',
                     'interval/numpy_interval.c'
                 ],
                 depends=[
                     "interval/interval.h",
+                    "interval/midrad.h",
+                    "interval/interval_sort.h",
+                    "interval/interval_parallel.h",
+                    "interval/interval_sparse.h",
+                    "interval/interval_linsolve.h",
+                    "interval/interval_newton.h",
+                    "interval/interval_bvh.h",
+                    "interval/interval_paving.h",
+                    "interval/interval_optimize.h",
+                    "interval/interval_contract.h",
+                    "interval/interval_nn.h",
+                    "interval/interval_small.h",
+                    "interval/numpy_interval_api.h",
                     'interval/interval.c',
+                    'interval/interval_sort.c',
+                    'interval/interval_parallel.c',
+                    'interval/interval_sparse.c',
+                    'interval/interval_linsolve.c',
+                    'interval/interval_newton.c',
+                    'interval/interval_bvh.c',
+                    'interval/interval_paving.c',
+                    'interval/interval_optimize.c',
+                    'interval/interval_contract.c',
+                    'interval/interval_nn.c',
+                    'interval/interval_small.c',
                     'interval/numpy_interval.c'
                 ],
                 include_dirs=[
                     np.get_include(),
                     "interval"
-                ]
+                ],
+                define_macros=define_macros
             )
         ]
     )